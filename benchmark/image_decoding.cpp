@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <print>
+#include <span>
+#include <vector>
+
+#include <core/asset/image/JpegImage.hpp>
+#include <core/asset/image/PngImage.hpp>
+#include <core/asset/image/StbImage.hpp>
+
+using namespace core::asset;
+
+using Duration = std::chrono::duration<double, std::milli>;
+
+constexpr static int g_run_count{ 10 };
+
+[[nodiscard]]
+static auto read_file(const std::filesystem::path& t_filepath)
+    -> std::optional<std::vector<std::uint8_t>>
+{
+    std::ifstream file{ t_filepath, std::ios::binary | std::ios::in | std::ios::ate };
+
+    const std::streamsize file_size = file.tellg();
+    if (file_size == -1) {
+        return std::nullopt;
+    }
+
+    std::vector<std::uint8_t> buffer(static_cast<size_t>(file_size));
+
+    file.seekg(0, std::ios::beg);
+    file.read(reinterpret_cast<char*>(buffer.data()), file_size);
+
+    return buffer;
+}
+
+// The median of g_run_count runs, after a first one that warms up the caches
+[[nodiscard]]
+static auto measure(const std::function<bool()>& t_load) -> std::optional<Duration>
+{
+    if (!t_load()) {
+        return std::nullopt;
+    }
+
+    std::vector<Duration> durations;
+    durations.reserve(g_run_count);
+    for (int run{}; run < g_run_count; run++) {
+        const auto start{ std::chrono::steady_clock::now() };
+        if (!t_load()) {
+            return std::nullopt;
+        }
+        durations.emplace_back(std::chrono::steady_clock::now() - start);
+    }
+
+    std::ranges::nth_element(durations, durations.begin() + g_run_count / 2);
+    return durations[g_run_count / 2];
+}
+
+// Loads the image and decodes all of its pixels, like an upload does
+template <typename ImageType>
+[[nodiscard]]
+static auto load_and_decode(const std::span<const std::uint8_t> t_data) -> bool
+{
+    const std::optional<ImageType> image{ ImageType::load_from_memory(t_data) };
+    if (!image.has_value()) {
+        return false;
+    }
+
+    std::vector<std::byte> pixels(image->size());
+    image->decode_to(pixels);
+    return true;
+}
+
+[[nodiscard]]
+static auto load_with_stb(const std::span<const std::uint8_t> t_data) -> bool
+{
+    return StbImage::load_from_memory(t_data, StbImage::Channels::eRGBA).has_value();
+}
+
+[[nodiscard]]
+static auto load_with_decoder(const std::span<const std::uint8_t> t_data) -> bool
+{
+    constexpr static std::array<std::uint8_t, 3> jpeg_signature{ 0xFF, 0xD8, 0xFF };
+
+    if (t_data.size() >= jpeg_signature.size()
+        && std::ranges::equal(t_data.first(jpeg_signature.size()), jpeg_signature))
+    {
+        return load_and_decode<JpegImage>(t_data);
+    }
+    return load_and_decode<PngImage>(t_data);
+}
+
+static auto benchmark(const std::filesystem::path& t_filepath) -> void
+{
+    const std::optional<std::vector<std::uint8_t>> data{ read_file(t_filepath) };
+    if (!data.has_value()) {
+        std::println("{:<48} could not be read", t_filepath.filename().generic_string());
+        return;
+    }
+
+    const std::optional<Duration> stb_duration{ measure([&data] {
+        return load_with_stb(*data);
+    }) };
+    const std::optional<Duration> decoder_duration{ measure([&data] {
+        return load_with_decoder(*data);
+    }) };
+    if (!stb_duration.has_value() || !decoder_duration.has_value()) {
+        std::println("{:<48} could not be decoded", t_filepath.filename().generic_string());
+        return;
+    }
+
+    std::println(
+        "{:<48} {:>10.2f} {:>10.2f} {:>10.2f} {:>7.2f}x",
+        t_filepath.filename().generic_string(),
+        static_cast<double>(data->size()) / 1'024.0,
+        stb_duration->count(),
+        decoder_duration->count(),
+        stb_duration->count() / decoder_duration->count()
+    );
+}
+
+// Times stb_image against libspng and TurboJPEG on the PNG and JPEG files passed,
+// or on the sample assets of the repository without arguments
+auto main(const int argc, const char* const argv[]) -> int
+try {
+    std::vector<std::filesystem::path> filepaths{ argv + 1, argv + argc };
+    if (filepaths.empty()) {
+        const std::filesystem::path source_directory{ SOURCE_DIRECTORY };
+        filepaths = {
+            source_directory / "example/res/heightmap.png",
+            source_directory / "docs/screenshots/DamagedHelmet-pbr.png",
+            source_directory / "docs/screenshots/Sponza-pbr.png",
+        };
+    }
+
+    std::println(
+        "{:<48} {:>10} {:>10} {:>10} {:>8}", "file", "KiB", "stb ms", "new ms", "speedup"
+    );
+    for (const std::filesystem::path& filepath : filepaths) {
+        benchmark(filepath);
+    }
+} catch (std::exception& error) {
+    try {
+        std::println("{}", error.what());
+    } catch (...) {
+        return -1;
+    }
+} catch (...) {
+    return -2;
+}
@@ -94,10 +94,32 @@ set(KTX_FEATURE_STATIC_LIBRARY ON)
 find_package(Ktx CONFIG REQUIRED)
 target_link_libraries(${PROJECT_NAME} PUBLIC KTX::ktx)
 
+# zstd
+find_package(zstd CONFIG REQUIRED)
+target_link_libraries(${PROJECT_NAME} PUBLIC
+        $<IF:$<TARGET_EXISTS:zstd::libzstd_shared>,zstd::libzstd_shared,zstd::libzstd_static>
+)
+
+# xxHash
+find_package(xxHash CONFIG REQUIRED)
+target_link_libraries(${PROJECT_NAME} PUBLIC xxHash::xxhash)
+
 # stb
 find_package(Stb REQUIRED)
 target_include_directories(${PROJECT_NAME} PUBLIC ${Stb_INCLUDE_DIR})
 
+# libjpeg-turbo
+find_package(libjpeg-turbo CONFIG REQUIRED)
+target_link_libraries(${PROJECT_NAME} PUBLIC
+        $<IF:$<TARGET_EXISTS:libjpeg-turbo::turbojpeg>,libjpeg-turbo::turbojpeg,libjpeg-turbo::turbojpeg-static>
+)
+
+# spng
+find_package(SPNG CONFIG REQUIRED)
+target_link_libraries(${PROJECT_NAME} PUBLIC
+        $<IF:$<TARGET_EXISTS:spng::spng>,spng::spng,spng::spng_static>
+)
+
 # fastgltf
 find_package(fastgltf CONFIG REQUIRED)
 target_link_libraries(${PROJECT_NAME} PUBLIC fastgltf::fastgltf)
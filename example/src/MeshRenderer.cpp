@@ -3,6 +3,8 @@
 #include <spdlog/spdlog.h>
 
 #include <core/renderer/base/descriptor_pool/Builder.hpp>
+#include <core/renderer/base/pipeline_cache/PipelineCache.hpp>
+#include <core/renderer/render_graph/Builder.hpp>
 #include <core/window/Window.hpp>
 
 #include "demo_init.hpp"
@@ -10,7 +12,7 @@
 
 using namespace core;
 
-constexpr static uint32_t g_frame_count{ 1 };
+constexpr static uint32_t g_frame_count{ 2 };
 
 struct ShaderCamera {
     glm::vec4 position;
@@ -19,15 +21,24 @@ struct ShaderCamera {
 };
 
 [[nodiscard]]
-static auto
-    load_terrain(const renderer::Device& t_device, const renderer::Allocator& t_allocator)
-        -> Terrain
+static auto load_terrain(
+    const renderer::Device&      t_device,
+    const renderer::Allocator&   t_allocator,
+    renderer::TransferScheduler& t_transfer_scheduler
+) -> Terrain
 {
-    auto                                transfer_command_pool{ init::create_command_pool(
+    std::future<Terrain> terrain{ t_transfer_scheduler.schedule(Terrain::create_loader(
+        t_device.get(), t_allocator, t_transfer_scheduler.staging_ring()
+    )) };
+    t_transfer_scheduler.submit();
+    t_transfer_scheduler.wait_idle();
+
+    // The terrain is needed right away, so it is acquired in a one-time submission
+    auto                                command_pool{ init::create_command_pool(
         t_device.get(), t_device.info().get_queue_index(vkb::QueueType::graphics).value()
     ) };
     const vk::CommandBufferAllocateInfo command_buffer_allocate_info{
-        .commandPool        = transfer_command_pool.get(),
+        .commandPool        = command_pool.get(),
         .level              = vk::CommandBufferLevel::ePrimary,
         .commandBufferCount = 1
     };
@@ -35,11 +46,9 @@ static auto
         t_device->allocateCommandBuffers(command_buffer_allocate_info).front()
     };
 
-    auto packaged_terrain{ Terrain::create_loader(t_device.get(), t_allocator) };
-
     constexpr vk::CommandBufferBeginInfo begin_info{};
     command_buffer.begin(begin_info);
-    std::invoke(packaged_terrain, command_buffer);
+    t_transfer_scheduler.acquire(command_buffer);
     command_buffer.end();
 
     const vk::SubmitInfo submit_info{
@@ -56,20 +65,9 @@ static auto
     static_cast<void>(
         t_device->waitForFences(std::array{ fence.get() }, vk::True, 100'000'000'000)
     );
-    t_device->resetCommandPool(transfer_command_pool.get());
+    t_device->resetCommandPool(command_pool.get());
 
-    return packaged_terrain.get_future().get();
-}
-
-[[nodiscard]]
-static auto create_camera_buffer(const core::renderer::Allocator& t_allocator
-) -> core::renderer::MappedBuffer
-{
-    constexpr vk::BufferCreateInfo buffer_create_info = {
-        .size = sizeof(ShaderCamera), .usage = vk::BufferUsageFlagBits::eUniformBuffer
-    };
-
-    return t_allocator.allocate_mapped_buffer(buffer_create_info);
+    return terrain.get();
 }
 
 [[nodiscard]]
@@ -79,25 +77,28 @@ static auto create_descriptor_set_layout(const vk::Device t_device
     constexpr static std::array bindings{
         // Camera
         vk::DescriptorSetLayoutBinding{
-                                       .binding         = 0,
-                                       .descriptorType  = vk::DescriptorType::eUniformBuffer,
-                                       .descriptorCount = 1,
-                                       .stageFlags      = vk::ShaderStageFlagBits::eTaskEXT
-                                       | vk::ShaderStageFlagBits::eMeshEXT },
+            .binding         = 0,
+            .descriptorType  = vk::DescriptorType::eUniformBufferDynamic,
+            .descriptorCount = 1,
+            .stageFlags      = vk::ShaderStageFlagBits::eTaskEXT
+                        | vk::ShaderStageFlagBits::eMeshEXT,
+        },
         // Vertex buffer
         vk::DescriptorSetLayoutBinding{
-                                       .binding         = 1,
-                                       .descriptorType  = vk::DescriptorType::eUniformBuffer,
-                                       .descriptorCount = 1,
-                                       .stageFlags      = vk::ShaderStageFlagBits::eTaskEXT
-                                       | vk::ShaderStageFlagBits::eMeshEXT },
+            .binding         = 1,
+            .descriptorType  = vk::DescriptorType::eUniformBuffer,
+            .descriptorCount = 1,
+            .stageFlags      = vk::ShaderStageFlagBits::eTaskEXT
+                        | vk::ShaderStageFlagBits::eMeshEXT,
+        },
         // Heightmap
         vk::DescriptorSetLayoutBinding{
-                                       .binding         = 2,
-                                       .descriptorType  = vk::DescriptorType::eSampledImage,
-                                       .descriptorCount = 1,
-                                       .stageFlags      = vk::ShaderStageFlagBits::eMeshEXT
-                                       | vk::ShaderStageFlagBits::eFragment },
+            .binding         = 2,
+            .descriptorType  = vk::DescriptorType::eSampledImage,
+            .descriptorCount = 1,
+            .stageFlags      = vk::ShaderStageFlagBits::eMeshEXT
+                        | vk::ShaderStageFlagBits::eFragment,
+        },
     };
 
     constexpr static vk::DescriptorSetLayoutCreateInfo create_info{
@@ -113,7 +114,7 @@ static auto create_descriptor_set(
     const vk::Device              t_device,
     const vk::DescriptorSetLayout t_descriptor_set_layout,
     const vk::DescriptorPool      t_descriptor_pool,
-    const vk::Buffer              t_camera_uniform,
+    const renderer::UniformRing&  t_camera_uniform,
     const vk::Buffer              t_vertex_uniform,
     const vk::ImageView           t_heightmap_image_view,
     const vk::Sampler             t_heightmap_sampler
@@ -129,8 +130,8 @@ static auto create_descriptor_set(
     };
 
     const vk::DescriptorBufferInfo camera_buffer_info{
-        .buffer = t_camera_uniform,
-        .range  = sizeof(ShaderCamera),
+        .buffer = t_camera_uniform.get(),
+        .range  = t_camera_uniform.slice_size(),
     };
     const vk::DescriptorBufferInfo vertex_buffer_info{
         .buffer = t_vertex_uniform,
@@ -144,26 +145,26 @@ static auto create_descriptor_set(
 
     std::array write_descriptor_sets{
         vk::WriteDescriptorSet{
-                               .dstSet          = descriptor_sets.front().get(),
-                               .dstBinding      = 0,
-                               .descriptorCount = 1,
-                               .descriptorType  = vk::DescriptorType::eUniformBuffer,
-                               .pBufferInfo     = &camera_buffer_info,
-                               },
+            .dstSet          = descriptor_sets.front().get(),
+            .dstBinding      = 0,
+            .descriptorCount = 1,
+            .descriptorType  = vk::DescriptorType::eUniformBufferDynamic,
+            .pBufferInfo     = &camera_buffer_info,
+        },
         vk::WriteDescriptorSet{
-                               .dstSet          = descriptor_sets.front().get(),
-                               .dstBinding      = 1,
-                               .descriptorCount = 1,
-                               .descriptorType  = vk::DescriptorType::eUniformBuffer,
-                               .pBufferInfo     = &vertex_buffer_info,
-                               },
+            .dstSet          = descriptor_sets.front().get(),
+            .dstBinding      = 1,
+            .descriptorCount = 1,
+            .descriptorType  = vk::DescriptorType::eUniformBuffer,
+            .pBufferInfo     = &vertex_buffer_info,
+        },
         vk::WriteDescriptorSet{
-                               .dstSet          = descriptor_sets.front().get(),
-                               .dstBinding      = 2,
-                               .descriptorCount = 1,
-                               .descriptorType  = vk::DescriptorType::eSampledImage,
-                               .pImageInfo      = &heightmap_image_info,
-                               },
+            .dstSet          = descriptor_sets.front().get(),
+            .dstBinding      = 2,
+            .descriptorCount = 1,
+            .descriptorType  = vk::DescriptorType::eSampledImage,
+            .pImageInfo      = &heightmap_image_info,
+        },
     };
 
     t_device.updateDescriptorSets(
@@ -193,6 +194,7 @@ static auto create_pipeline_layout(
 [[nodiscard]]
 static auto create_pipeline(
     const vk::Device         t_device,
+    const vk::PipelineCache  t_pipeline_cache,
     const vk::PipelineLayout t_layout,
     const vk::RenderPass     t_render_pass
 ) -> vk::UniquePipeline
@@ -283,7 +285,7 @@ static auto create_pipeline(
         .renderPass          = t_render_pass,
     };
 
-    return t_device.createGraphicsPipelineUnique(nullptr, create_info).value;
+    return t_device.createGraphicsPipelineUnique(t_pipeline_cache, create_info).value;
 }
 
 auto MeshRenderer::create_dependency_provider()
@@ -297,6 +299,7 @@ auto MeshRenderer::create(Store& t_store) -> std::optional<MeshRenderer>
     const auto& window{ t_store.at<window::Window>() };
     auto&       device{ t_store.at<renderer::Device>() };
     auto&       allocator{ t_store.at<renderer::Allocator>() };
+    const auto& pipeline_cache{ t_store.at<renderer::PipelineCache>() };
 
     auto& swapchain{ t_store.at<renderer::Swapchain>() };
     int   width{};
@@ -314,63 +317,19 @@ auto MeshRenderer::create(Store& t_store) -> std::optional<MeshRenderer>
         return std::nullopt;
     }
 
-    auto depth_image{ init::create_depth_image(
-        device.physical_device(), allocator, raw_swapchain.extent()
-    ) };
-    if (!depth_image.get()) {
-        return std::nullopt;
-    }
-
-    auto depth_image_view{ init::create_depth_image_view(device, depth_image.get()) };
-    if (!depth_image_view) {
-        return std::nullopt;
-    }
-
-    auto framebuffers{ init::create_framebuffers(
+    renderer::FrameRing frames{
         device.get(),
-        raw_swapchain.extent(),
-        raw_swapchain.image_views(),
-        render_pass.get(),
-        depth_image_view.get()
-    ) };
-    if (framebuffers.empty()) {
-        return std::nullopt;
-    }
-
-    auto command_pool{ init::create_command_pool(
-        device.get(), device.info().get_queue_index(vkb::QueueType::graphics).value()
-    ) };
-    if (!command_pool) {
-        return std::nullopt;
-    }
-
-    auto command_buffers{
-        init::create_command_buffers(device.get(), command_pool.get(), g_frame_count)
+        device.info().get_queue_index(vkb::QueueType::graphics).value(),
+        g_frame_count,
     };
-    if (command_buffers.empty()) {
-        return std::nullopt;
-    }
 
-    auto image_acquired_semaphores{ init::create_semaphores(device.get(), g_frame_count) };
-    if (image_acquired_semaphores.empty()) {
-        return std::nullopt;
-    }
-
-    auto render_finished_semaphores{
-        init::create_semaphores(device.get(), g_frame_count)
+    renderer::UniformRing camera_uniform{
+        allocator, sizeof(ShaderCamera), g_frame_count
     };
-    if (render_finished_semaphores.empty()) {
-        return std::nullopt;
-    }
-
-    auto in_flight_fences{ init::create_fences(device.get(), g_frame_count) };
-    if (in_flight_fences.empty()) {
-        return std::nullopt;
-    }
 
-    auto camera_uniform{ create_camera_buffer(allocator) };
+    renderer::TransferScheduler transfer_scheduler{ device, allocator };
 
-    auto terrain{ load_terrain(device, allocator) };
+    auto terrain{ load_terrain(device, allocator, transfer_scheduler) };
 
     vk::UniqueDescriptorSetLayout descriptor_set_layout{
         create_descriptor_set_layout(device.get())
@@ -386,7 +345,7 @@ auto MeshRenderer::create(Store& t_store) -> std::optional<MeshRenderer>
             .request_descriptors(std::array{
                                             // Camera
                 vk::DescriptorPoolSize{
-                    .type            = vk::DescriptorType::eUniformBuffer,
+                    .type            = vk::DescriptorType::eUniformBufferDynamic,
                     .descriptorCount = 1,
                 },   // Vertices
                 vk::DescriptorPoolSize{
@@ -401,9 +360,9 @@ auto MeshRenderer::create(Store& t_store) -> std::optional<MeshRenderer>
             .build(device.get())
     };
 
-    auto pipeline{
-        create_pipeline(device.get(), pipeline_layout.get(), render_pass.get())
-    };
+    auto pipeline{ create_pipeline(
+        device.get(), pipeline_cache.get(), pipeline_layout.get(), render_pass.get()
+    ) };
     if (!pipeline) {
         return std::nullopt;
     }
@@ -412,25 +371,23 @@ auto MeshRenderer::create(Store& t_store) -> std::optional<MeshRenderer>
         device.get(),
         descriptor_set_layout.get(),
         descriptor_pool.get(),
-        camera_uniform.get(),
+        camera_uniform,
         terrain.vertex_uniform().get(),
         terrain.heightmap_image_view().get(),
         terrain.heightmap_sampler().get()
     ) };
 
+    renderer::TransientAttachmentPool transient_attachments{ device.get(), allocator };
+
     return MeshRenderer{
         .device                     = device,
         .allocator                  = allocator,
         .swapchain                  = swapchain,
         .render_pass                = std::move(render_pass),
-        .depth_image                = std::move(depth_image),
-        .depth_image_view           = std::move(depth_image_view),
-        .framebuffers               = std::move(framebuffers),
-        .command_pool               = std::move(command_pool),
-        .command_buffers            = std::move(command_buffers),
-        .image_acquired_semaphores  = std::move(image_acquired_semaphores),
-        .render_finished_semaphores = std::move(render_finished_semaphores),
-        .in_flight_fences           = std::move(in_flight_fences),
+        .transient_attachments      = std::move(transient_attachments),
+        .frames                     = std::move(frames),
+        .transfer_scheduler         = std::move(transfer_scheduler),
+        .memory_monitor             = renderer::MemoryMonitor{ allocator },
         .camera_uniform             = std::move(camera_uniform),
         .terrain                    = std::move(terrain),
         .descriptor_set_layout      = std::move(descriptor_set_layout),
@@ -448,59 +405,134 @@ auto MeshRenderer::render(
 {
     swapchain.get().set_framebuffer_size(t_framebuffer_size);
 
-    while (device.get()->waitForFences(
-               { in_flight_fences[frame_index].get() }, vk::True, UINT64_MAX
-           )
-           == vk::Result::eTimeout)
-    {}
+    memory_monitor.update();
+    frames.wait_for_current();
+    const renderer::FrameRing::Frame& frame{ frames.current() };
 
     if (auto&& [image_index, raw_swapchain]{ std::make_tuple(
             swapchain.get().acquire_next_image(
-                image_acquired_semaphores[frame_index].get(), {}
+                frame.image_acquired_semaphore.get(), {}
             ),
             std::cref(swapchain.get())
         ) };
         image_index.has_value() && raw_swapchain.get().has_value())
     {
-        device.get()->resetFences({ in_flight_fences[frame_index].get() });
-        command_buffers[frame_index].reset();
-
-        record_command_buffer(raw_swapchain.get().value(), image_index.value(), t_camera);
+        device.get()->resetFences({ frame.in_flight_fence.get() });
 
-        std::array wait_semaphores{ image_acquired_semaphores[frame_index].get() };
-        std::array<vk::PipelineStageFlags, wait_semaphores.size()> wait_stages{
-            vk::PipelineStageFlagBits::eColorAttachmentOutput
+        const renderer::vulkan::Swapchain& current_swapchain{
+            raw_swapchain.get().value()
         };
-        std::array signal_semaphores{ render_finished_semaphores[frame_index].get() };
-        const vk::SubmitInfo submit_info{
-            .waitSemaphoreCount   = static_cast<uint32_t>(wait_semaphores.size()),
-            .pWaitSemaphores      = wait_semaphores.data(),
-            .pWaitDstStageMask    = wait_stages.data(),
-            .commandBufferCount   = 1,
-            .pCommandBuffers      = &command_buffers[frame_index],
-            .signalSemaphoreCount = static_cast<uint32_t>(signal_semaphores.size()),
-            .pSignalSemaphores    = signal_semaphores.data()
-        };
-        vk::Queue(device.get().info().get_queue(vkb::QueueType::graphics).value())
-            .submit(submit_info, in_flight_fences[frame_index].get());
-
-        swapchain.get().present(signal_semaphores);
+        if (!render_graph.has_value()) {
+            build_render_graph(current_swapchain);
+        }
+        swapchain_image_index = image_index.value();
+        render_graph->set_image(
+            swapchain_image,
+            current_swapchain.images()[swapchain_image_index],
+            current_swapchain.image_views()[swapchain_image_index].get()
+        );
+
+        transfer_scheduler.submit();
+        update_camera(current_swapchain.extent(), t_camera);
+
+        const std::array wait_semaphores{ vk::SemaphoreSubmitInfo{
+            .semaphore = frame.image_acquired_semaphore.get(),
+            .stageMask = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+        } };
+        const std::array signal_semaphores{ vk::SemaphoreSubmitInfo{
+            .semaphore = frame.render_finished_semaphore.get(),
+            .stageMask = vk::PipelineStageFlagBits2::eAllCommands,
+        } };
+        render_graph->submit(renderer::RenderGraph::SubmitInfo{
+            .frame_index       = frames.frame_index(),
+            .wait_semaphores   = wait_semaphores,
+            .signal_semaphores = signal_semaphores,
+            .fence             = frame.in_flight_fence.get(),
+        });
+
+        std::array present_wait_semaphores{ frame.render_finished_semaphore.get() };
+        swapchain.get().present(present_wait_semaphores);
     }
 
-    frame_index = (frame_index + 1) % g_frame_count;
+    frames.advance();
 }
 
-auto MeshRenderer::record_command_buffer(
-    const renderer::vulkan::Swapchain& t_swapchain,
-    const uint32_t                     t_image_index,
-    core::graphics::Camera             t_camera
-) -> void
+auto MeshRenderer::build_render_graph(const renderer::vulkan::Swapchain& t_swapchain)
+    -> void
 {
-    const auto                           command_buffer = command_buffers[frame_index];
-    constexpr vk::CommandBufferBeginInfo command_buffer_begin_info{};
+    using RenderGraph = renderer::RenderGraph;
+
+    RenderGraph::Builder builder{ RenderGraph::create() };
+
+    swapchain_image = builder.import_image(RenderGraph::ImportedImage{
+        .initial_stage_mask = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+        .final_layout       = vk::ImageLayout::ePresentSrcKHR,
+    });
+    depth_image = builder.create_image(
+        init::depth_image_create_info(
+            device.get().physical_device(), t_swapchain.extent()
+        ),
+        vk::ImageAspectFlagBits::eDepth
+    );
 
-    static_cast<void>(command_buffer.begin(command_buffer_begin_info));
+    builder.add_pass(RenderGraph::Pass{
+        .name   = "terrain",
+        .images = {
+            RenderGraph::ImageAccess{
+                .image       = swapchain_image,
+                .stage_mask  = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                .access_mask = vk::AccessFlagBits2::eColorAttachmentWrite,
+                .layout      = vk::ImageLayout::eColorAttachmentOptimal,
+            },
+            RenderGraph::ImageAccess{
+                .image       = depth_image,
+                .stage_mask  = vk::PipelineStageFlagBits2::eEarlyFragmentTests
+                            | vk::PipelineStageFlagBits2::eLateFragmentTests,
+                .access_mask = vk::AccessFlagBits2::eDepthStencilAttachmentRead
+                             | vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+                .layout      = vk::ImageLayout::eDepthStencilAttachmentOptimal,
+            },
+        },
+        .record =
+            [this](const vk::CommandBuffer command_buffer, const RenderGraph&) {
+                record_terrain_pass(command_buffer);
+            },
+    });
 
+    render_graph = builder.build(device, transient_attachments, g_frame_count);
+
+    framebuffers = init::create_framebuffers(
+        device.get().get(),
+        t_swapchain.extent(),
+        t_swapchain.image_views(),
+        render_pass.get(),
+        render_graph->image_view(depth_image)
+    );
+}
+
+auto MeshRenderer::update_camera(
+    const vk::Extent2D     t_extent,
+    core::graphics::Camera t_camera
+) -> void
+{
+    t_camera.set_perspective_projection(
+        90.f,
+        static_cast<float>(t_extent.width) / static_cast<float>(t_extent.height),
+        0.1f,
+        10000.f
+    );
+    camera_uniform.set(
+        frames.frame_index(),
+        ShaderCamera{ .position   = glm::vec4{ t_camera.position(), 1 },
+                      .view       = t_camera.view(),
+                      .projection = t_camera.projection() }
+    );
+    camera_uniform.flush();
+}
+
+auto MeshRenderer::record_terrain_pass(const vk::CommandBuffer t_command_buffer) -> void
+{
+    transfer_scheduler.acquire(t_command_buffer);
 
     const std::array clear_values{
         vk::ClearValue{
@@ -511,46 +543,35 @@ auto MeshRenderer::record_command_buffer(
                        }
     };
 
-    const auto extent{ t_swapchain.extent() };
-    command_buffer.setViewport(
+    const auto extent{ swapchain.get().get()->extent() };
+    t_command_buffer.setViewport(
         0,
         vk::Viewport{ .width    = static_cast<float>(extent.width),
                       .height   = static_cast<float>(extent.height),
                       .maxDepth = 1.f }
     );
-    command_buffer.setScissor(0, vk::Rect2D{ {}, extent });
+    t_command_buffer.setScissor(0, vk::Rect2D{ {}, extent });
 
     const vk::RenderPassBeginInfo render_pass_begin_info{
         .renderPass      = render_pass.get(),
-        .framebuffer     = framebuffers[t_image_index].get(),
-        .renderArea      = { .extent = t_swapchain.extent() },
+        .framebuffer     = framebuffers[swapchain_image_index].get(),
+        .renderArea      = { .extent = extent },
         .clearValueCount = static_cast<uint32_t>(clear_values.size()),
         .pClearValues    = clear_values.data()
     };
-    command_buffer.beginRenderPass(render_pass_begin_info, vk::SubpassContents::eInline);
-
-    t_camera.set_perspective_projection(
-        90.f,
-        static_cast<float>(extent.width) / static_cast<float>(extent.height),
-        0.1f,
-        10000.f
+    t_command_buffer.beginRenderPass(
+        render_pass_begin_info, vk::SubpassContents::eInline
     );
-    camera_uniform.set(ShaderCamera{
-        .position   = glm::vec4{ t_camera.position(), 1 },
-        .view       = t_camera.view(),
-        .projection = t_camera.projection()
-    });
 
-    command_buffer.bindDescriptorSets(
+    t_command_buffer.bindDescriptorSets(
         vk::PipelineBindPoint::eGraphics,
         pipeline_layout.get(),
         0,
         std::array{ descriptor_set.get() },
-        nullptr
+        std::array{ camera_uniform.dynamic_offset(frames.frame_index()) }
     );
-    command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline.get());
-    terrain.draw(command_buffer);
+    t_command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline.get());
+    terrain.draw(t_command_buffer);
 
-    command_buffer.endRenderPass();
-    command_buffer.end();
+    t_command_buffer.endRenderPass();
 }
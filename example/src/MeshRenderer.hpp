@@ -1,10 +1,15 @@
 #pragma once
 
 #include <core/renderer/base/allocator/Allocator.hpp>
+#include <core/renderer/base/allocator/MemoryMonitor.hpp>
 #include <core/renderer/base/device/Device.hpp>
 #include <core/renderer/base/swapchain/Swapchain.hpp>
-#include <core/renderer/memory/Image.hpp>
+#include <core/renderer/frame/FrameRing.hpp>
+#include <core/renderer/memory/TransientAttachmentPool.hpp>
+#include <core/renderer/memory/UniformRing.hpp>
+#include <core/renderer/render_graph/RenderGraph.hpp>
 #include <core/renderer/scene/Scene.hpp>
+#include <core/renderer/transfer/TransferScheduler.hpp>
 #include <plugins/Renderer.hpp>
 
 #include "Terrain.hpp"
@@ -14,17 +19,19 @@ struct MeshRenderer {
     std::reference_wrapper<core::renderer::Allocator> allocator;
     std::reference_wrapper<core::renderer::Swapchain> swapchain;
     vk::UniqueRenderPass                              render_pass;
-    core::renderer::Image                             depth_image;
-    vk::UniqueImageView                               depth_image_view;
+    // Outlives every render graph, so the depth memory is kept across resizes
+    core::renderer::TransientAttachmentPool           transient_attachments;
+    // Built by the first render(), and again after the swapchain is recreated
+    std::optional<core::renderer::RenderGraph>        render_graph;
+    core::renderer::RenderGraph::ImageHandle          swapchain_image{};
+    core::renderer::RenderGraph::ImageHandle          depth_image{};
+    uint32_t                                          swapchain_image_index{};
     std::vector<vk::UniqueFramebuffer>                framebuffers;
-    vk::UniqueCommandPool                             command_pool;
-    std::vector<vk::CommandBuffer>                    command_buffers;
-    std::vector<vk::UniqueSemaphore>                  image_acquired_semaphores;
-    std::vector<vk::UniqueSemaphore>                  render_finished_semaphores;
-    std::vector<vk::UniqueFence>                      in_flight_fences;
-    uint32_t                                          frame_index{};
-
-    core::renderer::MappedBuffer   camera_uniform;
+    core::renderer::FrameRing                         frames;
+    core::renderer::TransferScheduler                 transfer_scheduler;
+    core::renderer::MemoryMonitor                     memory_monitor;
+
+    core::renderer::UniformRing    camera_uniform;
     Terrain                        terrain;
     vk::UniqueDescriptorSetLayout  descriptor_set_layout;
     vk::UniquePipelineLayout       pipeline_layout;
@@ -44,9 +51,7 @@ struct MeshRenderer {
         -> void;
 
 private:
-    auto record_command_buffer(
-        const core::renderer::vulkan::Swapchain& t_swapchain,
-        uint32_t                                 t_image_index,
-        core::graphics::Camera                   t_camera
-    ) -> void;
+    auto build_render_graph(const core::renderer::vulkan::Swapchain& t_swapchain) -> void;
+    auto update_camera(vk::Extent2D t_extent, core::graphics::Camera t_camera) -> void;
+    auto record_terrain_pass(vk::CommandBuffer t_command_buffer) -> void;
 };
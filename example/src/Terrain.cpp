@@ -1,76 +1,11 @@
 #include "Terrain.hpp"
 
+#include <optional>
 #include <system_error>
 
 #include <core/asset/image/StbImage.hpp>
 #include <core/renderer/base/allocator/Allocator.hpp>
-
-[[nodiscard]]
-static auto create_staging_buffer(
-    const core::renderer::Allocator&          t_allocator,
-    const void*                               t_data,
-    const uint32_t                            t_size,
-    const std::optional<const vk::DeviceSize> t_min_alignment = std::nullopt
-) -> core::renderer::MappedBuffer
-{
-    if (t_data == nullptr || t_size == 0) {
-        return core::renderer::MappedBuffer{};
-    }
-
-    const vk::BufferCreateInfo staging_buffer_create_info{
-        .size  = t_size,
-        .usage = vk::BufferUsageFlagBits::eTransferSrc,
-    };
-
-    return t_min_alignment
-        .transform([&](const vk::DeviceSize min_alignment) {
-            return t_allocator.allocate_mapped_buffer_with_alignment(
-                staging_buffer_create_info, min_alignment, t_data
-            );
-        })
-        .value_or(t_allocator.allocate_mapped_buffer(staging_buffer_create_info, t_data));
-}
-
-template <typename T>
-[[nodiscard]]
-static auto create_staging_buffer(
-    const core::renderer::Allocator&          t_allocator,
-    const std::span<T>                        t_data,
-    const std::optional<const vk::DeviceSize> t_min_alignment = std::nullopt
-) -> core::renderer::MappedBuffer
-{
-    return create_staging_buffer(
-        t_allocator,
-        t_data.data(),
-        static_cast<uint32_t>(t_data.size_bytes()),
-        t_min_alignment
-    );
-}
-
-[[nodiscard]]
-static auto create_gpu_only_buffer(
-    const core::renderer::Allocator&          t_allocator,
-    const vk::BufferUsageFlags                t_usage_flags,
-    const uint32_t                            t_size,
-    const std::optional<const vk::DeviceSize> t_min_alignment = std::nullopt
-) -> core::renderer::Buffer
-{
-    if (t_size == 0) {
-        return core::renderer::Buffer{};
-    }
-
-    const vk::BufferCreateInfo buffer_create_info = {
-        .size = t_size, .usage = t_usage_flags | vk::BufferUsageFlagBits::eTransferDst
-    };
-
-    return t_min_alignment
-        .transform([&](const vk::DeviceSize min_alignment) {
-            return t_allocator.allocate_buffer_with_alignment(
-                buffer_create_info, min_alignment
-            );
-        })
-        .value_or(t_allocator.allocate_buffer(buffer_create_info));
-}
+#include <core/renderer/memory/StagingRing.hpp>
 
 template <typename UniformBlock>
 [[nodiscard]]
@@ -108,7 +43,6 @@ static auto create_image(
     };
 
     constexpr static VmaAllocationCreateInfo allocation_create_info = {
-        .flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
         .usage = VMA_MEMORY_USAGE_AUTO,
     };
 
@@ -173,10 +107,10 @@ static void transition_image_layout(
              && t_new_layout == vk::ImageLayout::eShaderReadOnlyOptimal)
     {
         barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-        barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+        barrier.dstAccessMask = vk::AccessFlagBits::eMemoryRead;
 
         source_stage      = vk::PipelineStageFlagBits::eTransfer;
-        destination_stage = vk::PipelineStageFlagBits::eFragmentShader;
+        destination_stage = vk::PipelineStageFlagBits::eAllCommands;
     }
     else {
         throw std::invalid_argument("unsupported layout transition!");
@@ -198,11 +132,13 @@ static void transition_image_layout(
 static void copy_buffer_to_image(
     vk::CommandBuffer t_command_buffer,
     vk::Buffer        t_buffer,
+    vk::DeviceSize    t_buffer_offset,
     vk::Image         t_image,
     vk::Extent3D      t_extent
 )
 {
     const vk::BufferImageCopy region{
+        .bufferOffset = t_buffer_offset,
         .imageSubresource =
             vk::ImageSubresourceLayers{ .aspectMask = vk::ImageAspectFlagBits::eColor,
                                        .layerCount = 1 },
@@ -238,7 +174,8 @@ static auto create_sampler(const vk::Device t_device) -> vk::UniqueSampler
 
 auto Terrain::create_loader(
     vk::Device                       t_device,
-    const core::renderer::Allocator& t_allocator
+    const core::renderer::Allocator& t_allocator,
+    core::renderer::StagingRing&     t_staging_ring
 ) -> std::packaged_task<Terrain(vk::CommandBuffer)>
 {
     std::vector<Vertex> vertices;
@@ -260,15 +197,25 @@ auto Terrain::create_loader(
     }
 
     auto vertex_buffer_size = static_cast<uint32_t>(std::span{ vertices }.size_bytes());
-    core::renderer::MappedBuffer vertex_staging_buffer{
-        create_staging_buffer(t_allocator, std::span{ vertices })
-    };
-    core::renderer::Buffer       vertex_buffer{ create_gpu_only_buffer(
-        t_allocator,
-        vk::BufferUsageFlagBits::eStorageBuffer
-            | vk::BufferUsageFlagBits::eShaderDeviceAddress,
-        vertex_buffer_size
+    core::renderer::MappedBuffer vertex_buffer{ t_allocator.allocate_buffer(
+        vk::BufferCreateInfo{
+            .size  = vertex_buffer_size,
+            .usage = vk::BufferUsageFlagBits::eStorageBuffer
+                   | vk::BufferUsageFlagBits::eShaderDeviceAddress
+                   | vk::BufferUsageFlagBits::eTransferDst,
+        },
+        core::renderer::MemoryUsage::eUploadDirect
     ) };
+    // Staged only if the device-local memory is not host-visible
+    std::optional<core::renderer::StagingRing::Region> vertex_staging_region;
+    if (vertex_buffer.data() != nullptr) {
+        vertex_buffer.write(std::span<const Vertex>{ vertices });
+        vertex_buffer.flush_dirty();
+    }
+    else {
+        vertex_staging_region =
+            t_staging_ring.upload(std::as_bytes(std::span{ vertices }));
+    }
     core::renderer::MappedBuffer vertex_uniform{
         create_buffer<vk::DeviceAddress>(t_allocator)
     };
@@ -281,9 +228,11 @@ auto Terrain::create_loader(
         throw std::system_error{ std::error_code{}, "Failed to load heightmap" };
     }
 
-    core::renderer::MappedBuffer heightmap_staging_buffer{ create_staging_buffer(
-        t_allocator, image->data(), static_cast<uint32_t>(image->size())
-    ) };
+    const core::renderer::StagingRing::Region heightmap_staging_region{
+        t_staging_ring.upload(std::span{ static_cast<const std::byte*>(image->data()),
+                                         image->size() })
+    };
+    t_staging_ring.flush();
 
     core::renderer::Image heightmap{ create_image(
         t_allocator,
@@ -304,23 +253,28 @@ auto Terrain::create_loader(
     return std::packaged_task<Terrain(vk::CommandBuffer)>{
         [device                   = t_device,
          vertex_buffer_size       = vertex_buffer_size,
-         vertex_staging_buffer    = auto{ std::move(vertex_staging_buffer) },
+         vertex_staging_region    = vertex_staging_region,
          vertex_buffer            = auto{ std::move(vertex_buffer) },
          vertex_uniform           = auto{ std::move(vertex_uniform) },
          quad_count               = quad_count,
          heightmap_extent         = vk::Extent3D{ .width  = image->width(),
                                                   .height = image->height(),
                                                   .depth  = 1 },
-         heightmap_staging_buffer = auto{ std::move(heightmap_staging_buffer) },
+         heightmap_staging_region = heightmap_staging_region,
          heightmap                = auto{ std::move(heightmap) },
          heightmap_view           = auto{ std::move(heightmap_view) },
          heightmap_sampler        = auto{ std::move(heightmap_sampler
          ) }](vk::CommandBuffer t_transfer_command_buffer) mutable -> Terrain {
-            t_transfer_command_buffer.copyBuffer(
-                vertex_staging_buffer.get(),
-                vertex_buffer.get(),
-                std::array{ vk::BufferCopy{ .size = vertex_buffer_size } }
-            );
+            if (vertex_staging_region.has_value()) {
+                t_transfer_command_buffer.copyBuffer(
+                    vertex_staging_region->buffer,
+                    vertex_buffer.get(),
+                    std::array{ vk::BufferCopy{
+                        .srcOffset = vertex_staging_region->offset,
+                        .size      = vertex_buffer_size,
+                    } }
+                );
+            }
 
             transition_image_layout(
                 t_transfer_command_buffer,
@@ -330,7 +284,8 @@ auto Terrain::create_loader(
             );
             copy_buffer_to_image(
                 t_transfer_command_buffer,
-                heightmap_staging_buffer.get(),
+                heightmap_staging_region.buffer,
+                heightmap_staging_region.offset,
                 heightmap.get(),
                 heightmap_extent
             );
@@ -370,6 +325,24 @@ auto Terrain::heightmap_sampler() const noexcept -> const vk::UniqueSampler&
     return m_heightmap_sampler;
 }
 
+auto Terrain::uploaded_resources() const -> core::renderer::UploadedResources
+{
+    const vk::ImageSubresourceRange heightmap_range{
+        .aspectMask = vk::ImageAspectFlagBits::eColor,
+        .levelCount = 1,
+        .layerCount = 1,
+    };
+
+    return core::renderer::UploadedResources{
+        .buffers = { m_vertex_buffer.get() },
+        .images  = { core::renderer::UploadedResources::Image{
+            .image             = m_heightmap.get(),
+            .layout            = vk::ImageLayout::eShaderReadOnlyOptimal,
+            .subresource_range = heightmap_range,
+        } },
+    };
+}
+
 auto Terrain::draw(vk::CommandBuffer graphics_command_buffer) const -> void
 {
     uint32_t group_count_x{ m_quad_count.x };
@@ -397,4 +370,5 @@ Terrain::Terrain(
     m_vertex_uniform.set(t_device.getBufferAddress(vk::BufferDeviceAddressInfo{
         .buffer = m_vertex_buffer.get(),
     }));
+    m_vertex_uniform.flush_dirty();
 }
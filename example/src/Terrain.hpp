@@ -7,6 +7,8 @@
 #include <core/renderer/base/allocator/Allocator.hpp>
 #include <core/renderer/memory/Buffer.hpp>
 #include <core/renderer/memory/Image.hpp>
+#include <core/renderer/memory/StagingRing.hpp>
+#include <core/renderer/transfer/TransferScheduler.hpp>
 
 class Terrain {
 public:
@@ -16,9 +18,11 @@ public:
     };
 
     [[nodiscard]]
-    static auto
-        create_loader(vk::Device device, const core::renderer::Allocator& allocator)
-            -> std::packaged_task<Terrain(vk::CommandBuffer)>;
+    static auto create_loader(
+        vk::Device                       device,
+        const core::renderer::Allocator& allocator,
+        core::renderer::StagingRing&     staging_ring
+    ) -> std::packaged_task<Terrain(vk::CommandBuffer)>;
 
     [[nodiscard]]
     auto vertex_uniform() const noexcept -> const core::renderer::MappedBuffer&;
@@ -29,6 +33,9 @@ public:
     [[nodiscard]]
     auto heightmap_sampler() const noexcept -> const vk::UniqueSampler&;
 
+    [[nodiscard]]
+    auto uploaded_resources() const -> core::renderer::UploadedResources;
+
     auto draw(vk::CommandBuffer graphics_command_buffer) const -> void;
 
 private:
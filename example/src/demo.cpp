@@ -11,7 +11,6 @@
 #include "core/renderer/base/swapchain/Swapchain.hpp"
 
 #include "Controller.hpp"
-#include "demo_init.hpp"
 #include "MeshRenderer.hpp"
 
 using namespace entt::literals;
@@ -21,33 +20,11 @@ auto demo::run(app::App& t_app) noexcept -> int
 {
     return MeshRenderer::create(t_app.store())
         .transform([&](MeshRenderer t_demo) {
-            t_demo.swapchain.get().on_swapchain_recreated(
-                [&t_demo](const renderer::vulkan::Swapchain& t_swapchain) {
-                    t_demo.depth_image.reset();
-                    t_demo.depth_image = init::create_depth_image(
-                        t_demo.device.get().physical_device(),
-                        t_demo.allocator,
-                        t_swapchain.extent()
-                    );
-                }
-            );
+            // The swapchain waits for the device before recreating itself
             t_demo.swapchain.get().on_swapchain_recreated(
                 [&t_demo](const renderer::vulkan::Swapchain&) {
-                    t_demo.depth_image_view.reset();
-                    t_demo.depth_image_view =
-                        init::create_depth_image_view(t_demo.device, *t_demo.depth_image);
-                }
-            );
-            t_demo.swapchain.get().on_swapchain_recreated(
-                [&t_demo](const renderer::vulkan::Swapchain& t_swapchain) {
                     t_demo.framebuffers.clear();
-                    t_demo.framebuffers = init::create_framebuffers(
-                        *t_demo.device.get(),
-                        t_swapchain.extent(),
-                        t_swapchain.image_views(),
-                        *t_demo.render_pass,
-                        *t_demo.depth_image_view
-                    );
+                    t_demo.render_graph.reset();
                 }
             );
 
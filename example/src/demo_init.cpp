@@ -59,7 +59,8 @@ auto create_render_pass(
         .loadOp         = vk::AttachmentLoadOp::eClear,
         .stencilLoadOp  = vk::AttachmentLoadOp::eDontCare,
         .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
-        .finalLayout    = vk::ImageLayout::ePresentSrcKHR,
+        .initialLayout  = vk::ImageLayout::eColorAttachmentOptimal,
+        .finalLayout    = vk::ImageLayout::eColorAttachmentOptimal,
     };
     const vk::AttachmentReference color_attachment_reference{
         .attachment = 0,
@@ -73,7 +74,7 @@ auto create_render_pass(
         .storeOp        = vk::AttachmentStoreOp::eDontCare,
         .stencilLoadOp  = vk::AttachmentLoadOp::eDontCare,
         .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
-        .initialLayout  = vk::ImageLayout::eUndefined,
+        .initialLayout  = vk::ImageLayout::eDepthStencilAttachmentOptimal,
         .finalLayout    = vk::ImageLayout::eDepthStencilAttachmentOptimal,
     };
     const vk::AttachmentReference depth_attachment_reference{
@@ -91,40 +92,29 @@ auto create_render_pass(
         .pDepthStencilAttachment = &depth_attachment_reference,
     };
 
-    const vk::SubpassDependency subpass_dependency{
-        .srcSubpass   = VK_SUBPASS_EXTERNAL,
-        .dstSubpass   = 0,
-        .srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput
-                      | vk::PipelineStageFlagBits::eEarlyFragmentTests,
-        .dstStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput
-                      | vk::PipelineStageFlagBits::eEarlyFragmentTests,
-        .srcAccessMask = vk::AccessFlagBits::eNone,
-        .dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite
-                       | vk::AccessFlagBits::eDepthStencilAttachmentWrite,
-    };
-
+    // The render graph transitions the attachments around the render pass,
+    // so the render pass needs no layout changes or external dependencies
     const vk::RenderPassCreateInfo render_pass_create_info{
         .attachmentCount = static_cast<uint32_t>(attachment_descriptions.size()),
         .pAttachments    = attachment_descriptions.data(),
         .subpassCount    = 1,
         .pSubpasses      = &subpass_description,
-        .dependencyCount = 1,
-        .pDependencies   = &subpass_dependency,
     };
 
     return t_device->createRenderPassUnique(render_pass_create_info);
 }
 
-auto create_depth_image(
-    const vk::PhysicalDevice   t_physical_device,
-    const renderer::Allocator& t_allocator,
-    const vk::Extent2D         t_swapchain_extent
-) -> renderer::Image
+auto depth_image_create_info(
+    const vk::PhysicalDevice t_physical_device,
+    const vk::Extent2D       t_swapchain_extent
+) -> vk::ImageCreateInfo
 {
-    const vk::ImageCreateInfo image_create_info = {
-        .imageType = vk::ImageType::e2D,
-        .format    = find_depth_format(t_physical_device),
-        .extent = vk::Extent3D{ t_swapchain_extent.width, t_swapchain_extent.height, 1 },
+    return vk::ImageCreateInfo{
+        .imageType     = vk::ImageType::e2D,
+        .format        = find_depth_format(t_physical_device),
+        .extent        = vk::Extent3D{ t_swapchain_extent.width,
+                                       t_swapchain_extent.height,
+                                       1 },
         .mipLevels     = 1,
         .arrayLayers   = 1,
         .samples       = vk::SampleCountFlagBits::e1,
@@ -132,34 +122,6 @@ auto create_depth_image(
         .usage         = vk::ImageUsageFlagBits::eDepthStencilAttachment,
         .initialLayout = vk::ImageLayout::eUndefined,
     };
-
-    constexpr static VmaAllocationCreateInfo allocation_create_info = {
-        .flags    = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
-        .usage    = VMA_MEMORY_USAGE_AUTO,
-        .priority = 1.f,
-    };
-
-    return t_allocator.allocate_image(image_create_info, allocation_create_info);
-}
-
-auto create_depth_image_view(
-    const renderer::Device& t_device,
-    const vk::Image         t_depth_image
-) -> vk::UniqueImageView
-{
-    const vk::ImageViewCreateInfo image_view_create_info{
-        .image    = t_depth_image,
-        .viewType = vk::ImageViewType::e2D,
-        .format   = find_depth_format(t_device.physical_device()),
-        .subresourceRange =
-            vk::ImageSubresourceRange{ .aspectMask     = vk::ImageAspectFlagBits::eDepth,
-                                      .baseMipLevel   = 0,
-                                      .levelCount     = 1,
-                                      .baseArrayLayer = 0,
-                                      .layerCount     = 1 },
-    };
-
-    return t_device->createImageViewUnique(image_view_create_info);
 }
 
 auto create_framebuffers(
@@ -203,49 +165,4 @@ auto create_command_pool(const vk::Device t_device, const uint32_t t_queue_famil
     return t_device.createCommandPoolUnique(command_pool_create_info);
 }
 
-auto create_command_buffers(
-    const vk::Device      t_device,
-    const vk::CommandPool t_command_pool,
-    const uint32_t        t_count
-) -> std::vector<vk::CommandBuffer>
-{
-    const vk::CommandBufferAllocateInfo command_buffer_allocate_info{
-        .commandPool        = t_command_pool,
-        .level              = vk::CommandBufferLevel::ePrimary,
-        .commandBufferCount = t_count
-    };
-
-    return t_device.allocateCommandBuffers(command_buffer_allocate_info);
-}
-
-auto create_semaphores(const vk::Device t_device, const uint32_t t_count)
-    -> std::vector<vk::UniqueSemaphore>
-{
-    constexpr vk::SemaphoreCreateInfo create_info{};
-    std::vector<vk::UniqueSemaphore>  semaphores;
-    semaphores.reserve(t_count);
-
-    for (uint32_t i = 0; i < t_count; i++) {
-        semaphores.emplace_back(t_device.createSemaphoreUnique(create_info));
-    }
-
-    return semaphores;
-}
-
-auto create_fences(const vk::Device t_device, const uint32_t t_count)
-    -> std::vector<vk::UniqueFence>
-{
-    constexpr vk::FenceCreateInfo fence_create_info{
-        .flags = vk::FenceCreateFlagBits::eSignaled
-    };
-    std::vector<vk::UniqueFence> fences;
-    fences.reserve(t_count);
-
-    for (uint32_t i = 0; i < t_count; i++) {
-        fences.emplace_back(t_device.createFenceUnique(fence_create_info));
-    }
-
-    return fences;
-}
-
 }   // namespace init
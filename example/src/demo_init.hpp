@@ -18,18 +18,12 @@ auto create_render_pass(
     const core::renderer::Device& t_device
 ) -> vk::UniqueRenderPass;
 
+// For the depth image of the render graph
 [[nodiscard]]
-auto create_depth_image(
-    vk::PhysicalDevice               physical_device,
-    const core::renderer::Allocator& allocator,
-    vk::Extent2D                     swapchain_extent
-) -> core::renderer::Image;
-
-[[nodiscard]]
-auto create_depth_image_view(
-    const core::renderer::Device& t_device,
-    vk::Image                     t_depth_image
-) -> vk::UniqueImageView;
+auto depth_image_create_info(
+    vk::PhysicalDevice t_physical_device,
+    vk::Extent2D       t_swapchain_extent
+) -> vk::ImageCreateInfo;
 
 [[nodiscard]]
 auto create_framebuffers(
@@ -44,18 +38,4 @@ auto create_framebuffers(
 auto create_command_pool(vk::Device t_device, uint32_t t_queue_family_index)
     -> vk::UniqueCommandPool;
 
-[[nodiscard]]
-auto create_command_buffers(
-    vk::Device      t_device,
-    vk::CommandPool t_command_pool,
-    uint32_t        t_count
-) -> std::vector<vk::CommandBuffer>;
-
-[[nodiscard]]
-auto create_semaphores(vk::Device t_device, uint32_t t_count)
-    -> std::vector<vk::UniqueSemaphore>;
-
-[[nodiscard]]
-auto create_fences(vk::Device t_device, uint32_t t_count) -> std::vector<vk::UniqueFence>;
-
 }   // namespace init
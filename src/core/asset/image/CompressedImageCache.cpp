@@ -0,0 +1,386 @@
+#include "CompressedImageCache.hpp"
+
+#include <array>
+#include <bit>
+#include <cmath>
+
+#include <spdlog/spdlog.h>
+
+#include <vulkan/vulkan.hpp>
+
+#include <xxhash.h>
+
+#include "StbImage.hpp"
+
+using namespace core::asset;
+
+struct CompressionInfo {
+    uint32_t            channel_count;
+    vk::Format          source_format;
+    ktx_transcode_fmt_e target_format;
+};
+
+[[nodiscard]]
+static auto compression_info(const CompressedImageCache::Usage t_usage) noexcept
+    -> CompressionInfo
+{
+    using enum CompressedImageCache::Usage;
+    switch (t_usage) {
+        case eColor:
+            return CompressionInfo{
+                .channel_count = 4,
+                .source_format = vk::Format::eR8G8B8A8Srgb,
+                .target_format = KTX_TTF_BC7_RGBA,
+            };
+        case eLinear:
+            return CompressionInfo{
+                .channel_count = 4,
+                .source_format = vk::Format::eR8G8B8A8Unorm,
+                .target_format = KTX_TTF_BC7_RGBA,
+            };
+        case eSingleChannel:
+            return CompressionInfo{
+                .channel_count = 1,
+                .source_format = vk::Format::eR8Unorm,
+                .target_format = KTX_TTF_BC4_R,
+            };
+        default: std::unreachable();
+    }
+}
+
+[[nodiscard]]
+static auto read_file(const std::filesystem::path& t_filepath)
+    -> std::optional<std::vector<std::uint8_t>>
+{
+    std::ifstream file{ t_filepath, std::ios::binary | std::ios::in | std::ios::ate };
+
+    const std::streamsize file_size = file.tellg();
+    if (file_size == -1) {
+        return std::nullopt;
+    }
+
+    std::vector<std::uint8_t> buffer(static_cast<size_t>(file_size));
+
+    file.seekg(0, std::ios::beg);
+    file.read(reinterpret_cast<char*>(buffer.data()), file_size);
+
+    return buffer;
+}
+
+// Keeps the first channels of each RGBA pixel
+[[nodiscard]]
+static auto select_channels(
+    const std::span<const std::uint8_t> t_rgba_pixels,
+    const uint32_t                      t_channel_count
+) -> std::vector<std::uint8_t>
+{
+    std::vector<std::uint8_t> pixels;
+    pixels.reserve(t_rgba_pixels.size() / 4 * t_channel_count);
+    for (size_t offset{}; offset < t_rgba_pixels.size(); offset += 4) {
+        pixels.insert(
+            pixels.end(),
+            t_rgba_pixels.begin() + static_cast<std::ptrdiff_t>(offset),
+            t_rgba_pixels.begin() + static_cast<std::ptrdiff_t>(offset + t_channel_count)
+        );
+    }
+    return pixels;
+}
+
+[[nodiscard]]
+static auto srgb_to_linear(const float t_value) noexcept -> float
+{
+    return t_value <= 0.04045f ? t_value / 12.92f
+                               : std::pow((t_value + 0.055f) / 1.055f, 2.4f);
+}
+
+[[nodiscard]]
+static auto linear_to_srgb(const float t_value) noexcept -> float
+{
+    return t_value <= 0.0031308f ? t_value * 12.92f
+                                 : 1.055f * std::pow(t_value, 1.f / 2.4f) - 0.055f;
+}
+
+// Halves the image with a box filter, odd sizes repeat their last row and column.
+// Colors are averaged in linear space.
+[[nodiscard]]
+static auto downsample(
+    const std::span<const std::uint8_t> t_pixels,
+    const uint32_t                      t_width,
+    const uint32_t                      t_height,
+    const CompressedImageCache::Usage   t_usage
+) -> std::vector<std::uint8_t>
+{
+    const uint32_t channel_count{ compression_info(t_usage).channel_count };
+    const uint32_t width{ std::max(t_width / 2, 1u) };
+    const uint32_t height{ std::max(t_height / 2, 1u) };
+
+    const auto is_srgb = [t_usage](const uint32_t channel) {
+        return t_usage == CompressedImageCache::Usage::eColor && channel < 3;
+    };
+    const auto decode = [&](const size_t x, const size_t y, const uint32_t channel) {
+        const std::uint8_t pixel{ t_pixels[(y * t_width + x) * channel_count + channel] };
+        const float        value{ static_cast<float>(pixel) / 255.f };
+        return is_srgb(channel) ? srgb_to_linear(value) : value;
+    };
+
+    std::vector<std::uint8_t> pixels(size_t{ width } * height * channel_count);
+    for (uint32_t y{}; y < height; y++) {
+        for (uint32_t x{}; x < width; x++) {
+            const std::array xs{ 2 * x, std::min(2 * x + 1, t_width - 1) };
+            const std::array ys{ 2 * y, std::min(2 * y + 1, t_height - 1) };
+
+            std::array<float, 4> texel{};
+            for (uint32_t channel{}; channel < channel_count; channel++) {
+                for (const uint32_t source_y : ys) {
+                    for (const uint32_t source_x : xs) {
+                        texel[channel] += decode(source_x, source_y, channel) / 4.f;
+                    }
+                }
+            }
+
+            for (uint32_t channel{}; channel < channel_count; channel++) {
+                const float value{ is_srgb(channel) ? linear_to_srgb(texel[channel])
+                                                    : texel[channel] };
+                pixels[(size_t{ y } * width + x) * channel_count + channel] =
+                    static_cast<std::uint8_t>(
+                        std::lround(std::clamp(value, 0.f, 1.f) * 255.f)
+                    );
+            }
+        }
+    }
+
+    return pixels;
+}
+
+struct KtxTextureDeleter {
+    auto operator()(ktxTexture2* t_texture) const noexcept -> void
+    {
+        ktxTexture_Destroy(ktxTexture(t_texture));
+    }
+};
+
+namespace core::asset {
+
+CompressedImageCache::CompressedImageCache(
+    std::filesystem::path t_directory,
+    const Settings&       t_settings
+)
+    : m_directory{ std::move(t_directory) },
+      m_settings{ t_settings }
+{
+    std::filesystem::create_directories(m_directory);
+}
+
+auto CompressedImageCache::load_from_file(
+    const std::filesystem::path& t_filepath,
+    const Usage                  t_usage
+) const -> std::optional<KtxImage>
+{
+    return read_file(t_filepath).and_then([this, t_usage](const auto& data) {
+        return load_from_memory(data, t_usage);
+    });
+}
+
+auto CompressedImageCache::load_from_memory(
+    const std::span<const std::uint8_t> t_data,
+    const Usage                         t_usage
+) const -> std::optional<KtxImage>
+{
+    if (stbi_info_from_memory(
+            t_data.data(), static_cast<int>(t_data.size()), nullptr, nullptr, nullptr
+        )
+        != 1)
+    {
+        return std::nullopt;
+    }
+
+    const std::filesystem::path cache_path{ cache_path_of(t_data, t_usage) };
+    if (std::filesystem::exists(cache_path)) {
+        if (std::optional<KtxImage> cached_image{ KtxImage::load_from_file(cache_path) };
+            cached_image.has_value())
+        {
+            return cached_image;
+        }
+        SPDLOG_WARN(
+            "Discarding unreadable compressed image cache entry {}",
+            cache_path.generic_string()
+        );
+    }
+
+    return compress(t_data, t_usage, cache_path);
+}
+
+auto CompressedImageCache::directory() const noexcept -> const std::filesystem::path&
+{
+    return m_directory;
+}
+
+auto CompressedImageCache::cache_path_of(
+    const std::span<const std::uint8_t> t_data,
+    const Usage                         t_usage
+) const -> std::filesystem::path
+{
+    // Bump this whenever the produced files change for the same inputs
+    constexpr static uint64_t s_version{ 3 };
+
+    // XXH3 is specified bit for bit, so names match across runs, platforms and compilers
+    const std::array<uint64_t, 5> key{
+        s_version,
+        XXH3_64bits(t_data.data(), t_data.size()),
+        static_cast<uint64_t>(std::to_underlying(t_usage)),
+        m_settings.quality_level,
+        m_settings.supercompression_level,
+    };
+
+    return m_directory
+         / std::format("{:016x}.ktx2", XXH3_64bits(key.data(), sizeof(key)));
+}
+
+auto CompressedImageCache::compress(
+    const std::span<const std::uint8_t> t_data,
+    const Usage                         t_usage,
+    const std::filesystem::path&        t_cache_path
+) const -> std::optional<KtxImage>
+{
+    const auto [channel_count, source_format, target_format]{ compression_info(t_usage) };
+
+    // Always loaded as RGBA, so gray images end up in the red channel
+    // instead of single channel images getting the luminance of colored ones
+    const std::optional<StbImage> source{
+        StbImage::load_from_memory(t_data, StbImage::Channels::eRGBA)
+    };
+    if (!source.has_value()) {
+        return std::nullopt;
+    }
+
+    const uint32_t mip_level_count{ static_cast<uint32_t>(
+        std::bit_width(std::max(source->width(), source->height()))
+    ) };
+
+    ktxTextureCreateInfo create_info{};
+    create_info.vkFormat        = static_cast<ktx_uint32_t>(source_format);
+    create_info.baseWidth       = source->width();
+    create_info.baseHeight      = source->height();
+    create_info.baseDepth       = 1;
+    create_info.numDimensions   = 2;
+    create_info.numLevels       = mip_level_count;
+    create_info.numLayers       = 1;
+    create_info.numFaces        = 1;
+    create_info.isArray         = KTX_FALSE;
+    create_info.generateMipmaps = KTX_FALSE;
+
+    ktxTexture2* raw_texture{};
+    if (const ktxResult result{ ktxTexture2_Create(
+            &create_info, KTX_TEXTURE_CREATE_ALLOC_STORAGE, &raw_texture
+        ) };
+        result != KTX_SUCCESS)
+    {
+        SPDLOG_ERROR("ktxTexture2_Create failed with '{}'", ktxErrorString(result));
+        return std::nullopt;
+    }
+    const std::unique_ptr<ktxTexture2, KtxTextureDeleter> texture{ raw_texture };
+
+    std::vector<std::uint8_t> pixels{ select_channels(
+        std::span{ static_cast<const std::uint8_t*>(source->data()), source->size() },
+        channel_count
+    ) };
+    uint32_t width{ source->width() };
+    uint32_t height{ source->height() };
+    for (uint32_t mip_level{}; mip_level < mip_level_count; mip_level++) {
+        if (mip_level != 0) {
+            pixels = downsample(pixels, width, height, t_usage);
+            width  = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+        }
+
+        if (const ktxResult result{ ktxTexture_SetImageFromMemory(
+                ktxTexture(texture.get()), mip_level, 0, 0, pixels.data(), pixels.size()
+            ) };
+            result != KTX_SUCCESS)
+        {
+            SPDLOG_ERROR(
+                "ktxTexture_SetImageFromMemory failed with '{}'", ktxErrorString(result)
+            );
+            return std::nullopt;
+        }
+    }
+
+    ktxBasisParams basis_params{};
+    basis_params.structSize  = sizeof(basis_params);
+    basis_params.uastc       = KTX_TRUE;
+    basis_params.uastcFlags  = std::min(
+        m_settings.quality_level, static_cast<uint32_t>(KTX_PACK_UASTC_LEVEL_VERYSLOW)
+    );
+    basis_params.threadCount = m_settings.thread_count != 0
+                                 ? m_settings.thread_count
+                                 : std::max(std::thread::hardware_concurrency(), 1u);
+
+    if (const ktxResult result{
+            ktxTexture2_CompressBasisEx(texture.get(), &basis_params) };
+        result != KTX_SUCCESS)
+    {
+        SPDLOG_ERROR(
+            "ktxTexture2_CompressBasisEx failed with '{}'", ktxErrorString(result)
+        );
+        return std::nullopt;
+    }
+
+    if (const ktxResult result{
+            ktxTexture2_TranscodeBasis(texture.get(), target_format, KTX_TF_HIGH_QUALITY) };
+        result != KTX_SUCCESS)
+    {
+        SPDLOG_ERROR(
+            "ktxTexture2_TranscodeBasis failed with '{}'", ktxErrorString(result)
+        );
+        return std::nullopt;
+    }
+
+    if (m_settings.supercompression_level != 0) {
+        if (const ktxResult result{ ktxTexture2_DeflateZstd(
+                texture.get(), m_settings.supercompression_level
+            ) };
+            result != KTX_SUCCESS)
+        {
+            SPDLOG_ERROR(
+                "ktxTexture2_DeflateZstd failed with '{}'", ktxErrorString(result)
+            );
+            return std::nullopt;
+        }
+    }
+
+    // Write to a unique temporary first so that concurrent imports
+    // and crashes never leave a truncated entry behind
+    std::filesystem::path temporary_path{ t_cache_path };
+    temporary_path += std::format(
+        ".{:x}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id())
+    );
+
+    if (const ktxResult result{ ktxTexture_WriteToNamedFile(
+            ktxTexture(texture.get()), temporary_path.generic_string().c_str()
+        ) };
+        result != KTX_SUCCESS)
+    {
+        SPDLOG_ERROR(
+            "ktxTexture_WriteToNamedFile failed writing {} with '{}'",
+            temporary_path.generic_string(),
+            ktxErrorString(result)
+        );
+        return std::nullopt;
+    }
+
+    std::error_code error_code;
+    std::filesystem::rename(temporary_path, t_cache_path, error_code);
+    if (error_code) {
+        SPDLOG_ERROR(
+            "Failed to store compressed image {}: {}",
+            t_cache_path.generic_string(),
+            error_code.message()
+        );
+        std::filesystem::remove(temporary_path, error_code);
+        return std::nullopt;
+    }
+
+    return KtxImage::load_from_file(t_cache_path);
+}
+
+}   // namespace core::asset
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <span>
+
+#include "KtxImage.hpp"
+
+namespace core::asset {
+
+class CompressedImageCache {
+public:
+    ///------------------///
+    ///  Nested classes  ///
+    ///------------------///
+    enum class Usage {
+        eColor,           // BC7, sRGB
+        eLinear,          // BC7, e.g. metallic-roughness or normals
+        eSingleChannel    // BC4, the red channel, e.g. occlusion
+    };
+
+    struct Settings {
+        // UASTC pack level [0, 4] - higher is slower but better quality
+        uint32_t quality_level{ 2 };
+        // 0 means std::thread::hardware_concurrency()
+        uint32_t thread_count{};
+        // zstd level used for the cached files, 0 disables supercompression
+        uint32_t supercompression_level{ 3 };
+    };
+
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    explicit CompressedImageCache(
+        std::filesystem::path t_directory,
+        const Settings&       t_settings = {}
+    );
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    [[nodiscard]]
+    auto load_from_file(const std::filesystem::path& t_filepath, Usage t_usage) const
+        -> std::optional<KtxImage>;
+
+    [[nodiscard]]
+    auto load_from_memory(std::span<const std::uint8_t> t_data, Usage t_usage) const
+        -> std::optional<KtxImage>;
+
+    [[nodiscard]]
+    auto directory() const noexcept -> const std::filesystem::path&;
+
+private:
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    std::filesystem::path m_directory;
+    Settings              m_settings;
+
+    ///***********///
+    ///  Methods  ///
+    ///***********///
+    [[nodiscard]]
+    auto cache_path_of(std::span<const std::uint8_t> t_data, Usage t_usage) const
+        -> std::filesystem::path;
+
+    [[nodiscard]]
+    auto compress(
+        std::span<const std::uint8_t> t_data,
+        Usage                         t_usage,
+        const std::filesystem::path&  t_cache_path
+    ) const -> std::optional<KtxImage>;
+};
+
+}   // namespace core::asset
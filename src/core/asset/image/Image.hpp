@@ -1,5 +1,11 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+
 namespace vk {
 
 enum class Format;
@@ -12,8 +18,9 @@ class Image {
 public:
     virtual ~Image() = default;
 
+    // May decode on first access, and throw if that fails
     [[nodiscard]]
-    virtual auto data() const noexcept -> void* = 0;
+    virtual auto data() const -> void* = 0;
     [[nodiscard]]
     virtual auto size() const noexcept -> size_t = 0;
 
@@ -29,6 +36,37 @@ public:
 
     [[nodiscard]]
     virtual auto format() const noexcept -> vk::Format = 0;
+
+    // Writes size() bytes of pixel data into t_destination.
+    // Images that keep their source encoded decode straight into it.
+    virtual auto decode_to(std::span<std::byte> t_destination) const -> void
+    {
+        if (t_destination.size() < size()) {
+            throw std::invalid_argument{ "Image destination is too small" };
+        }
+        std::memcpy(t_destination.data(), data(), size());
+    }
+
+    [[nodiscard]]
+    virtual auto level_size(const uint32_t t_mip_level) const -> size_t
+    {
+        if (t_mip_level != 0) {
+            throw std::out_of_range{ "Image mip level is out of range" };
+        }
+        return size();
+    }
+
+    // Writes level_size(t_mip_level) bytes of a single mip level into t_destination
+    virtual auto decode_level_to(
+        const uint32_t             t_mip_level,
+        const std::span<std::byte> t_destination
+    ) const -> void
+    {
+        if (t_mip_level != 0) {
+            throw std::out_of_range{ "Image mip level is out of range" };
+        }
+        decode_to(t_destination);
+    }
 };
 
 }   // namespace core::asset
@@ -0,0 +1,151 @@
+#include "JpegImage.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <turbojpeg.h>
+
+#include <vulkan/vulkan.hpp>
+
+constexpr static size_t g_channel_count{ 4 };
+
+struct DecompressorDeleter {
+    auto operator()(tjhandle t_decompressor) const noexcept -> void
+    {
+        tj3Destroy(t_decompressor);
+    }
+};
+
+using Decompressor = std::unique_ptr<void, DecompressorDeleter>;
+
+[[nodiscard]]
+static auto create_decompressor() -> Decompressor
+{
+    Decompressor decompressor{ tj3Init(TJINIT_DECOMPRESS) };
+    if (decompressor == nullptr) {
+        SPDLOG_ERROR("tj3Init failed with '{}'", tj3GetErrorStr(nullptr));
+    }
+    return decompressor;
+}
+
+namespace core::asset {
+
+auto JpegImage::load_from_memory(const std::span<const std::uint8_t> t_data
+) -> std::optional<JpegImage>
+{
+    const Decompressor decompressor{ create_decompressor() };
+    if (decompressor == nullptr) {
+        return std::nullopt;
+    }
+
+    // Reads the markers up to the first scan, the entropy coded data is left to decode_to
+    if (tj3DecompressHeader(decompressor.get(), t_data.data(), t_data.size()) != 0) {
+        SPDLOG_ERROR(
+            "tj3DecompressHeader failed with '{}'", tj3GetErrorStr(decompressor.get())
+        );
+        return std::nullopt;
+    }
+
+    const auto width{ static_cast<uint32_t>(tj3Get(decompressor.get(), TJPARAM_JPEGWIDTH)
+    ) };
+    const auto height{
+        static_cast<uint32_t>(tj3Get(decompressor.get(), TJPARAM_JPEGHEIGHT))
+    };
+
+    return JpegImage{ std::vector(t_data.begin(), t_data.end()), width, height };
+}
+
+auto JpegImage::data() const -> void*
+{
+    // A throwing call leaves the flag unset, so the next call tries again
+    std::call_once(m_decoded_data->once_flag, [this] {
+        auto pixels{ std::make_unique_for_overwrite<std::uint8_t[]>(size()) };
+        if (!decode(std::as_writable_bytes(std::span{ pixels.get(), size() }))) {
+            throw std::runtime_error{ "Failed to decode JPEG image" };
+        }
+        m_decoded_data->pixels = std::move(pixels);
+    });
+    return m_decoded_data->pixels.get();
+}
+
+auto JpegImage::size() const noexcept -> size_t
+{
+    return static_cast<size_t>(m_width) * static_cast<size_t>(m_height) * g_channel_count;
+}
+
+auto JpegImage::width() const noexcept -> uint32_t
+{
+    return m_width;
+}
+
+auto JpegImage::height() const noexcept -> uint32_t
+{
+    return m_height;
+}
+
+auto JpegImage::depth() const noexcept -> uint32_t
+{
+    return 1u;
+}
+
+auto JpegImage::mip_levels() const noexcept -> uint32_t
+{
+    return 1u;
+}
+
+auto JpegImage::format() const noexcept -> vk::Format
+{
+    return vk::Format::eR8G8B8A8Srgb;
+}
+
+auto JpegImage::decode_to(const std::span<std::byte> t_destination) const -> void
+{
+    if (t_destination.size() < size()) {
+        throw std::invalid_argument{ "Image destination is too small" };
+    }
+
+    if (!decode(t_destination)) {
+        throw std::runtime_error{ "Failed to decode JPEG image" };
+    }
+}
+
+JpegImage::JpegImage(
+    std::vector<std::uint8_t>&& t_encoded_data,
+    const uint32_t              t_width,
+    const uint32_t              t_height
+)
+    : m_encoded_data{ std::move(t_encoded_data) },
+      m_width{ t_width },
+      m_height{ t_height }
+{}
+
+auto JpegImage::decode(const std::span<std::byte> t_destination) const -> bool
+{
+    const Decompressor decompressor{ create_decompressor() };
+    if (decompressor == nullptr) {
+        return false;
+    }
+
+    if (tj3Decompress8(
+            decompressor.get(),
+            m_encoded_data.data(),
+            m_encoded_data.size(),
+            reinterpret_cast<unsigned char*>(t_destination.data()),
+            0,
+            TJPF_RGBA
+        )
+        != 0)
+    {
+        // Warnings (e.g. premature end of data) still produce a usable image
+        if (tj3GetErrorCode(decompressor.get()) == TJERR_FATAL) {
+            SPDLOG_ERROR(
+                "tj3Decompress8 failed with '{}'", tj3GetErrorStr(decompressor.get())
+            );
+            return false;
+        }
+        SPDLOG_WARN("tj3Decompress8: {}", tj3GetErrorStr(decompressor.get()));
+    }
+
+    return true;
+}
+
+}   // namespace core::asset
@@ -31,8 +31,12 @@ auto KtxImage::load_from_file(const std::filesystem::path& t_filepath
             KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT,
             &texture
         ) };
-        result != KTX_SUCCESS && result != KTX_UNKNOWN_FILE_FORMAT)
+        result != KTX_SUCCESS)
     {
+        if (result == KTX_UNKNOWN_FILE_FORMAT) {
+            return std::nullopt;
+        }
+
         SPDLOG_ERROR(
             "ktxTexture2_CreateFromNamedFile failed loading file {} with '{}'",
             t_filepath.generic_string(),
@@ -52,19 +56,15 @@ auto KtxImage::load_from_memory(const std::span<const std::uint8_t> t_data
 {
     ktxTexture2* texture{};
 
-    if (ktxTexture2_CreateFromMemory(
-            t_data.data(), t_data.size(), KTX_TEXTURE_CREATE_NO_FLAGS, nullptr
-        )
-        != KTX_SUCCESS)
-    {
-        return std::nullopt;
-    }
-
     if (const ktxResult result{ ktxTexture2_CreateFromMemory(
             t_data.data(), t_data.size(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture
         ) };
         result != KTX_SUCCESS)
     {
+        if (result == KTX_UNKNOWN_FILE_FORMAT) {
+            return std::nullopt;
+        }
+
         SPDLOG_ERROR(
             "ktxTexture2_CreateFromMemory failed with '{}'", ktxErrorString(result)
         );
@@ -132,6 +132,39 @@ auto KtxImage::format() const noexcept -> vk::Format
     return static_cast<vk::Format>(m_ktxTexture->vkFormat);
 }
 
+auto KtxImage::level_size(const uint32_t t_mip_level) const -> size_t
+{
+    if (t_mip_level >= mip_levels()) {
+        throw std::out_of_range{ "Image mip level is out of range" };
+    }
+
+    return ktxTexture_GetImageSize(ktxTexture(m_ktxTexture.get()), t_mip_level);
+}
+
+auto KtxImage::decode_level_to(
+    const uint32_t             t_mip_level,
+    const std::span<std::byte> t_destination
+) const -> void
+{
+    const size_t size{ level_size(t_mip_level) };
+    if (t_destination.size() < size) {
+        throw std::invalid_argument{ "Image destination is too small" };
+    }
+
+    ktx_size_t offset{};
+    if (const ktxResult result{ ktxTexture_GetImageOffset(
+            ktxTexture(m_ktxTexture.get()), t_mip_level, 0, 0, &offset
+        ) };
+        result != KTX_SUCCESS)
+    {
+        throw std::runtime_error{ std::format(
+            "ktxTexture_GetImageOffset failed with '{}'", ktxErrorString(result)
+        ) };
+    }
+
+    std::memcpy(t_destination.data(), m_ktxTexture->pData + offset, size);
+}
+
 auto KtxImage::Deleter::operator()(ktxTexture2* t_ktxTexture) const noexcept -> void
 {
     ktxTexture_Destroy(ktxTexture(t_ktxTexture));
@@ -48,6 +48,11 @@ public:
     [[nodiscard]]
     auto format() const noexcept -> vk::Format override;
 
+    [[nodiscard]]
+    auto level_size(uint32_t t_mip_level) const -> size_t override;
+    auto decode_level_to(uint32_t t_mip_level, std::span<std::byte> t_destination) const
+        -> void override;
+
 private:
     struct Deleter {
         auto operator()(ktxTexture2* t_ktxTexture) const noexcept -> void;
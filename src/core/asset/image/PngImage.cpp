@@ -0,0 +1,208 @@
+#include "PngImage.hpp"
+
+#include <string_view>
+
+#include <spdlog/spdlog.h>
+
+#include <spng.h>
+
+#include <vulkan/vulkan.hpp>
+
+constexpr static size_t g_channel_count{ 4 };
+
+struct ContextDeleter {
+    auto operator()(spng_ctx* t_context) const noexcept -> void
+    {
+        spng_ctx_free(t_context);
+    }
+};
+
+using Context = std::unique_ptr<spng_ctx, ContextDeleter>;
+
+[[nodiscard]]
+static auto create_context(const std::span<const std::uint8_t> t_data) -> Context
+{
+    Context context{ spng_ctx_new(0) };
+    if (context == nullptr) {
+        SPDLOG_ERROR("spng_ctx_new failed");
+        return nullptr;
+    }
+
+    if (const int error{
+            spng_set_png_buffer(context.get(), t_data.data(), t_data.size()) };
+        error != 0)
+    {
+        SPDLOG_ERROR("spng_set_png_buffer failed with '{}'", spng_strerror(error));
+        return nullptr;
+    }
+
+    return context;
+}
+
+[[nodiscard]]
+static auto read_big_endian(const std::span<const std::uint8_t, 4> t_bytes) noexcept
+    -> uint32_t
+{
+    return (static_cast<uint32_t>(t_bytes[0]) << 24)
+         | (static_cast<uint32_t>(t_bytes[1]) << 16)
+         | (static_cast<uint32_t>(t_bytes[2]) << 8) | static_cast<uint32_t>(t_bytes[3]);
+}
+
+// Walks the chunk headers without inflating anything:
+// every chunk has to fit in the file, with image data before the end chunk
+[[nodiscard]]
+static auto has_valid_chunks(const std::span<const std::uint8_t> t_data) noexcept -> bool
+{
+    constexpr static size_t s_signature_size{ 8 };
+    // Length, type and CRC
+    constexpr static size_t s_chunk_overhead{ 12 };
+
+    bool has_image_data{};
+    for (size_t offset{ s_signature_size }; offset + s_chunk_overhead <= t_data.size();) {
+        const std::span<const std::uint8_t> chunk{ t_data.subspan(offset) };
+        const size_t length{ read_big_endian(chunk.first<4>()) };
+        if (length > chunk.size() - s_chunk_overhead) {
+            return false;
+        }
+
+        const std::string_view type{
+            reinterpret_cast<const char*>(chunk.subspan(4).data()), 4
+        };
+        if (type == "IEND") {
+            return has_image_data;
+        }
+        if (type == "IDAT") {
+            has_image_data = true;
+        }
+
+        offset += s_chunk_overhead + length;
+    }
+
+    return false;
+}
+
+namespace core::asset {
+
+auto PngImage::load_from_memory(const std::span<const std::uint8_t> t_data
+) -> std::optional<PngImage>
+{
+    const Context context{ create_context(t_data) };
+    if (context == nullptr) {
+        return std::nullopt;
+    }
+
+    spng_ihdr header{};
+    if (const int error{ spng_get_ihdr(context.get(), &header) }; error != 0) {
+        SPDLOG_ERROR("spng_get_ihdr failed with '{}'", spng_strerror(error));
+        return std::nullopt;
+    }
+
+    size_t size{};
+    if (const int error{ spng_decoded_image_size(context.get(), SPNG_FMT_RGBA8, &size) };
+        error != 0)
+    {
+        SPDLOG_ERROR("spng_decoded_image_size failed with '{}'", spng_strerror(error));
+        return std::nullopt;
+    }
+
+    // Only the structure is checked here, corrupt image data makes decode_to throw
+    if (!has_valid_chunks(t_data)) {
+        SPDLOG_ERROR("PNG image has truncated or missing chunks");
+        return std::nullopt;
+    }
+
+    return PngImage{
+        std::vector(t_data.begin(), t_data.end()),
+        header.width,
+        header.height,
+    };
+}
+
+auto PngImage::data() const -> void*
+{
+    // A throwing call leaves the flag unset, so the next call tries again
+    std::call_once(m_decoded_data->once_flag, [this] {
+        auto pixels{ std::make_unique_for_overwrite<std::uint8_t[]>(size()) };
+        if (!decode(std::as_writable_bytes(std::span{ pixels.get(), size() }))) {
+            throw std::runtime_error{ "Failed to decode PNG image" };
+        }
+        m_decoded_data->pixels = std::move(pixels);
+    });
+    return m_decoded_data->pixels.get();
+}
+
+auto PngImage::size() const noexcept -> size_t
+{
+    return static_cast<size_t>(m_width) * static_cast<size_t>(m_height) * g_channel_count;
+}
+
+auto PngImage::width() const noexcept -> uint32_t
+{
+    return m_width;
+}
+
+auto PngImage::height() const noexcept -> uint32_t
+{
+    return m_height;
+}
+
+auto PngImage::depth() const noexcept -> uint32_t
+{
+    return 1u;
+}
+
+auto PngImage::mip_levels() const noexcept -> uint32_t
+{
+    return 1u;
+}
+
+auto PngImage::format() const noexcept -> vk::Format
+{
+    return vk::Format::eR8G8B8A8Srgb;
+}
+
+auto PngImage::decode_to(const std::span<std::byte> t_destination) const -> void
+{
+    if (t_destination.size() < size()) {
+        throw std::invalid_argument{ "Image destination is too small" };
+    }
+
+    if (!decode(t_destination)) {
+        throw std::runtime_error{ "Failed to decode PNG image" };
+    }
+}
+
+PngImage::PngImage(
+    std::vector<std::uint8_t>&& t_encoded_data,
+    const uint32_t              t_width,
+    const uint32_t              t_height
+)
+    : m_encoded_data{ std::move(t_encoded_data) },
+      m_width{ t_width },
+      m_height{ t_height }
+{}
+
+auto PngImage::decode(const std::span<std::byte> t_destination) const -> bool
+{
+    const Context context{ create_context(m_encoded_data) };
+    if (context == nullptr) {
+        return false;
+    }
+
+    if (const int error{ spng_decode_image(
+            context.get(),
+            t_destination.data(),
+            size(),
+            SPNG_FMT_RGBA8,
+            SPNG_DECODE_TRNS
+        ) };
+        error != 0)
+    {
+        SPDLOG_ERROR("spng_decode_image failed with '{}'", spng_strerror(error));
+        return false;
+    }
+
+    return true;
+}
+
+}   // namespace core::asset
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Image.hpp"
+
+namespace core::asset {
+
+// Only the headers are read up front, the pixels are decoded by decode_to,
+// which throws if the image data turns out to be corrupt
+class PngImage final : public Image {
+public:
+    [[nodiscard]]
+    static auto load_from_memory(std::span<const std::uint8_t> t_data
+    ) -> std::optional<PngImage>;
+
+    // Decodes into an owned buffer on first access, prefer decode_to.
+    // Throws if the pixel data turns out to be corrupt.
+    [[nodiscard]]
+    auto data() const -> void* override;
+    [[nodiscard]]
+    auto size() const noexcept -> size_t override;
+
+    [[nodiscard]]
+    auto width() const noexcept -> uint32_t override;
+    [[nodiscard]]
+    auto height() const noexcept -> uint32_t override;
+    [[nodiscard]]
+    auto depth() const noexcept -> uint32_t override;
+
+    [[nodiscard]]
+    auto mip_levels() const noexcept -> uint32_t override;
+
+    [[nodiscard]]
+    auto format() const noexcept -> vk::Format override;
+
+    auto decode_to(std::span<std::byte> t_destination) const -> void override;
+
+private:
+    struct DecodedData {
+        std::once_flag                  once_flag;
+        std::unique_ptr<std::uint8_t[]> pixels;
+    };
+
+    std::vector<std::uint8_t>    m_encoded_data;
+    uint32_t                     m_width;
+    uint32_t                     m_height;
+    // Behind a pointer, so that the image stays movable
+    std::unique_ptr<DecodedData> m_decoded_data{ std::make_unique<DecodedData>() };
+
+    explicit PngImage(
+        std::vector<std::uint8_t>&& t_encoded_data,
+        uint32_t                    t_width,
+        uint32_t                    t_height
+    );
+
+    [[nodiscard]]
+    auto decode(std::span<std::byte> t_destination) const -> bool;
+};
+
+}   // namespace core::asset
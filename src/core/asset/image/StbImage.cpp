@@ -5,44 +5,51 @@ namespace core::asset {
 auto StbImage::load_from_file(const std::filesystem::path& t_filepath
 ) -> std::optional<StbImage>
 {
+    const std::unique_ptr<FILE, decltype(&std::fclose)> file{
+        std::fopen(t_filepath.generic_string().c_str(), "rb"), std::fclose
+    };
+    if (file == nullptr) {
+        return std::nullopt;
+    }
+
+    // stbi_info_from_file restores the file position, so the same handle can be reused
     int channels{};
-    if (stbi_info(t_filepath.generic_string().c_str(), nullptr, nullptr, &channels) != 1)
-    {
+    if (stbi_info_from_file(file.get(), nullptr, nullptr, &channels) != 1) {
         return std::nullopt;
     }
 
-    return load_from_file(t_filepath, static_cast<Channels>(channels));
+    return load_from_file(file.get(), static_cast<Channels>(channels));
 }
 
 auto StbImage::load_from_file(
     const std::filesystem::path& t_filepath,
-    Channels                     t_desired_channels
+    const Channels               t_desired_channels
 ) -> std::optional<StbImage>
 {
-    if (stbi_info(t_filepath.generic_string().c_str(), nullptr, nullptr, nullptr) != 1) {
+    const std::unique_ptr<FILE, decltype(&std::fclose)> file{
+        std::fopen(t_filepath.generic_string().c_str(), "rb"), std::fclose
+    };
+    if (file == nullptr) {
         return std::nullopt;
     }
 
-    int      width{};
-    int      height{};
-    stbi_uc* data{ stbi_load(
-        t_filepath.generic_string().c_str(),
-        &width,
-        &height,
-        nullptr,
-        std::to_underlying(t_desired_channels)
-    ) };
-
-    if (data == nullptr) {
-        SPDLOG_ERROR(stbi_failure_reason());
+    if (stbi_info_from_file(file.get(), nullptr, nullptr, nullptr) != 1) {
         return std::nullopt;
     }
 
-    return StbImage{ data, width, height, t_desired_channels };
+    return load_from_file(file.get(), t_desired_channels);
 }
 
 auto StbImage::load_from_memory(std::span<const std::uint8_t> t_data
 ) -> std::optional<StbImage>
+{
+    return load_from_memory(t_data, Channels::eRGBA);
+}
+
+auto StbImage::load_from_memory(
+    std::span<const std::uint8_t> t_data,
+    const Channels                t_desired_channels
+) -> std::optional<StbImage>
 {
     if (stbi_info_from_memory(
             t_data.data(), static_cast<int>(t_data.size()), nullptr, nullptr, nullptr
@@ -54,9 +61,30 @@ auto StbImage::load_from_memory(std::span<const std::uint8_t> t_data
 
     int      width{};
     int      height{};
-    // TODO: request format
     stbi_uc* data{ stbi_load_from_memory(
-        t_data.data(), static_cast<int>(t_data.size()), &width, &height, nullptr, STBI_rgb_alpha
+        t_data.data(),
+        static_cast<int>(t_data.size()),
+        &width,
+        &height,
+        nullptr,
+        std::to_underlying(t_desired_channels)
+    ) };
+
+    if (data == nullptr) {
+        SPDLOG_ERROR(stbi_failure_reason());
+        return std::nullopt;
+    }
+
+    return StbImage{ data, width, height, t_desired_channels };
+}
+
+auto StbImage::load_from_file(FILE* t_file, const Channels t_desired_channels)
+    -> std::optional<StbImage>
+{
+    int      width{};
+    int      height{};
+    stbi_uc* data{ stbi_load_from_file(
+        t_file, &width, &height, nullptr, std::to_underlying(t_desired_channels)
     ) };
 
     if (data == nullptr) {
@@ -64,7 +92,7 @@ auto StbImage::load_from_memory(std::span<const std::uint8_t> t_data
         return std::nullopt;
     }
 
-    return StbImage{ data, width, height, Channels::eRGBA };
+    return StbImage{ data, width, height, t_desired_channels };
 }
 
 auto StbImage::data() const noexcept -> void*
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdio>
 #include <filesystem>
 #include <optional>
 #include <span>
@@ -32,6 +33,12 @@ public:
     static auto load_from_memory(std::span<const std::uint8_t> t_data
     ) -> std::optional<StbImage>;
 
+    [[nodiscard]]
+    static auto load_from_memory(
+        std::span<const std::uint8_t> t_data,
+        Channels                      t_desired_channels
+    ) -> std::optional<StbImage>;
+
     [[nodiscard]]
     auto data() const noexcept -> void* override;
     [[nodiscard]]
@@ -56,6 +63,10 @@ private:
     int                                                  m_height;
     Channels                                             m_channels;
 
+    [[nodiscard]]
+    static auto load_from_file(FILE* t_file, Channels t_desired_channels)
+        -> std::optional<StbImage>;
+
     explicit StbImage(stbi_uc* data, int width, int height, Channels channels) noexcept;
 };
 
@@ -0,0 +1,194 @@
+#include "StreamedKtxImage.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <vulkan/vulkan.hpp>
+
+#include <zstd.h>
+
+constexpr static std::array<std::uint8_t, 12> g_identifier{
+    0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+};
+
+enum class SupercompressionScheme : uint32_t {
+    eNone      = 0,
+    eBasisLZ   = 1,
+    eZstandard = 2,
+    eZLIB      = 3
+};
+
+namespace core::asset {
+
+auto StreamedKtxImage::load_from_file(const std::filesystem::path& t_filepath
+) -> std::optional<StreamedKtxImage>
+{
+    std::ifstream file{ t_filepath, std::ios::binary | std::ios::in };
+
+    Header header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(Header))
+        || header.identifier != g_identifier)
+    {
+        return std::nullopt;
+    }
+
+    // Basis compressed textures need transcoding, so they are left to KtxImage
+    const auto supercompression_scheme{
+        static_cast<SupercompressionScheme>(header.supercompression_scheme)
+    };
+    if (static_cast<vk::Format>(header.vk_format) == vk::Format::eUndefined
+        || (supercompression_scheme != SupercompressionScheme::eNone
+            && supercompression_scheme != SupercompressionScheme::eZstandard))
+    {
+        return std::nullopt;
+    }
+
+    if (header.pixel_depth > 1 || header.layer_count > 1 || header.face_count != 1) {
+        return std::nullopt;
+    }
+
+    // A level count of 0 asks for generated mipmaps, only the base level is stored
+    std::vector<Level> levels(std::max(header.level_count, 1u));
+    if (!file.read(
+            reinterpret_cast<char*>(levels.data()),
+            static_cast<std::streamsize>(std::span{ levels }.size_bytes())
+        ))
+    {
+        SPDLOG_ERROR(
+            "Failed to read the level index of KTX2 file {}", t_filepath.generic_string()
+        );
+        return std::nullopt;
+    }
+
+    return StreamedKtxImage{ t_filepath, header, std::move(levels) };
+}
+
+auto StreamedKtxImage::data() const -> void*
+{
+    // A throwing call leaves the flag unset, so the next call tries again
+    std::call_once(m_loaded_data->once_flag, [this] {
+        auto bytes{ std::make_unique_for_overwrite<std::byte[]>(size()) };
+        decode_to(std::span{ bytes.get(), size() });
+        m_loaded_data->bytes = std::move(bytes);
+    });
+    return m_loaded_data->bytes.get();
+}
+
+auto StreamedKtxImage::size() const noexcept -> size_t
+{
+    size_t size{};
+    for (const Level& level : m_levels) {
+        size += level.uncompressed_byte_length;
+    }
+    return size;
+}
+
+auto StreamedKtxImage::width() const noexcept -> uint32_t
+{
+    return m_header.pixel_width;
+}
+
+auto StreamedKtxImage::height() const noexcept -> uint32_t
+{
+    return std::max(m_header.pixel_height, 1u);
+}
+
+auto StreamedKtxImage::depth() const noexcept -> uint32_t
+{
+    return 1u;
+}
+
+auto StreamedKtxImage::mip_levels() const noexcept -> uint32_t
+{
+    return static_cast<uint32_t>(m_levels.size());
+}
+
+auto StreamedKtxImage::format() const noexcept -> vk::Format
+{
+    return static_cast<vk::Format>(m_header.vk_format);
+}
+
+auto StreamedKtxImage::decode_to(const std::span<std::byte> t_destination) const -> void
+{
+    if (t_destination.size() < size()) {
+        throw std::invalid_argument{ "Image destination is too small" };
+    }
+
+    size_t offset{};
+    for (const uint32_t mip_level : std::views::iota(0u, mip_levels())) {
+        decode_level_to(mip_level, t_destination.subspan(offset));
+        offset += level_size(mip_level);
+    }
+}
+
+auto StreamedKtxImage::level_size(const uint32_t t_mip_level) const -> size_t
+{
+    return m_levels.at(t_mip_level).uncompressed_byte_length;
+}
+
+auto StreamedKtxImage::decode_level_to(
+    const uint32_t             t_mip_level,
+    const std::span<std::byte> t_destination
+) const -> void
+{
+    const Level& level{ m_levels.at(t_mip_level) };
+    if (t_destination.size() < level.uncompressed_byte_length) {
+        throw std::invalid_argument{ "Image destination is too small" };
+    }
+
+    // Each call opens its own stream, so levels can be loaded concurrently
+    std::ifstream file{ m_filepath, std::ios::binary | std::ios::in };
+    file.seekg(static_cast<std::streamoff>(level.byte_offset));
+
+    if (static_cast<SupercompressionScheme>(m_header.supercompression_scheme)
+        != SupercompressionScheme::eZstandard)
+    {
+        if (!file.read(
+                reinterpret_cast<char*>(t_destination.data()),
+                static_cast<std::streamsize>(level.byte_length)
+            ))
+        {
+            throw std::runtime_error{ std::format(
+                "Failed to read mip level {} of {}", t_mip_level, m_filepath.generic_string()
+            ) };
+        }
+        return;
+    }
+
+    std::vector<char> compressed_data(level.byte_length);
+    if (!file.read(
+            compressed_data.data(), static_cast<std::streamsize>(compressed_data.size())
+        ))
+    {
+        throw std::runtime_error{ std::format(
+            "Failed to read mip level {} of {}", t_mip_level, m_filepath.generic_string()
+        ) };
+    }
+
+    if (const size_t result{ ZSTD_decompress(
+            t_destination.data(),
+            level.uncompressed_byte_length,
+            compressed_data.data(),
+            compressed_data.size()
+        ) };
+        ZSTD_isError(result) != 0 || result != level.uncompressed_byte_length)
+    {
+        throw std::runtime_error{ std::format(
+            "Failed to inflate mip level {} of {}: {}",
+            t_mip_level,
+            m_filepath.generic_string(),
+            ZSTD_isError(result) != 0 ? ZSTD_getErrorName(result) : "size mismatch"
+        ) };
+    }
+}
+
+StreamedKtxImage::StreamedKtxImage(
+    std::filesystem::path t_filepath,
+    const Header&         t_header,
+    std::vector<Level>&&  t_levels
+)
+    : m_filepath{ std::move(t_filepath) },
+      m_header{ t_header },
+      m_levels{ std::move(t_levels) }
+{}
+
+}   // namespace core::asset
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Image.hpp"
+
+namespace core::asset {
+
+// Reads only the KTX2 header and level index up front.
+// Mip levels are read (and zstd inflated) one by one on request,
+// which is safe to do from multiple threads at once.
+class StreamedKtxImage final : public Image {
+public:
+    [[nodiscard]]
+    static auto load_from_file(const std::filesystem::path& t_filepath
+    ) -> std::optional<StreamedKtxImage>;
+
+    // Loads every level into an owned buffer on first access, prefer decode_level_to.
+    // Throws if a level cannot be read.
+    [[nodiscard]]
+    auto data() const -> void* override;
+    [[nodiscard]]
+    auto size() const noexcept -> size_t override;
+
+    [[nodiscard]]
+    auto width() const noexcept -> uint32_t override;
+    [[nodiscard]]
+    auto height() const noexcept -> uint32_t override;
+    [[nodiscard]]
+    auto depth() const noexcept -> uint32_t override;
+
+    [[nodiscard]]
+    auto mip_levels() const noexcept -> uint32_t override;
+
+    [[nodiscard]]
+    auto format() const noexcept -> vk::Format override;
+
+    auto decode_to(std::span<std::byte> t_destination) const -> void override;
+
+    [[nodiscard]]
+    auto level_size(uint32_t t_mip_level) const -> size_t override;
+    auto decode_level_to(uint32_t t_mip_level, std::span<std::byte> t_destination) const
+        -> void override;
+
+private:
+    struct Header {
+        std::array<std::uint8_t, 12> identifier;
+        uint32_t                     vk_format;
+        uint32_t                     type_size;
+        uint32_t                     pixel_width;
+        uint32_t                     pixel_height;
+        uint32_t                     pixel_depth;
+        uint32_t                     layer_count;
+        uint32_t                     face_count;
+        uint32_t                     level_count;
+        uint32_t                     supercompression_scheme;
+        uint32_t                     dfd_byte_offset;
+        uint32_t                     dfd_byte_length;
+        uint32_t                     kvd_byte_offset;
+        uint32_t                     kvd_byte_length;
+        uint64_t                     sgd_byte_offset;
+        uint64_t                     sgd_byte_length;
+    };
+
+    struct Level {
+        uint64_t byte_offset;
+        uint64_t byte_length;
+        uint64_t uncompressed_byte_length;
+    };
+
+    struct LoadedData {
+        std::once_flag               once_flag;
+        std::unique_ptr<std::byte[]> bytes;
+    };
+
+    std::filesystem::path       m_filepath;
+    Header                      m_header;
+    std::vector<Level>          m_levels;
+    // Behind a pointer, so that the image stays movable
+    std::unique_ptr<LoadedData> m_loaded_data{ std::make_unique<LoadedData>() };
+
+    explicit StreamedKtxImage(
+        std::filesystem::path t_filepath,
+        const Header&         t_header,
+        std::vector<Level>&&  t_levels
+    );
+};
+
+}   // namespace core::asset
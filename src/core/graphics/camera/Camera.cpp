@@ -61,4 +61,20 @@ auto Camera::projection() const noexcept -> const glm::mat4&
     return m_projection;
 }
 
+auto Camera::frustum_planes() const noexcept -> std::array<glm::vec4, 6>
+{
+    // Gribb-Hartmann, with the 0 to 1 clip depth of Vulkan
+    const glm::mat4 rows{ glm::transpose(m_projection * m_view) };
+
+    std::array<glm::vec4, 6> planes{
+        rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1],
+        rows[3] - rows[1], rows[2],           rows[3] - rows[2],
+    };
+    for (glm::vec4& plane : planes) {
+        plane /= glm::length(glm::vec3{ plane });
+    }
+
+    return planes;
+}
+
 }   // namespace core::graphics
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include <glm/glm.hpp>
 
 namespace core::graphics {
@@ -23,6 +25,10 @@ public:
     auto view() const noexcept -> const glm::mat4&;
     [[nodiscard]]
     auto projection() const noexcept -> const glm::mat4&;
+    // The four side planes, then the near and the far one, in world space,
+    // as normal and distance. Normals are unit length and point inwards.
+    [[nodiscard]]
+    auto frustum_planes() const noexcept -> std::array<glm::vec4, 6>;
 
 private:
     glm::mat4 m_view{ 1.f };
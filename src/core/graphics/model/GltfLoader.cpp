@@ -1,5 +1,6 @@
 #include "GltfLoader.hpp"
 
+#include <algorithm>
 #include <array>
 #include <ranges>
 
@@ -22,6 +23,8 @@ struct GltfModel {
     std::vector<size_t>                root_nodes;
     std::unordered_map<size_t, size_t> node_indices;
     std::vector<Model::Node>           nodes;
+    // Meshes shared by several nodes are loaded once, so they can be instanced
+    std::unordered_map<size_t, size_t> mesh_indices;
 
     std::vector<Model::Vertex> vertices;
     std::vector<uint32_t>      indices;
@@ -40,7 +43,7 @@ struct GltfModel {
 static auto load_asset(const std::filesystem::path& t_filepath
 ) -> fastgltf::Expected<fastgltf::Asset>
 {
-    fastgltf::Parser parser;
+    fastgltf::Parser parser{ fastgltf::Extensions::EXT_mesh_gpu_instancing };
 
     fastgltf::GltfDataBuffer data;
     data.loadFromFile(t_filepath);
@@ -62,6 +65,12 @@ static auto load_node(
     Model::Node*           t_parent
 ) -> void;
 
+[[nodiscard]]
+static auto load_instance_matrices(
+    const fastgltf::Asset& t_asset,
+    const fastgltf::Node&  t_source_node
+) -> std::vector<glm::mat4>;
+
 [[nodiscard]]
 static auto load_mesh(
     internal::GltfModel&   t_loader,
@@ -94,11 +103,23 @@ static auto load_indices(
 
 static auto adjust_node_indices(internal::GltfModel& t_loader) -> void;
 
+static auto load_node_bounds(
+    internal::GltfModel& t_loader,
+    size_t               t_node_index,
+    const glm::mat4&     t_parent_matrix
+) -> void;
+
+[[nodiscard]]
+static auto image_usages(const fastgltf::Asset& t_asset)
+    -> std::vector<ImageLoader::Usage>;
+
 [[nodiscard]]
 static auto load_image(
-    const std::filesystem::path& t_filepath,
-    const fastgltf::Asset&       t_asset,
-    const fastgltf::Image&       t_image
+    const std::filesystem::path&         t_filepath,
+    const fastgltf::Asset&               t_asset,
+    const fastgltf::Image&               t_image,
+    ImageLoader::CompressedImageCacheRef t_compressed_image_cache,
+    ImageLoader::Usage                   t_usage
 ) -> std::optional<Model::Image>;
 
 [[nodiscard]]
@@ -112,7 +133,9 @@ static auto create_material(const fastgltf::Material& material) -> Model::Materi
 
 namespace core::graphics {
 
-auto GltfLoader::load_from_file(const std::filesystem::path& t_filepath
+auto GltfLoader::load_from_file(
+    const std::filesystem::path&  t_filepath,
+    const CompressedImageCacheRef t_compressed_image_cache
 ) -> std::optional<Model>
 {
     auto asset{ load_asset(t_filepath) };
@@ -121,12 +144,18 @@ auto GltfLoader::load_from_file(const std::filesystem::path& t_filepath
         return std::nullopt;
     }
 
-    return load_model(t_filepath, asset.get(), asset->defaultScene.value_or(0));
+    return load_model(
+        t_filepath,
+        asset.get(),
+        asset->defaultScene.value_or(0),
+        t_compressed_image_cache
+    );
 }
 
 auto GltfLoader::load_from_file(
-    const std::filesystem::path& t_filepath,
-    const size_t                 t_scene_id
+    const std::filesystem::path&  t_filepath,
+    const size_t                  t_scene_id,
+    const CompressedImageCacheRef t_compressed_image_cache
 ) -> std::optional<Model>
 {
     auto asset{ load_asset(t_filepath) };
@@ -135,15 +164,16 @@ auto GltfLoader::load_from_file(
         return std::nullopt;
     }
 
-    return load_model(t_filepath, asset.get(), t_scene_id);
+    return load_model(t_filepath, asset.get(), t_scene_id, t_compressed_image_cache);
 }
 
 }   // namespace core::graphics
 
 auto GltfLoader::load_model(
-    const std::filesystem::path& t_filepath,
-    const fastgltf::Asset&       t_asset,
-    size_t                       t_scene_id
+    const std::filesystem::path&  t_filepath,
+    const fastgltf::Asset&        t_asset,
+    const size_t                  t_scene_id,
+    const CompressedImageCacheRef t_compressed_image_cache
 ) -> Model
 {
     // TODO: make this an assertion
@@ -166,10 +196,15 @@ auto GltfLoader::load_model(
         );
     }
     adjust_node_indices(loader);
+    for (const size_t root_node_index : loader.root_nodes) {
+        load_node_bounds(loader, root_node_index, glm::mat4{ 1.f });
+    }
 
+    const std::vector<ImageLoader::Usage> usages{ image_usages(t_asset) };
     loader.images.reserve(t_asset.images.size());
-    for (const fastgltf::Image& image : t_asset.images) {
-        std::optional<Model::Image> loaded_image = load_image(t_filepath, t_asset, image);
+    for (const auto& [image, usage] : std::views::zip(t_asset.images, usages)) {
+        std::optional<Model::Image> loaded_image =
+            load_image(t_filepath, t_asset, image, t_compressed_image_cache, usage);
         if (loaded_image.has_value()) {
             loader.images.push_back(std::move(loaded_image.value()));
         }
@@ -244,8 +279,21 @@ auto load_node(
     t_node.translation = glm::make_vec3(translation.data());
 
     if (t_source_node.meshIndex) {
-        t_node.mesh_index =
-            load_mesh(t_loader, t_asset, t_asset.meshes[*t_source_node.meshIndex]);
+        auto mesh_iter{ t_loader.mesh_indices.find(*t_source_node.meshIndex) };
+        if (mesh_iter == t_loader.mesh_indices.end()) {
+            mesh_iter = t_loader.mesh_indices
+                            .try_emplace(
+                                *t_source_node.meshIndex,
+                                load_mesh(
+                                    t_loader,
+                                    t_asset,
+                                    t_asset.meshes[*t_source_node.meshIndex]
+                                )
+                            )
+                            .first;
+        }
+        t_node.mesh_index        = mesh_iter->second;
+        t_node.instance_matrices = load_instance_matrices(t_asset, t_source_node);
     }
 
     t_node.child_indices.reserve(t_source_node.children.size());
@@ -264,6 +312,60 @@ auto load_node(
     }
 }
 
+auto load_instance_matrices(
+    const fastgltf::Asset& t_asset,
+    const fastgltf::Node&  t_source_node
+) -> std::vector<glm::mat4>
+{
+    size_t instance_count{};
+    for (const auto& [name, accessor_index] : t_source_node.instancingAttributes) {
+        instance_count =
+            std::max(instance_count, t_asset.accessors[accessor_index].count);
+    }
+
+    std::vector<glm::vec3> translations(instance_count, glm::vec3{ 0.f });
+    std::vector<glm::quat> rotations(instance_count, glm::quat{ 1.f, 0.f, 0.f, 0.f });
+    std::vector<glm::vec3> scales(instance_count, glm::vec3{ 1.f });
+    for (const auto& [name, accessor_index] : t_source_node.instancingAttributes) {
+        const fastgltf::Accessor& accessor{ t_asset.accessors[accessor_index] };
+        if (name == "TRANSLATION") {
+            fastgltf::iterateAccessorWithIndex<glm::vec3>(
+                t_asset,
+                accessor,
+                [&translations](const glm::vec3& translation, const size_t index) {
+                    translations[index] = translation;
+                }
+            );
+        }
+        else if (name == "ROTATION") {
+            fastgltf::iterateAccessorWithIndex<glm::vec4>(
+                t_asset,
+                accessor,
+                [&rotations](const glm::vec4& rotation, const size_t index) {
+                    rotations[index] = glm::make_quat(glm::value_ptr(rotation));
+                }
+            );
+        }
+        else if (name == "SCALE") {
+            fastgltf::iterateAccessorWithIndex<glm::vec3>(
+                t_asset,
+                accessor,
+                [&scales](const glm::vec3& scale, const size_t index) {
+                    scales[index] = scale;
+                }
+            );
+        }
+    }
+
+    return std::views::zip(translations, rotations, scales)
+         | std::views::transform([](const auto& instance) {
+               const auto& [translation, rotation, scale]{ instance };
+               return glm::translate(glm::mat4{ 1.f }, translation)
+                    * glm::mat4_cast(rotation) * glm::scale(glm::mat4{ 1.f }, scale);
+           })
+         | std::ranges::to<std::vector>();
+}
+
 auto load_mesh(
     internal::GltfModel&   t_loader,
     const fastgltf::Asset& t_asset,
@@ -326,6 +428,9 @@ auto load_primitive(
     if (!load_vertices(t_loader, primitive, t_asset, t_source_primitive.attributes)) {
         return std::nullopt;
     }
+    primitive.bounds = Model::Bounds::from_vertices(
+        std::span{ t_loader.vertices }.subspan(first_vertex_index, primitive.vertex_count)
+    );
 
     if (auto indices_accessor_index{ t_source_primitive.indicesAccessor }) {
         load_indices(
@@ -490,10 +595,97 @@ auto adjust_node_indices(internal::GltfModel& t_loader) -> void
     }
 }
 
+auto load_node_bounds(
+    internal::GltfModel& t_loader,
+    const size_t         t_node_index,
+    const glm::mat4&     t_parent_matrix
+) -> void
+{
+    const glm::mat4 matrix{ t_parent_matrix
+                            * t_loader.nodes[t_node_index].local_matrix() };
+
+    std::optional<Model::Bounds> bounds;
+    const auto merge{ [&bounds](const Model::Bounds& other) {
+        bounds = bounds.has_value() ? bounds->merged(other) : other;
+    } };
+
+    const Model::Node& node{ t_loader.nodes[t_node_index] };
+    if (node.mesh_index.has_value()) {
+        for (const Model::Mesh::Primitive& primitive :
+             t_loader.meshes[*node.mesh_index].primitives)
+        {
+            if (node.instance_matrices.empty()) {
+                merge(primitive.bounds.transformed(matrix));
+            }
+            for (const glm::mat4& instance_matrix : node.instance_matrices) {
+                merge(primitive.bounds.transformed(matrix * instance_matrix));
+            }
+        }
+    }
+
+    for (const size_t child_index : t_loader.nodes[t_node_index].child_indices) {
+        load_node_bounds(t_loader, child_index, matrix);
+        if (const std::optional<Model::Bounds>& child_bounds{
+                t_loader.nodes[child_index].bounds };
+            child_bounds.has_value())
+        {
+            merge(*child_bounds);
+        }
+    }
+
+    t_loader.nodes[t_node_index].bounds = bounds;
+}
+
+auto image_usages(const fastgltf::Asset& t_asset) -> std::vector<ImageLoader::Usage>
+{
+    using enum ImageLoader::Usage;
+
+    std::vector<std::optional<ImageLoader::Usage>> usages(t_asset.images.size());
+
+    const auto use = [&](const auto& texture_info, const ImageLoader::Usage usage) {
+        if (!texture_info.has_value()) {
+            return;
+        }
+        const fastgltf::Texture& texture{ t_asset.textures[texture_info->textureIndex] };
+        if (!texture.imageIndex.has_value()) {
+            return;
+        }
+
+        std::optional<ImageLoader::Usage>& image_usage{
+            usages[texture.imageIndex.value()]
+        };
+        if (!image_usage.has_value() || image_usage == usage) {
+            image_usage = usage;
+        }
+        // Colors stay sRGB, other shared images
+        // (e.g. packed occlusion-roughness-metallic) keep all of their channels
+        else if (image_usage != eColor) {
+            image_usage = usage == eColor ? eColor : eLinear;
+        }
+    };
+
+    for (const fastgltf::Material& material : t_asset.materials) {
+        use(material.pbrData.baseColorTexture, eColor);
+        use(material.emissiveTexture, eColor);
+        use(material.pbrData.metallicRoughnessTexture, eLinear);
+        // Kept in BC7, as BC5 would leave z to be rebuilt by every shader
+        use(material.normalTexture, eLinear);
+        use(material.occlusionTexture, eSingleChannel);
+    }
+
+    return usages
+         | std::views::transform([](const std::optional<ImageLoader::Usage> usage) {
+               return usage.value_or(eColor);
+           })
+         | std::ranges::to<std::vector>();
+}
+
 auto load_image(
-    const std::filesystem::path& t_filepath,
-    const fastgltf::Asset&       t_asset,
-    const fastgltf::Image&       t_image
+    const std::filesystem::path&               t_filepath,
+    const fastgltf::Asset&                     t_asset,
+    const fastgltf::Image&                     t_image,
+    const ImageLoader::CompressedImageCacheRef t_compressed_image_cache,
+    const ImageLoader::Usage                   t_usage
 ) -> std::optional<Model::Image>
 {
     return std::visit(
@@ -509,18 +701,28 @@ auto load_image(
                 );   // TODO: Support offsets?
                 assert(filepath.uri.isLocalPath());
 
-                return ImageLoader::load_from_file(std::filesystem::absolute(
-                    t_filepath.parent_path() / filepath.uri.fspath()
-                ));
+                return ImageLoader::load_from_file(
+                    std::filesystem::absolute(
+                        t_filepath.parent_path() / filepath.uri.fspath()
+                    ),
+                    t_compressed_image_cache,
+                    t_usage
+                );
             },
             [&](const fastgltf::sources::Array& array) {
                 return ImageLoader::load_from_memory(
-                    std::span{ array.bytes }, array.mimeType
+                    std::span{ array.bytes },
+                    array.mimeType,
+                    t_compressed_image_cache,
+                    t_usage
                 );
             },
             [&](const fastgltf::sources::Vector& vector) {
                 return ImageLoader::load_from_memory(
-                    std::span{ vector.bytes }, vector.mimeType
+                    std::span{ vector.bytes },
+                    vector.mimeType,
+                    t_compressed_image_cache,
+                    t_usage
                 );
             },
             [&](const fastgltf::sources::BufferView& buffer_view) {
@@ -538,15 +740,19 @@ auto load_image(
                         [&](const fastgltf::sources::Array& array) {
                             return ImageLoader::load_from_memory(
                                 std::span(array.bytes.data(), array.bytes.size())
-                                    .subspan(view.byteOffset),
-                                buffer_view.mimeType
+                                    .subspan(view.byteOffset, view.byteLength),
+                                buffer_view.mimeType,
+                                t_compressed_image_cache,
+                                t_usage
                             );
                         },
                         [&](const fastgltf::sources::Vector& vector) {
                             return ImageLoader::load_from_memory(
                                 std::span(vector.bytes.data(), vector.bytes.size())
-                                    .subspan(view.byteOffset),
-                                buffer_view.mimeType
+                                    .subspan(view.byteOffset, view.byteLength),
+                                buffer_view.mimeType,
+                                t_compressed_image_cache,
+                                t_usage
                             );
                         } },
                     buffer.data
@@ -2,26 +2,35 @@
 
 #include <filesystem>
 
+#include "ImageLoader.hpp"
 #include "Model.hpp"
 
 namespace core::graphics {
 
 class GltfLoader {
 public:
+    using CompressedImageCacheRef = ImageLoader::CompressedImageCacheRef;
+
     [[nodiscard]]
-    static auto load_from_file(const std::filesystem::path& t_filepath
+    static auto load_from_file(
+        const std::filesystem::path& t_filepath,
+        CompressedImageCacheRef      t_compressed_image_cache = {}
     ) -> std::optional<Model>;
 
     [[nodiscard]]
-    static auto load_from_file(const std::filesystem::path& t_filepath, size_t t_scene_id)
-        -> std::optional<Model>;
+    static auto load_from_file(
+        const std::filesystem::path& t_filepath,
+        size_t                       t_scene_id,
+        CompressedImageCacheRef      t_compressed_image_cache = {}
+    ) -> std::optional<Model>;
 
 private:
     [[nodiscard]]
     static auto load_model(
         const std::filesystem::path& t_filepath,
         const fastgltf::Asset&       t_asset,
-        size_t                       t_scene_id
+        size_t                       t_scene_id,
+        CompressedImageCacheRef      t_compressed_image_cache
     ) -> Model;
 };
 
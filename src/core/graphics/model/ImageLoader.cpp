@@ -1,51 +1,169 @@
 #include "ImageLoader.hpp"
 
+#include <array>
+
+#include "core/asset/image/JpegImage.hpp"
 #include "core/asset/image/KtxImage.hpp"
+#include "core/asset/image/PngImage.hpp"
 #include "core/asset/image/StbImage.hpp"
+#include "core/asset/image/StreamedKtxImage.hpp"
+
+using namespace core;
+using namespace core::graphics;
+
+template <size_t N>
+[[nodiscard]]
+static auto starts_with(
+    const std::span<const std::uint8_t> t_data,
+    const std::array<std::uint8_t, N>&  t_signature
+) noexcept -> bool
+{
+    return t_data.size() >= N && std::ranges::equal(t_data.first(N), t_signature);
+}
+
+[[nodiscard]]
+static auto sniff_mime_type(const std::span<const std::uint8_t> t_data) noexcept
+    -> fastgltf::MimeType
+{
+    constexpr static std::array<std::uint8_t, 8> png_signature{
+        0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A
+    };
+    constexpr static std::array<std::uint8_t, 3>  jpeg_signature{ 0xFF, 0xD8, 0xFF };
+    constexpr static std::array<std::uint8_t, 12> ktx2_signature{
+        0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+    };
+
+    if (starts_with(t_data, png_signature)) {
+        return fastgltf::MimeType::PNG;
+    }
+    if (starts_with(t_data, jpeg_signature)) {
+        return fastgltf::MimeType::JPEG;
+    }
+    if (starts_with(t_data, ktx2_signature)) {
+        return fastgltf::MimeType::KTX2;
+    }
+    return fastgltf::MimeType::None;
+}
+
+template <typename ImageType>
+[[nodiscard]]
+static auto to_model_image(ImageType&& t_image) -> Model::Image
+{
+    return std::make_unique<std::remove_cvref_t<ImageType>>(
+        std::forward<ImageType>(t_image)
+    );
+}
+
+[[nodiscard]]
+static auto load_compressed(
+    const std::span<const std::uint8_t>        t_data,
+    const ImageLoader::CompressedImageCacheRef t_compressed_image_cache,
+    const ImageLoader::Usage                   t_usage
+) -> std::optional<Model::Image>
+{
+    if (!t_compressed_image_cache.has_value()) {
+        return std::nullopt;
+    }
+
+    return t_compressed_image_cache->get()
+        .load_from_memory(t_data, t_usage)
+        .transform(to_model_image<asset::KtxImage>);
+}
 
 namespace core::graphics {
 
-auto ImageLoader::load_from_file(const std::filesystem::path& t_filepath
+auto ImageLoader::load_from_file(
+    const std::filesystem::path&  t_filepath,
+    const CompressedImageCacheRef t_compressed_image_cache,
+    const Usage                   t_usage
 ) -> std::optional<Model::Image>
 {
-    return asset::StbImage::load_from_file(t_filepath)
-        .transform([](asset::StbImage image) -> Model::Image {
-            return std::make_unique<asset::StbImage>(std::move(image));
-        })
-        .or_else([&t_filepath] {
-            return asset::KtxImage::load_from_file(t_filepath)
-                .transform([](asset::KtxImage image) -> Model::Image {
-                    return std::make_unique<asset::KtxImage>(std::move(image));
-                });
-        });
+    // The file is read exactly once, the decoder is picked based on its contents
+    std::ifstream file{ t_filepath, std::ios::binary | std::ios::in | std::ios::ate };
+
+    const std::streamsize file_size = file.tellg();
+    if (file_size == -1) {
+        SPDLOG_ERROR("Failed to read image file {}", t_filepath.generic_string());
+        return std::nullopt;
+    }
+
+    file.seekg(0, std::ios::beg);
+
+    // KTX2 files are streamed level by level instead of being read as a whole
+    std::array<std::uint8_t, 12> signature{};
+    const size_t                 peeked_size{
+        std::min(static_cast<size_t>(file_size), signature.size())
+    };
+    file.read(
+        reinterpret_cast<char*>(signature.data()), static_cast<std::streamsize>(peeked_size)
+    );
+    if (sniff_mime_type(std::span{ signature }.first(peeked_size))
+        == fastgltf::MimeType::KTX2)
+    {
+        file.close();
+        if (std::optional<asset::StreamedKtxImage> image{
+                asset::StreamedKtxImage::load_from_file(t_filepath) };
+            image.has_value())
+        {
+            return to_model_image(std::move(image.value()));
+        }
+        return asset::KtxImage::load_from_file(t_filepath).transform(
+            to_model_image<asset::KtxImage>
+        );
+    }
+
+    std::vector<std::uint8_t> data(static_cast<size_t>(file_size));
+    std::ranges::copy_n(
+        signature.begin(), static_cast<std::ptrdiff_t>(peeked_size), data.begin()
+    );
+    file.read(
+        reinterpret_cast<char*>(data.data() + peeked_size),
+        file_size - static_cast<std::streamsize>(peeked_size)
+    );
+
+    return load_from_memory(
+        data, fastgltf::MimeType::None, t_compressed_image_cache, t_usage
+    );
 }
 
 auto ImageLoader::load_from_memory(
     const std::span<const std::uint8_t> t_data,
-    fastgltf::MimeType                  t_mime_type
+    const fastgltf::MimeType            t_mime_type,
+    const CompressedImageCacheRef       t_compressed_image_cache,
+    const Usage                         t_usage
 ) -> std::optional<Model::Image>
 {
-    switch (t_mime_type) {
-        case fastgltf::MimeType::PNG: [[fallthrough]];
+    const fastgltf::MimeType sniffed_mime_type{ sniff_mime_type(t_data) };
+
+    switch (sniffed_mime_type != fastgltf::MimeType::None ? sniffed_mime_type
+                                                           : t_mime_type)
+    {
         case fastgltf::MimeType::JPEG: {
-            return asset::StbImage::load_from_memory(t_data).transform([](auto image) {
-                return std::make_unique<asset::StbImage>(
-                    std::forward<decltype(image)>(image)
-                );
-            });
+            return load_compressed(t_data, t_compressed_image_cache, t_usage)
+                .or_else([t_data] {
+                    return asset::JpegImage::load_from_memory(t_data).transform(
+                        to_model_image<asset::JpegImage>
+                    );
+                });
+        }
+        case fastgltf::MimeType::PNG: {
+            return load_compressed(t_data, t_compressed_image_cache, t_usage)
+                .or_else([t_data] {
+                    return asset::PngImage::load_from_memory(t_data).transform(
+                        to_model_image<asset::PngImage>
+                    );
+                });
         }
         case fastgltf::MimeType::KTX2: {
-            return asset::KtxImage::load_from_memory(t_data).transform([](auto image) {
-                return std::make_unique<asset::KtxImage>(
-                    std::forward<decltype(image)>(image)
-                );
-            });
+            return asset::KtxImage::load_from_memory(t_data).transform(
+                to_model_image<asset::KtxImage>
+            );
         }
         default: {
-            throw std::runtime_error(fmt::format(
-                "Unsupported mime type for loading images: {}",
-                fastgltf::to_underlying(t_mime_type)
-            ));
+            // Formats without a dedicated decoder (BMP, TGA, ...) are left to stb
+            return asset::StbImage::load_from_memory(t_data).transform(
+                to_model_image<asset::StbImage>
+            );
         }
     }
 }
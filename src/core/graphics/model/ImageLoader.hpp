@@ -6,6 +6,7 @@
 
 #include <fastgltf/core.hpp>
 
+#include "core/asset/image/CompressedImageCache.hpp"
 #include "core/cache/Cache.hpp"
 #include "core/cache/Handle.hpp"
 
@@ -15,14 +16,23 @@ namespace core::graphics {
 
 class ImageLoader {
 public:
+    using CompressedImageCacheRef =
+        std::optional<std::reference_wrapper<const asset::CompressedImageCache>>;
+    using Usage = asset::CompressedImageCache::Usage;
+
     [[nodiscard]]
-    static auto load_from_file(const std::filesystem::path& t_filepath
+    static auto load_from_file(
+        const std::filesystem::path& t_filepath,
+        CompressedImageCacheRef      t_compressed_image_cache = {},
+        Usage                        t_usage                  = Usage::eColor
     ) -> std::optional<Model::Image>;
 
     [[nodiscard]]
     static auto load_from_memory(
         std::span<const std::uint8_t> t_data,
-        fastgltf::MimeType            t_mime_type
+        fastgltf::MimeType            t_mime_type,
+        CompressedImageCacheRef       t_compressed_image_cache = {},
+        Usage                         t_usage                  = Usage::eColor
     ) -> std::optional<Model::Image>;
 };
 
@@ -1,11 +1,84 @@
 #include "Model.hpp"
 
+#include <algorithm>
+#include <array>
+#include <ranges>
+
 #include <glm/gtc/quaternion.hpp>
 
 #include "core/utility/hashing.hpp"
 
 namespace core::graphics {
 
+auto Model::Bounds::from_vertices(const std::span<const Vertex> t_vertices) -> Bounds
+{
+    if (t_vertices.empty()) {
+        return Bounds{};
+    }
+
+    Bounds bounds{ .min = glm::vec3{ t_vertices.front().position },
+                   .max = glm::vec3{ t_vertices.front().position } };
+    for (const Vertex& vertex : t_vertices) {
+        bounds.min = glm::min(bounds.min, glm::vec3{ vertex.position });
+        bounds.max = glm::max(bounds.max, glm::vec3{ vertex.position });
+    }
+
+    // Centered on the box, which is tighter than the half diagonal for most meshes
+    bounds.center = (bounds.min + bounds.max) / 2.f;
+    for (const Vertex& vertex : t_vertices) {
+        bounds.radius = std::max(
+            bounds.radius, glm::distance(bounds.center, glm::vec3{ vertex.position })
+        );
+    }
+
+    return bounds;
+}
+
+auto Model::Bounds::transformed(const glm::mat4& t_transform) const -> Bounds
+{
+    std::array<glm::vec3, 8> corners{};
+    for (const auto& [corner, corner_index] :
+         std::views::zip(corners, std::views::iota(0u, corners.size())))
+    {
+        const glm::vec3 point{
+            (corner_index & 1u) != 0 ? max.x : min.x,
+            (corner_index & 2u) != 0 ? max.y : min.y,
+            (corner_index & 4u) != 0 ? max.z : min.z,
+        };
+        corner = glm::vec3{ t_transform * glm::vec4{ point, 1 } };
+    }
+
+    Bounds result{ .min = corners.front(), .max = corners.front() };
+    for (const glm::vec3& corner : corners) {
+        result.min = glm::min(result.min, corner);
+        result.max = glm::max(result.max, corner);
+    }
+
+    const float scale{ std::max({ glm::length(glm::vec3{ t_transform[0] }),
+                                  glm::length(glm::vec3{ t_transform[1] }),
+                                  glm::length(glm::vec3{ t_transform[2] }) }) };
+    result.center = glm::vec3{ t_transform * glm::vec4{ center, 1 } };
+    result.radius = radius * scale;
+
+    return result;
+}
+
+auto Model::Bounds::merged(const Bounds& t_other) const -> Bounds
+{
+    Bounds result{
+        .min = glm::min(min, t_other.min),
+        .max = glm::max(max, t_other.max),
+    };
+
+    result.center = (result.min + result.max) / 2.f;
+    result.radius = std::max(
+        glm::distance(result.center, center) + radius,
+        glm::distance(result.center, t_other.center) + t_other.radius
+    );
+
+    return result;
+}
+
 auto Model::Node::local_matrix() const -> glm::mat4
 {
     return glm::translate(glm::mat4(1.f), translation) * glm::mat4_cast(rotation)
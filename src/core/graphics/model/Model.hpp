@@ -3,6 +3,7 @@
 #include <filesystem>
 #include <memory>
 #include <optional>
+#include <span>
 #include <vector>
 
 #include <glm/glm.hpp>
@@ -29,6 +30,23 @@ public:
 
     using Image = std::unique_ptr<asset::Image>;
 
+    // Axis-aligned box and a sphere around the same geometry
+    struct Bounds {
+        glm::vec3 min{};
+        glm::vec3 max{};
+        glm::vec3 center{};
+        float     radius{};
+
+        [[nodiscard]]
+        static auto from_vertices(std::span<const Vertex> t_vertices) -> Bounds;
+
+        // Both the box and the sphere grow to enclose the transformed ones
+        [[nodiscard]]
+        auto transformed(const glm::mat4& t_transform) const -> Bounds;
+        [[nodiscard]]
+        auto merged(const Bounds& t_other) const -> Bounds;
+    };
+
     struct Sampler {
         enum class MagFilter {
             eNearest,
@@ -119,18 +137,26 @@ public:
             uint32_t                first_index_index;
             uint32_t                index_count;
             uint32_t                vertex_count;
+            // In the space of the mesh
+            Bounds                  bounds;
         };
 
         std::vector<Primitive> primitives;
     };
 
     struct Node {
-        Node*                 parent;
-        glm::vec3             translation;
-        glm::quat             rotation;
-        glm::vec3             scale;
-        std::optional<size_t> mesh_index;
-        std::vector<size_t>   child_indices;
+        Node*                  parent;
+        glm::vec3              translation;
+        glm::quat              rotation;
+        glm::vec3              scale;
+        std::optional<size_t>  mesh_index;
+        // Of the EXT_mesh_gpu_instancing copies of the mesh, applied before matrix().
+        // Empty if the mesh is drawn once.
+        std::vector<glm::mat4> instance_matrices;
+        std::vector<size_t>    child_indices;
+        // In the space of the model, around the mesh and every descendant.
+        // Empty if none of them has a mesh.
+        std::optional<Bounds>  bounds;
 
         [[nodiscard]]
         auto local_matrix() const -> glm::mat4;
@@ -1,12 +1,14 @@
 #include "Allocator.hpp"
 
 #include <array>
+#include <ranges>
 
 #include <spdlog/spdlog.h>
 
 #include "core/config/vulkan.hpp"
 #include "core/renderer/base/device/Device.hpp"
 #include "core/renderer/base/instance/Instance.hpp"
+#include "core/renderer/memory/AllocationRecord.hpp"
 
 using namespace core::renderer;
 
@@ -160,7 +162,8 @@ static auto create_buffer_with_alignment(
 namespace core::renderer {
 
 Allocator::Allocator(const Instance& t_instance, const Device& t_device)
-    : m_allocator{ create_allocator(t_instance, t_device) }
+    : m_allocator{ create_allocator(t_instance, t_device) },
+      m_category_totals{ std::make_unique<MemoryCategoryTotals>() }
 {}
 
 auto Allocator::operator*() const noexcept -> VmaAllocator
@@ -187,9 +190,25 @@ auto Allocator::allocate_buffer(
         ::create_buffer(m_allocator.get(), t_buffer_create_info, t_allocation_create_info)
     };
 
+    track(allocation, t_buffer_create_info);
+
     return Buffer{ buffer, allocation, m_allocator.get() };
 }
 
+auto Allocator::allocate_buffer(
+    const vk::BufferCreateInfo& t_buffer_create_info,
+    const MemoryUsage           t_memory_usage
+) const -> MappedBuffer
+{
+    auto [buffer, allocation, _]{ ::create_buffer(
+        m_allocator.get(), t_buffer_create_info, allocation_create_info(t_memory_usage)
+    ) };
+
+    track(allocation, t_buffer_create_info);
+
+    return MappedBuffer{ buffer, allocation, m_allocator.get() };
+}
+
 auto Allocator::allocate_buffer_with_alignment(
     const vk::BufferCreateInfo&    t_buffer_create_info,
     const vk::DeviceSize           t_min_alignment,
@@ -200,6 +219,8 @@ auto Allocator::allocate_buffer_with_alignment(
         m_allocator.get(), t_buffer_create_info, t_min_alignment, t_allocation_create_info
     ) };
 
+    track(allocation, t_buffer_create_info);
+
     return Buffer{ buffer, allocation, m_allocator.get() };
 }
 
@@ -216,6 +237,8 @@ auto Allocator::allocate_mapped_buffer(const vk::BufferCreateInfo& t_buffer_crea
         ::create_buffer(m_allocator.get(), t_buffer_create_info, allocation_create_info)
     };
 
+    track(allocation, t_buffer_create_info);
+
     return MappedBuffer{ buffer, allocation, m_allocator.get() };
 }
 
@@ -234,6 +257,8 @@ auto Allocator::allocate_mapped_buffer_with_alignment(
         m_allocator.get(), t_buffer_create_info, t_min_alignment, allocation_create_info
     ) };
 
+    track(allocation, t_buffer_create_info);
+
     return MappedBuffer{ buffer, allocation, m_allocator.get() };
 }
 
@@ -267,6 +292,8 @@ auto Allocator::allocate_mapped_buffer(
         vk::resultCheck(result, "vmaFlushAllocation failed");
     }
 
+    track(allocation, t_buffer_create_info);
+
     return MappedBuffer{ buffer, allocation, m_allocator.get() };
 }
 
@@ -301,6 +328,8 @@ auto Allocator::allocate_mapped_buffer_with_alignment(
         vk::resultCheck(result, "vmaFlushAllocation failed");
     }
 
+    track(allocation, t_buffer_create_info);
+
     return MappedBuffer{ buffer, allocation, m_allocator.get() };
 }
 
@@ -321,7 +350,118 @@ auto Allocator::allocate_image(
     ) };
     vk::resultCheck(result, "vmaCreateImage failed");
 
+    track(allocation, t_image_create_info);
+
     return renderer::Image(image, allocation, m_allocator.get());
 }
 
+auto Allocator::set_current_frame_index(const uint32_t t_frame_index) const -> void
+{
+    vmaSetCurrentFrameIndex(m_allocator.get(), t_frame_index);
+}
+
+auto Allocator::heap_budgets() const -> std::vector<HeapBudget>
+{
+    const VkPhysicalDeviceMemoryProperties* memory_properties{};
+    vmaGetMemoryProperties(m_allocator.get(), &memory_properties);
+
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+    vmaGetHeapBudgets(m_allocator.get(), budgets.data());
+
+    return budgets | std::views::take(memory_properties->memoryHeapCount)
+         | std::views::transform([](const VmaBudget& budget) {
+               return HeapBudget{
+                   .usage            = budget.usage,
+                   .budget           = budget.budget,
+                   .block_bytes      = budget.statistics.blockBytes,
+                   .allocation_bytes = budget.statistics.allocationBytes,
+                   .allocation_count = budget.statistics.allocationCount,
+               };
+           })
+         | std::ranges::to<std::vector>();
+}
+
+auto Allocator::category_totals() const noexcept -> CategoryTotals
+{
+    CategoryTotals result{};
+    for (const size_t index : std::views::iota(size_t{}, g_memory_category_count)) {
+        result[index] = m_category_totals->get(static_cast<MemoryCategory>(index));
+    }
+    return result;
+}
+
+auto Allocator::build_stats_string(const bool t_detailed_map) const -> std::string
+{
+    char* stats_string{};
+    vmaBuildStatsString(m_allocator.get(), &stats_string, t_detailed_map);
+    std::string result{ stats_string };
+    vmaFreeStatsString(m_allocator.get(), stats_string);
+    return result;
+}
+
+auto Allocator::log_statistics() const -> void
+{
+    const std::vector<HeapBudget> budgets{ heap_budgets() };
+    for (const auto& [heap_budget, heap_index] :
+         std::views::zip(budgets, std::views::iota(0u, budgets.size())))
+    {
+        SPDLOG_INFO(
+            "Memory heap {}: {} / {} MiB used, {} MiB in {} allocations of this "
+            "allocator",
+            heap_index,
+            heap_budget.usage >> 20,
+            heap_budget.budget >> 20,
+            heap_budget.allocation_bytes >> 20,
+            heap_budget.allocation_count
+        );
+    }
+
+    const CategoryTotals totals{ category_totals() };
+    for (const size_t index : std::views::iota(size_t{}, g_memory_category_count)) {
+        SPDLOG_INFO(
+            "Memory category {}: {} KiB",
+            to_string(static_cast<MemoryCategory>(index)),
+            totals[index] >> 10
+        );
+    }
+}
+
+auto Allocator::track(
+    const VmaAllocation         t_allocation,
+    const vk::BufferCreateInfo& t_buffer_create_info
+) const -> void
+{
+    std::atomic<vk::DeviceSize>& category_counter{ m_category_totals->track(
+        m_allocator.get(), t_allocation, memory_category(t_buffer_create_info.usage)
+    ) };
+
+    AllocationRecord::create(
+        m_allocator.get(),
+        t_allocation,
+        AllocationRecord{
+            .category_counter = &category_counter,
+            .create_info      = t_buffer_create_info,
+        }
+    );
+}
+
+auto Allocator::track(
+    const VmaAllocation        t_allocation,
+    const vk::ImageCreateInfo& t_image_create_info
+) const -> void
+{
+    std::atomic<vk::DeviceSize>& category_counter{ m_category_totals->track(
+        m_allocator.get(), t_allocation, memory_category(t_image_create_info.usage)
+    ) };
+
+    AllocationRecord::create(
+        m_allocator.get(),
+        t_allocation,
+        AllocationRecord{
+            .category_counter = &category_counter,
+            .create_info      = t_image_create_info,
+        }
+    );
+}
+
 }   // namespace core::renderer
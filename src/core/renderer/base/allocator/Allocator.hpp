@@ -1,8 +1,11 @@
 #pragma once
 
+#include <array>
+#include <memory>
 #include <optional>
 #include <span>
 #include <string>
+#include <vector>
 
 #include <gsl/pointers>
 
@@ -15,6 +18,8 @@
 #include "core/renderer/memory/Buffer.hpp"
 #include "core/renderer/memory/Image.hpp"
 #include "core/renderer/memory/MappedBuffer.hpp"
+#include "core/renderer/memory/MemoryCategory.hpp"
+#include "core/renderer/memory/MemoryUsage.hpp"
 #include "core/renderer/wrappers/vma/Allocator.hpp"
 
 namespace core::renderer {
@@ -26,6 +31,21 @@ class Allocator {
 public:
     class Requirements;
 
+    ///------------------///
+    ///  Nested classes  ///
+    ///------------------///
+    struct HeapBudget {
+        // Usage and budget of the whole process, as reported by VK_EXT_memory_budget
+        vk::DeviceSize usage;
+        vk::DeviceSize budget;
+        // Memory of this allocator
+        vk::DeviceSize block_bytes;
+        vk::DeviceSize allocation_bytes;
+        uint32_t       allocation_count;
+    };
+
+    using CategoryTotals = std::array<vk::DeviceSize, g_memory_category_count>;
+
     ///------------------------------///
     ///  Constructors / Destructors  ///
     ///------------------------------///
@@ -53,6 +73,13 @@ public:
         }
     ) const -> Buffer;
 
+    // Mapped if the memory ended up host-visible, MappedBuffer::data() is null otherwise
+    [[nodiscard]]
+    auto allocate_buffer(
+        const vk::BufferCreateInfo& t_buffer_create_info,
+        MemoryUsage                 t_memory_usage
+    ) const -> MappedBuffer;
+
     [[nodiscard]]
     auto allocate_buffer_with_alignment(
          const vk::BufferCreateInfo&    t_buffer_create_info,
@@ -91,11 +118,38 @@ public:
         const VmaAllocationCreateInfo& t_allocation_create_info
     ) const -> Image;
 
+    // Budgets are refreshed when the frame index changes
+    auto set_current_frame_index(uint32_t t_frame_index) const -> void;
+
+    [[nodiscard]]
+    auto heap_budgets() const -> std::vector<HeapBudget>;
+    // Bytes of the live allocations in each category, indexed by MemoryCategory
+    [[nodiscard]]
+    auto category_totals() const noexcept -> CategoryTotals;
+    // JSON, as built by vmaBuildStatsString
+    [[nodiscard]]
+    auto build_stats_string(bool t_detailed_map = false) const -> std::string;
+
+    auto log_statistics() const -> void;
+
 private:
     ///*************///
     ///  Variables  ///
     ///*************///
     vma::Allocator m_allocator;
+    // Heap allocated, so that allocations can keep pointing to it after a move
+    std::unique_ptr<MemoryCategoryTotals> m_category_totals;
+
+    ///***********///
+    ///  Methods  ///
+    ///***********///
+    // Attaches an AllocationRecord to the allocation
+    auto track(
+        VmaAllocation               t_allocation,
+        const vk::BufferCreateInfo& t_buffer_create_info
+    ) const -> void;
+    auto track(VmaAllocation t_allocation, const vk::ImageCreateInfo& t_image_create_info)
+        const -> void;
 };
 
 }   // namespace core::renderer
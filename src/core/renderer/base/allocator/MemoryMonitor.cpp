@@ -0,0 +1,52 @@
+#include "MemoryMonitor.hpp"
+
+#include <ranges>
+
+#include <spdlog/spdlog.h>
+
+#include "Allocator.hpp"
+
+namespace core::renderer {
+
+MemoryMonitor::MemoryMonitor(
+    const Allocator&                          t_allocator,
+    const std::chrono::steady_clock::duration t_report_interval,
+    const double                              t_warning_ratio
+)
+    : m_allocator{ t_allocator },
+      m_report_interval{ t_report_interval },
+      m_warning_ratio{ t_warning_ratio },
+      m_last_report{ std::chrono::steady_clock::now() }
+{}
+
+auto MemoryMonitor::update() -> void
+{
+    m_allocator.get().set_current_frame_index(++m_frame_index);
+
+    const std::vector<Allocator::HeapBudget> budgets{ m_allocator.get().heap_budgets() };
+    m_warned_heaps.resize(budgets.size());
+    for (const auto& [budget, heap_index] :
+         std::views::zip(budgets, std::views::iota(0u, budgets.size())))
+    {
+        const bool near_budget{ static_cast<double>(budget.usage)
+                                > static_cast<double>(budget.budget) * m_warning_ratio };
+        if (near_budget && !m_warned_heaps[heap_index]) {
+            SPDLOG_WARN(
+                "Memory heap {} is near its budget: {} / {} MiB used",
+                heap_index,
+                budget.usage >> 20,
+                budget.budget >> 20
+            );
+        }
+        m_warned_heaps[heap_index] = near_budget;
+    }
+
+    if (const auto now{ std::chrono::steady_clock::now() };
+        now - m_last_report >= m_report_interval)
+    {
+        m_allocator.get().log_statistics();
+        m_last_report = now;
+    }
+}
+
+}   // namespace core::renderer
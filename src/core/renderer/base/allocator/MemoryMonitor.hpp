@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace core::renderer {
+
+class Allocator;
+
+// Logs the statistics of an allocator on a timer,
+// and warns when the usage of a memory heap gets close to its budget
+class MemoryMonitor {
+public:
+    constexpr static std::chrono::seconds s_default_report_interval{ 10 };
+    constexpr static double               s_default_warning_ratio{ 0.9 };
+
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    explicit MemoryMonitor(
+        const Allocator&                    t_allocator,
+        std::chrono::steady_clock::duration t_report_interval = s_default_report_interval,
+        double                              t_warning_ratio   = s_default_warning_ratio
+    );
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    // Call it once every frame, it also advances the frame index of the allocator
+    auto update() -> void;
+
+private:
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    std::reference_wrapper<const Allocator> m_allocator;
+    std::chrono::steady_clock::duration     m_report_interval;
+    double                                  m_warning_ratio;
+    uint32_t                                m_frame_index{};
+    std::chrono::steady_clock::time_point   m_last_report;
+    // Heaps are only warned about again after dropping below the ratio
+    std::vector<bool> m_warned_heaps;
+};
+
+}   // namespace core::renderer
@@ -0,0 +1,165 @@
+#include "PipelineCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "core/renderer/base/device/Device.hpp"
+
+using namespace core::renderer;
+
+// Written in front of the data of the driver.
+// The driver version is not part of the header of Vulkan.
+struct FileHeader {
+    uint32_t magic;
+    uint32_t driver_version;
+    uint64_t data_size;
+};
+
+constexpr static uint32_t g_magic{ 0x4843'5050 };   // "PPCH"
+
+[[nodiscard]]
+static auto read_file(const std::filesystem::path& t_filepath) -> std::vector<std::byte>
+{
+    std::ifstream file{ t_filepath, std::ios::binary | std::ios::in | std::ios::ate };
+
+    const std::streamsize file_size = file.tellg();
+    if (file_size <= 0) {
+        return {};
+    }
+
+    std::vector<std::byte> buffer(static_cast<size_t>(file_size));
+
+    file.seekg(0, std::ios::beg);
+    file.read(reinterpret_cast<char*>(buffer.data()), file_size);
+    if (!file) {
+        return {};
+    }
+
+    return buffer;
+}
+
+// The data of the driver, or empty if it is not meant for this device
+[[nodiscard]]
+static auto validated_data(
+    const std::span<const std::byte>    t_file,
+    const vk::PhysicalDeviceProperties& t_properties
+) -> std::span<const std::byte>
+{
+    FileHeader file_header{};
+    if (t_file.size() < sizeof(FileHeader)) {
+        return {};
+    }
+    std::memcpy(&file_header, t_file.data(), sizeof(FileHeader));
+
+    const std::span<const std::byte> data{ t_file.subspan(sizeof(FileHeader)) };
+    if (file_header.magic != g_magic
+        || file_header.driver_version != t_properties.driverVersion
+        || file_header.data_size != data.size())
+    {
+        return {};
+    }
+
+    VkPipelineCacheHeaderVersionOne header{};
+    if (data.size() < sizeof(VkPipelineCacheHeaderVersionOne)) {
+        return {};
+    }
+    std::memcpy(&header, data.data(), sizeof(VkPipelineCacheHeaderVersionOne));
+
+    if (header.headerSize < sizeof(VkPipelineCacheHeaderVersionOne)
+        || header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+        || header.vendorID != t_properties.vendorID
+        || header.deviceID != t_properties.deviceID
+        || !std::ranges::equal(header.pipelineCacheUUID, t_properties.pipelineCacheUUID))
+    {
+        return {};
+    }
+
+    return data;
+}
+
+namespace core::renderer {
+
+PipelineCache::PipelineCache(const Device& t_device, std::filesystem::path t_filepath)
+    : m_properties{ t_device.physical_device().getProperties() },
+      m_filepath{ std::move(t_filepath) }
+{
+    const std::vector<std::byte>     file{ read_file(m_filepath) };
+    const std::span<const std::byte> data{ validated_data(file, m_properties) };
+    if (!file.empty() && data.empty()) {
+        SPDLOG_WARN(
+            "Pipeline cache {} was written by another device or driver, starting empty",
+            m_filepath.string()
+        );
+    }
+
+    m_pipeline_cache = t_device->createPipelineCacheUnique(vk::PipelineCacheCreateInfo{
+        .initialDataSize = data.size(),
+        .pInitialData    = data.data(),
+    });
+}
+
+PipelineCache::~PipelineCache() noexcept
+{
+    if (!m_pipeline_cache) {
+        return;
+    }
+
+    try {
+        save();
+    } catch (const std::exception& t_error) {
+        SPDLOG_ERROR(t_error.what());
+    }
+}
+
+auto PipelineCache::operator*() const noexcept -> vk::PipelineCache
+{
+    return m_pipeline_cache.get();
+}
+
+auto PipelineCache::get() const noexcept -> vk::PipelineCache
+{
+    return m_pipeline_cache.get();
+}
+
+auto PipelineCache::save() const -> bool
+{
+    const std::vector<uint8_t> data{
+        m_pipeline_cache.getOwner().getPipelineCacheData(m_pipeline_cache.get())
+    };
+    const FileHeader file_header{
+        .magic          = g_magic,
+        .driver_version = m_properties.driverVersion,
+        .data_size      = data.size(),
+    };
+
+    std::filesystem::path temp_filepath{ m_filepath };
+    temp_filepath += ".tmp";
+
+    std::ofstream file{ temp_filepath,
+                        std::ios::binary | std::ios::out | std::ios::trunc };
+    file.write(reinterpret_cast<const char*>(&file_header), sizeof(FileHeader));
+    file.write(
+        reinterpret_cast<const char*>(data.data()),
+        static_cast<std::streamsize>(data.size())
+    );
+    file.close();
+
+    std::error_code error_code;
+    if (file) {
+        std::filesystem::rename(temp_filepath, m_filepath, error_code);
+    }
+    if (!file || error_code) {
+        SPDLOG_ERROR("Failed to save pipeline cache to {}", m_filepath.string());
+        std::filesystem::remove(temp_filepath, error_code);
+        return false;
+    }
+
+    return true;
+}
+
+}   // namespace core::renderer
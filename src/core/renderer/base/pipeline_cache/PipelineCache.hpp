@@ -0,0 +1,51 @@
+#pragma once
+
+#include <filesystem>
+
+#include <vulkan/vulkan.hpp>
+
+namespace core::renderer {
+
+class Device;
+
+// Kept on disk between runs, so pipelines compiled once are not compiled again.
+// The file is ignored when it was written by another device or driver version.
+class PipelineCache {
+public:
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    // Starts empty if the file is missing or does not match the device
+    explicit PipelineCache(const Device& t_device, std::filesystem::path t_filepath);
+    PipelineCache(const PipelineCache&)     = delete;
+    PipelineCache(PipelineCache&&) noexcept = default;
+    // Saves the cache
+    ~PipelineCache() noexcept;
+
+    ///-------------///
+    ///  Operators  ///
+    ///-------------///
+    auto operator=(const PipelineCache&) -> PipelineCache& = delete;
+    auto operator=(PipelineCache&&) noexcept -> PipelineCache& = default;
+    [[nodiscard]]
+    auto operator*() const noexcept -> vk::PipelineCache;
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    [[nodiscard]]
+    auto get() const noexcept -> vk::PipelineCache;
+
+    // Replaces the file through a temporary one, so a crash never leaves it half written
+    auto save() const -> bool;
+
+private:
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    vk::PhysicalDeviceProperties m_properties;
+    std::filesystem::path        m_filepath;
+    vk::UniquePipelineCache      m_pipeline_cache;
+};
+
+}   // namespace core::renderer
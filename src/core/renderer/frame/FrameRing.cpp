@@ -0,0 +1,94 @@
+#include "FrameRing.hpp"
+
+#include <limits>
+#include <ranges>
+
+[[nodiscard]]
+static auto create_frame(const vk::Device t_device, const uint32_t t_queue_family_index)
+    -> core::renderer::FrameRing::Frame
+{
+    vk::UniqueCommandPool command_pool{
+        t_device.createCommandPoolUnique(vk::CommandPoolCreateInfo{
+            .flags            = vk::CommandPoolCreateFlagBits::eTransient,
+            .queueFamilyIndex = t_queue_family_index,
+        })
+    };
+    const vk::CommandBuffer command_buffer{
+        t_device
+            .allocateCommandBuffers(vk::CommandBufferAllocateInfo{
+                .commandPool        = command_pool.get(),
+                .level              = vk::CommandBufferLevel::ePrimary,
+                .commandBufferCount = 1,
+            })
+            .front()
+    };
+
+    return core::renderer::FrameRing::Frame{
+        .command_pool              = std::move(command_pool),
+        .command_buffer            = command_buffer,
+        .image_acquired_semaphore  = t_device.createSemaphoreUnique({}),
+        .render_finished_semaphore = t_device.createSemaphoreUnique({}),
+        .in_flight_fence           = t_device.createFenceUnique(vk::FenceCreateInfo{
+            .flags = vk::FenceCreateFlagBits::eSignaled,
+        }),
+    };
+}
+
+namespace core::renderer {
+
+FrameRing::FrameRing(
+    const vk::Device t_device,
+    const uint32_t   t_queue_family_index,
+    const uint32_t   t_frame_count
+)
+    : m_device{ t_device },
+      m_frames{ std::views::iota(0u, t_frame_count)
+                | std::views::transform([&](uint32_t) {
+                      return create_frame(t_device, t_queue_family_index);
+                  })
+                | std::ranges::to<std::vector>() }
+{}
+
+auto FrameRing::wait_for_current() const -> void
+{
+    const Frame& frame{ current() };
+
+    static_cast<void>(m_device.waitForFences(
+        frame.in_flight_fence.get(), vk::True, std::numeric_limits<uint64_t>::max()
+    ));
+    m_device.resetCommandPool(frame.command_pool.get());
+}
+
+auto FrameRing::current() const noexcept -> const Frame&
+{
+    return m_frames[m_frame_index];
+}
+
+auto FrameRing::frame_index() const noexcept -> uint32_t
+{
+    return m_frame_index;
+}
+
+auto FrameRing::frame_count() const noexcept -> uint32_t
+{
+    return static_cast<uint32_t>(m_frames.size());
+}
+
+auto FrameRing::advance() noexcept -> void
+{
+    m_frame_index = (m_frame_index + 1) % frame_count();
+}
+
+auto FrameRing::wait_idle() const -> void
+{
+    const std::vector<vk::Fence> fences{ m_frames
+                                         | std::views::transform([](const Frame& frame) {
+                                               return frame.in_flight_fence.get();
+                                           })
+                                         | std::ranges::to<std::vector>() };
+    static_cast<void>(
+        m_device.waitForFences(fences, vk::True, std::numeric_limits<uint64_t>::max())
+    );
+}
+
+}   // namespace core::renderer
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+namespace core::renderer {
+
+// Resources of the frames the CPU may record while the GPU is still busy with earlier
+// ones. Every frame has its own command pool, so resetting it never touches
+// a command buffer that is still pending.
+class FrameRing {
+public:
+    ///------------------///
+    ///  Nested classes  ///
+    ///------------------///
+    struct Frame {
+        vk::UniqueCommandPool command_pool;
+        vk::CommandBuffer     command_buffer;
+        vk::UniqueSemaphore   image_acquired_semaphore;
+        vk::UniqueSemaphore   render_finished_semaphore;
+        // Signaled when the GPU has finished the frame's submission
+        vk::UniqueFence       in_flight_fence;
+    };
+
+    constexpr static uint32_t s_default_frame_count{ 2 };
+
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    explicit FrameRing(
+        vk::Device t_device,
+        uint32_t   t_queue_family_index,
+        uint32_t   t_frame_count = s_default_frame_count
+    );
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    // Waits until the GPU is done with the current frame and resets its command pool.
+    // The fence is left signaled, reset it right before submitting.
+    auto wait_for_current() const -> void;
+
+    [[nodiscard]]
+    auto current() const noexcept -> const Frame&;
+    [[nodiscard]]
+    auto frame_index() const noexcept -> uint32_t;
+    [[nodiscard]]
+    auto frame_count() const noexcept -> uint32_t;
+
+    auto advance() noexcept -> void;
+
+    // Waits for every frame in flight
+    auto wait_idle() const -> void;
+
+private:
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    vk::Device         m_device;
+    std::vector<Frame> m_frames;
+    uint32_t           m_frame_index{};
+};
+
+}   // namespace core::renderer
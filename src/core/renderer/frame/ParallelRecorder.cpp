@@ -0,0 +1,122 @@
+#include "ParallelRecorder.hpp"
+
+#include <algorithm>
+#include <ranges>
+#include <thread>
+
+#include "core/utility/tasks.hpp"
+
+[[nodiscard]]
+static auto create_command_pool(
+    const vk::Device t_device,
+    const uint32_t   t_queue_family_index
+) -> vk::UniqueCommandPool
+{
+    return t_device.createCommandPoolUnique(vk::CommandPoolCreateInfo{
+        .flags            = vk::CommandPoolCreateFlagBits::eTransient,
+        .queueFamilyIndex = t_queue_family_index,
+    });
+}
+
+namespace core::renderer {
+
+ParallelRecorder::ParallelRecorder(
+    const vk::Device t_device,
+    const uint32_t   t_queue_family_index,
+    const uint32_t   t_frame_count,
+    const uint32_t   t_thread_count
+)
+    : m_device{ t_device },
+      m_thread_count{ std::max(t_thread_count, 1u) },
+      m_command_pools{ std::views::iota(0u, t_frame_count * m_thread_count)
+                       | std::views::transform([&](uint32_t) {
+                             return CommandPool{
+                                 .command_pool =
+                                     create_command_pool(t_device, t_queue_family_index),
+                             };
+                         })
+                       | std::ranges::to<std::vector>() },
+      m_thread_pool{ std::make_unique<utils::ThreadPool>(
+          std::max(m_thread_count - 1, 1u)
+      ) }
+{}
+
+auto ParallelRecorder::default_thread_count() noexcept -> uint32_t
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+auto ParallelRecorder::reset(const uint32_t t_frame_index) -> void
+{
+    for (const uint32_t thread_index : std::views::iota(0u, m_thread_count)) {
+        CommandPool& command_pool{
+            m_command_pools.at(t_frame_index * m_thread_count + thread_index)
+        };
+        m_device.resetCommandPool(command_pool.command_pool.get());
+        command_pool.used_count = 0;
+    }
+}
+
+auto ParallelRecorder::record(
+    const uint32_t                                          t_frame_index,
+    const vk::CommandBufferInheritanceInfo&                 t_inheritance_info,
+    const std::function<void(vk::CommandBuffer, uint32_t)>& t_record
+) -> std::vector<vk::CommandBuffer>
+{
+    // Pools are not thread-safe, so the buffers are taken on this thread
+    const std::vector<vk::CommandBuffer> command_buffers{
+        std::views::iota(0u, m_thread_count)
+        | std::views::transform([&](const uint32_t thread_index) {
+              return acquire_command_buffer(t_frame_index, thread_index);
+          })
+        | std::ranges::to<std::vector>()
+    };
+
+    const auto record_on_thread{ [&](const uint32_t thread_index) {
+        const vk::CommandBuffer command_buffer{ command_buffers[thread_index] };
+        command_buffer.begin(vk::CommandBufferBeginInfo{
+            .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit
+                   | vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+            .pInheritanceInfo = &t_inheritance_info,
+        });
+        t_record(command_buffer, thread_index);
+        command_buffer.end();
+    } };
+
+    utils::run_tasks(*m_thread_pool, m_thread_count, [&](const size_t thread_index) {
+        record_on_thread(static_cast<uint32_t>(thread_index));
+    });
+
+    return command_buffers;
+}
+
+auto ParallelRecorder::thread_count() const noexcept -> uint32_t
+{
+    return m_thread_count;
+}
+
+auto ParallelRecorder::acquire_command_buffer(
+    const uint32_t t_frame_index,
+    const uint32_t t_thread_index
+) -> vk::CommandBuffer
+{
+    CommandPool& command_pool{
+        m_command_pools.at(t_frame_index * m_thread_count + t_thread_index)
+    };
+
+    if (command_pool.used_count == command_pool.command_buffers.size()) {
+        command_pool.command_buffers.push_back(
+            m_device
+                .allocateCommandBuffers(vk::CommandBufferAllocateInfo{
+                    .commandPool        = command_pool.command_pool.get(),
+                    .level              = vk::CommandBufferLevel::eSecondary,
+                    .commandBufferCount = 1,
+                })
+                .front()
+        );
+    }
+
+    return command_pool.command_buffers[command_pool.used_count++];
+}
+
+}   // namespace core::renderer
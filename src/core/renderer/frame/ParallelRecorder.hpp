@@ -0,0 +1,81 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "core/utility/ThreadPool.hpp"
+
+namespace core::renderer {
+
+// Records secondary command buffers of a render pass on several threads.
+// Every thread has its own command pool for each frame in flight,
+// so threads never share a pool and resetting one never touches pending buffers.
+// The worker threads are started once and kept for every frame.
+class ParallelRecorder {
+public:
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    explicit ParallelRecorder(
+        vk::Device t_device,
+        uint32_t   t_queue_family_index,
+        uint32_t   t_frame_count,
+        uint32_t   t_thread_count = default_thread_count()
+    );
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    // One for each hardware thread
+    [[nodiscard]]
+    static auto default_thread_count() noexcept -> uint32_t;
+
+    // The GPU must be done with every command buffer recorded for the frame
+    auto reset(uint32_t t_frame_index) -> void;
+
+    // Calls t_record with the thread index on every thread, one of them the calling
+    // one, each with a secondary command buffer continuing the given render pass.
+    // The buffers are returned in thread order, execute them from the primary one.
+    [[nodiscard]]
+    auto record(
+        uint32_t                                                t_frame_index,
+        const vk::CommandBufferInheritanceInfo&                 t_inheritance_info,
+        const std::function<void(vk::CommandBuffer, uint32_t)>& t_record
+    ) -> std::vector<vk::CommandBuffer>;
+
+    [[nodiscard]]
+    auto thread_count() const noexcept -> uint32_t;
+
+private:
+    ///******************///
+    ///  Nested classes  ///
+    ///******************///
+    struct CommandPool {
+        vk::UniqueCommandPool          command_pool;
+        // Reused after each reset, it only grows
+        std::vector<vk::CommandBuffer> command_buffers;
+        uint32_t                       used_count{};
+    };
+
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    vk::Device               m_device;
+    uint32_t                 m_thread_count;
+    // Indexed by frame_index * thread_count + thread_index
+    std::vector<CommandPool> m_command_pools;
+    // Thread index 0 is recorded on the calling thread, the rest on these workers
+    std::unique_ptr<utils::ThreadPool> m_thread_pool;
+
+    ///***********///
+    ///  Methods  ///
+    ///***********///
+    [[nodiscard]]
+    auto acquire_command_buffer(uint32_t t_frame_index, uint32_t t_thread_index)
+        -> vk::CommandBuffer;
+};
+
+}   // namespace core::renderer
@@ -0,0 +1,42 @@
+#include "AsyncPipeline.hpp"
+
+#include <chrono>
+
+namespace core::renderer {
+
+AsyncPipeline::AsyncPipeline(
+    std::shared_future<vk::UniquePipeline>&& t_pipeline,
+    const vk::Pipeline                       t_fallback_pipeline
+) noexcept
+    : m_pipeline{ std::move(t_pipeline) },
+      m_fallback_pipeline{ t_fallback_pipeline }
+{}
+
+AsyncPipeline::~AsyncPipeline() noexcept
+{
+    if (m_pipeline.valid()) {
+        m_pipeline.wait();
+    }
+}
+
+auto AsyncPipeline::get() const noexcept -> vk::Pipeline
+{
+    if (!ready()) {
+        return m_fallback_pipeline;
+    }
+
+    return m_pipeline.get().get();
+}
+
+auto AsyncPipeline::ready() const noexcept -> bool
+{
+    return m_pipeline.wait_for(std::chrono::seconds{ 0 }) == std::future_status::ready
+        && m_pipeline.get();
+}
+
+auto AsyncPipeline::wait() const -> void
+{
+    m_pipeline.wait();
+}
+
+}   // namespace core::renderer
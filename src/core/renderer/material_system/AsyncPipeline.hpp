@@ -0,0 +1,51 @@
+#pragma once
+
+#include <future>
+
+#include <vulkan/vulkan.hpp>
+
+namespace core::renderer {
+
+// A pipeline compiled on a worker thread, see GraphicsPipelineBuilder::build_async()
+class AsyncPipeline {
+public:
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    explicit AsyncPipeline(
+        std::shared_future<vk::UniquePipeline>&& t_pipeline,
+        vk::Pipeline                             t_fallback_pipeline
+    ) noexcept;
+    AsyncPipeline(const AsyncPipeline&)     = delete;
+    AsyncPipeline(AsyncPipeline&&) noexcept = default;
+    // Waits for the compilation, so it never outlives the pipeline and the device
+    ~AsyncPipeline() noexcept;
+
+    ///-------------///
+    ///  Operators  ///
+    ///-------------///
+    auto operator=(const AsyncPipeline&) -> AsyncPipeline& = delete;
+    auto operator=(AsyncPipeline&&) -> AsyncPipeline&      = delete;
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    // The fallback pipeline until the compiled one is ready, which may be null.
+    // Pipelines that failed to compile are never ready.
+    [[nodiscard]]
+    auto get() const noexcept -> vk::Pipeline;
+    [[nodiscard]]
+    auto ready() const noexcept -> bool;
+    // Blocks until the compilation is done
+    auto wait() const -> void;
+
+private:
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    // Holds a null pipeline if the compilation failed
+    std::shared_future<vk::UniquePipeline> m_pipeline;
+    vk::Pipeline                           m_fallback_pipeline;
+};
+
+}   // namespace core::renderer
@@ -6,17 +6,9 @@
 
 namespace core::renderer {
 
-Effect::Effect(
-    Shader t_vertex_shader,
-    Shader t_fragment_shader) noexcept
+Effect::Effect(Shader t_vertex_shader, Shader t_fragment_shader) noexcept
     : m_vertex_shader{ std::move(t_vertex_shader) },
-      m_fragment_shader{ std::move(t_fragment_shader) },
-      m_stages{ vk::PipelineShaderStageCreateInfo{   .stage  = vk::ShaderStageFlagBits::eVertex,
-                                                   .module = m_vertex_shader.module(),
-                                                   .pName  = m_vertex_shader.entry_point().c_str() },
-                vk::PipelineShaderStageCreateInfo{ .stage  = vk::ShaderStageFlagBits::eFragment,
-                                                   .module = m_fragment_shader.module(),
-                                                   .pName  = m_fragment_shader.entry_point().c_str() } }
+      m_fragment_shader{ std::move(t_fragment_shader) }
 {}
 
 auto Effect::vertex_shader() const noexcept -> const Shader&
@@ -29,9 +21,20 @@ auto Effect::fragment_shader() const noexcept -> const Shader&
     return m_fragment_shader;
 }
 
-auto Effect::pipeline_stages() const -> std::span<const vk::PipelineShaderStageCreateInfo>
+auto Effect::pipeline_stages() const -> std::array<vk::PipelineShaderStageCreateInfo, 2>
 {
-    return m_stages;
+    return std::array{
+        vk::PipelineShaderStageCreateInfo{
+            .stage  = vk::ShaderStageFlagBits::eVertex,
+            .module = m_vertex_shader.module(),
+            .pName  = m_vertex_shader.entry_point().c_str(),
+        },
+        vk::PipelineShaderStageCreateInfo{
+            .stage  = vk::ShaderStageFlagBits::eFragment,
+            .module = m_fragment_shader.module(),
+            .pName  = m_fragment_shader.entry_point().c_str(),
+        },
+    };
 }
 
 [[nodiscard]]
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <filesystem>
 
 #include "core/cache/Handle.hpp"
@@ -17,13 +18,13 @@ public:
     [[nodiscard]]
     auto fragment_shader() const noexcept -> const Shader&;
 
+    // Built on each call, as they point into the shaders of this effect
     [[nodiscard]]
-    auto pipeline_stages() const -> std::span<const vk::PipelineShaderStageCreateInfo>;
+    auto pipeline_stages() const -> std::array<vk::PipelineShaderStageCreateInfo, 2>;
 
 private:
-    Shader                                           m_vertex_shader;
-    Shader                                           m_fragment_shader;
-    std::array<vk::PipelineShaderStageCreateInfo, 2> m_stages;
+    Shader m_vertex_shader;
+    Shader m_fragment_shader;
 
     friend auto hash_value(const Effect& t_effect) noexcept -> size_t;
 };
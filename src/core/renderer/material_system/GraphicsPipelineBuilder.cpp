@@ -1,9 +1,37 @@
 #include "GraphicsPipelineBuilder.hpp"
 
+#include <future>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
 #include <vulkan/vulkan_hash.hpp>
 
 #include "core/utility/hashing.hpp"
 
+// Pipelines with a dynamic topology may draw any topology of the same class
+[[nodiscard]]
+static auto topology_class(const vk::PrimitiveTopology t_primitive_topology) noexcept
+    -> vk::PrimitiveTopology
+{
+    switch (t_primitive_topology) {
+        case vk::PrimitiveTopology::ePointList: return vk::PrimitiveTopology::ePointList;
+        case vk::PrimitiveTopology::eLineList:
+        case vk::PrimitiveTopology::eLineStrip:
+        case vk::PrimitiveTopology::eLineListWithAdjacency:
+        case vk::PrimitiveTopology::eLineStripWithAdjacency:
+            return vk::PrimitiveTopology::eLineList;
+        case vk::PrimitiveTopology::eTriangleList:
+        case vk::PrimitiveTopology::eTriangleStrip:
+        case vk::PrimitiveTopology::eTriangleFan:
+        case vk::PrimitiveTopology::eTriangleListWithAdjacency:
+        case vk::PrimitiveTopology::eTriangleStripWithAdjacency:
+            return vk::PrimitiveTopology::eTriangleList;
+        case vk::PrimitiveTopology::ePatchList: return vk::PrimitiveTopology::ePatchList;
+    }
+    return t_primitive_topology;
+}
+
 namespace core::renderer {
 
 GraphicsPipelineBuilder::GraphicsPipelineBuilder(
@@ -48,6 +76,20 @@ auto GraphicsPipelineBuilder::disable_blending() noexcept -> GraphicsPipelineBui
     return *this;
 }
 
+auto GraphicsPipelineBuilder::enable_extended_dynamic_state() noexcept
+    -> GraphicsPipelineBuilder&
+{
+    m_extended_dynamic_state = true;
+    return *this;
+}
+
+auto GraphicsPipelineBuilder::enable_dynamic_blending() noexcept
+    -> GraphicsPipelineBuilder&
+{
+    m_dynamic_blending = true;
+    return *this;
+}
+
 auto GraphicsPipelineBuilder::set_layout(const vk::PipelineLayout t_layout
 ) noexcept -> GraphicsPipelineBuilder&
 {
@@ -62,14 +104,18 @@ auto GraphicsPipelineBuilder::set_render_pass(const vk::RenderPass t_render_pass
     return *this;
 }
 
-auto GraphicsPipelineBuilder::build(const vk::Device t_device) const -> vk::UniquePipeline
+auto GraphicsPipelineBuilder::build(
+    const vk::Device        t_device,
+    const vk::PipelineCache t_pipeline_cache
+) const -> vk::UniquePipeline
 {
     // TODO: allow vertex input states
     constexpr static vk::PipelineVertexInputStateCreateInfo
         vertex_input_state_create_info{};
 
     const vk::PipelineInputAssemblyStateCreateInfo input_assembly_state_create_info{
-        .topology = m_primitive_topology
+        .topology = m_extended_dynamic_state ? topology_class(m_primitive_topology)
+                                             : m_primitive_topology
     };
 
     constexpr vk::PipelineViewportStateCreateInfo viewport_state_create_info{
@@ -96,11 +142,12 @@ auto GraphicsPipelineBuilder::build(const vk::Device t_device) const -> vk::Uniq
     };
 
     vk::PipelineColorBlendAttachmentState color_blend_attachment_state{
-        .blendEnable    = m_enable_blending,
+        .blendEnable    = m_enable_blending && !m_dynamic_blending,
         .colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG
                         | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA,
     };
-    if (m_enable_blending) {
+    // With dynamic blending, the factors are there for the draws that enable it
+    if (m_enable_blending || m_dynamic_blending) {
         color_blend_attachment_state.srcColorBlendFactor = vk::BlendFactor::eSrcAlpha;
         color_blend_attachment_state.dstColorBlendFactor =
             vk::BlendFactor::eOneMinusSrcAlpha;
@@ -115,16 +162,31 @@ auto GraphicsPipelineBuilder::build(const vk::Device t_device) const -> vk::Uniq
         .pAttachments    = &color_blend_attachment_state,
     };
 
-    constexpr static std::array dynamic_states{ vk::DynamicState::eViewport,
-                                                vk::DynamicState::eScissor };
-    constexpr vk::PipelineDynamicStateCreateInfo dynamic_state_create_info{
+    std::vector<vk::DynamicState> dynamic_states{ vk::DynamicState::eViewport,
+                                                  vk::DynamicState::eScissor };
+    if (m_extended_dynamic_state) {
+        dynamic_states.insert(
+            dynamic_states.end(),
+            { vk::DynamicState::eCullModeEXT,
+              vk::DynamicState::eFrontFaceEXT,
+              vk::DynamicState::ePrimitiveTopologyEXT,
+              vk::DynamicState::eDepthTestEnableEXT,
+              vk::DynamicState::eDepthWriteEnableEXT }
+        );
+    }
+    if (m_dynamic_blending) {
+        dynamic_states.push_back(vk::DynamicState::eColorBlendEnableEXT);
+    }
+    const vk::PipelineDynamicStateCreateInfo dynamic_state_create_info{
         .dynamicStateCount = static_cast<uint32_t>(dynamic_states.size()),
         .pDynamicStates    = dynamic_states.data()
     };
 
+    const std::array stages{ m_effect.pipeline_stages() };
+
     const vk::GraphicsPipelineCreateInfo create_info{
-        .stageCount          = static_cast<uint32_t>(m_effect.pipeline_stages().size()),
-        .pStages             = m_effect.pipeline_stages().data(),
+        .stageCount          = static_cast<uint32_t>(stages.size()),
+        .pStages             = stages.data(),
         .pVertexInputState   = &vertex_input_state_create_info,
         .pInputAssemblyState = &input_assembly_state_create_info,
         .pViewportState      = &viewport_state_create_info,
@@ -137,20 +199,48 @@ auto GraphicsPipelineBuilder::build(const vk::Device t_device) const -> vk::Uniq
         .renderPass          = m_render_pass,
     };
 
-    return t_device.createGraphicsPipelineUnique(nullptr, create_info).value;
+    return t_device.createGraphicsPipelineUnique(t_pipeline_cache, create_info).value;
+}
+
+auto GraphicsPipelineBuilder::build_async(
+    utils::ThreadPool&      t_thread_pool,
+    const vk::Device        t_device,
+    const vk::PipelineCache t_pipeline_cache,
+    const vk::Pipeline      t_fallback_pipeline
+) const -> AsyncPipeline
+{
+    // The copy keeps the shader modules alive while compiling
+    std::future<vk::UniquePipeline> pipeline{ t_thread_pool.submit(
+        [builder = *this, t_device, t_pipeline_cache] -> vk::UniquePipeline {
+            try {
+                return builder.build(t_device, t_pipeline_cache);
+            } catch (const vk::Error& t_error) {
+                SPDLOG_ERROR(t_error.what());
+                return {};
+            }
+        }
+    ) };
+
+    return AsyncPipeline{ pipeline.share(), t_fallback_pipeline };
 }
 
 [[nodiscard]]
 auto hash_value(const GraphicsPipelineBuilder& t_graphics_pipeline_builder
 ) noexcept -> size_t
 {
+    const GraphicsPipelineBuilder& builder{ t_graphics_pipeline_builder };
+
+    // Dynamic states are left out, so the pipelines differing in them are shared
     return hash_combine(
-        t_graphics_pipeline_builder.m_effect,
-        t_graphics_pipeline_builder.m_primitive_topology,
-        t_graphics_pipeline_builder.m_cull_mode,
-        t_graphics_pipeline_builder.m_enable_blending,
-        t_graphics_pipeline_builder.m_layout,
-        t_graphics_pipeline_builder.m_render_pass
+        builder.m_effect,
+        builder.m_extended_dynamic_state ? topology_class(builder.m_primitive_topology)
+                                         : builder.m_primitive_topology,
+        builder.m_extended_dynamic_state ? vk::CullModeFlags{} : builder.m_cull_mode,
+        builder.m_enable_blending && !builder.m_dynamic_blending,
+        builder.m_extended_dynamic_state,
+        builder.m_dynamic_blending,
+        builder.m_layout,
+        builder.m_render_pass
     );
 }
 
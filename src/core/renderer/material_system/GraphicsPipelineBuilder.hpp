@@ -6,7 +6,9 @@
 
 #include "core/cache/Cache.hpp"
 #include "core/cache/Handle.hpp"
+#include "core/utility/ThreadPool.hpp"
 
+#include "AsyncPipeline.hpp"
 #include "Effect.hpp"
 
 namespace core::renderer {
@@ -24,12 +26,29 @@ public:
     auto set_cull_mode(vk::CullModeFlags t_cull_mode) noexcept -> GraphicsPipelineBuilder&;
     auto enable_blending() noexcept -> GraphicsPipelineBuilder&;
     auto disable_blending() noexcept -> GraphicsPipelineBuilder&;
+    // VK_EXT_extended_dynamic_state: cull mode, front face, primitive topology,
+    // depth test and depth write are set when drawing, the pipeline only keeps
+    // the class of the topology
+    auto enable_extended_dynamic_state() noexcept -> GraphicsPipelineBuilder&;
+    // VK_EXT_extended_dynamic_state3: blending is enabled when drawing
+    auto enable_dynamic_blending() noexcept -> GraphicsPipelineBuilder&;
     auto set_layout(vk::PipelineLayout t_layout) noexcept -> GraphicsPipelineBuilder&;
     auto set_render_pass(vk::RenderPass t_render_pass
     ) noexcept -> GraphicsPipelineBuilder&;
 
     [[nodiscard]]
-    auto build(vk::Device t_device) const -> vk::UniquePipeline;
+    auto build(vk::Device t_device, vk::PipelineCache t_pipeline_cache) const
+        -> vk::UniquePipeline;
+    // Compiles on the thread pool, the fallback pipeline stands in until it is done.
+    // Failures are logged on the worker thread.
+    // The pool has to be joined before the device is destroyed, like the store one.
+    [[nodiscard]]
+    auto build_async(
+        utils::ThreadPool& t_thread_pool,
+        vk::Device         t_device,
+        vk::PipelineCache  t_pipeline_cache,
+        vk::Pipeline       t_fallback_pipeline = {}
+    ) const -> AsyncPipeline;
 
 private:
     std::optional<std::reference_wrapper<cache::Cache>> m_cache;
@@ -37,6 +56,8 @@ private:
     vk::PrimitiveTopology m_primitive_topology{ vk::PrimitiveTopology::eTriangleList };
     vk::CullModeFlags     m_cull_mode{};
     bool                  m_enable_blending{};
+    bool                  m_extended_dynamic_state{};
+    bool                  m_dynamic_blending{};
     vk::PipelineLayout    m_layout;
     vk::RenderPass        m_render_pass;
 
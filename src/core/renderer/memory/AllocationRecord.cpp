@@ -0,0 +1,77 @@
+#include "AllocationRecord.hpp"
+
+#include <memory>
+
+namespace core::renderer {
+
+auto AllocationRecord::create(
+    const VmaAllocator  t_allocator,
+    const VmaAllocation t_allocation,
+    AllocationRecord&&  t_record
+) -> void
+{
+    std::visit(
+        [](auto& create_info) {
+            create_info.pNext               = nullptr;
+            create_info.pQueueFamilyIndices = nullptr;
+        },
+        t_record.create_info
+    );
+
+    vmaSetAllocationUserData(
+        t_allocator,
+        t_allocation,
+        std::make_unique<AllocationRecord>(std::move(t_record)).release()
+    );
+}
+
+auto AllocationRecord::get(
+    const VmaAllocator  t_allocator,
+    const VmaAllocation t_allocation
+) noexcept -> AllocationRecord*
+{
+    if (t_allocator == nullptr || t_allocation == nullptr) {
+        return nullptr;
+    }
+
+    VmaAllocationInfo allocation_info;
+    vmaGetAllocationInfo(t_allocator, t_allocation, &allocation_info);
+    return static_cast<AllocationRecord*>(allocation_info.pUserData);
+}
+
+auto AllocationRecord::set_owner(
+    const VmaAllocator                                  t_allocator,
+    const VmaAllocation                                 t_allocation,
+    const std::variant<std::monostate, Buffer*, Image*> t_owner
+) noexcept -> void
+{
+    if (AllocationRecord* record{ get(t_allocator, t_allocation) }; record != nullptr) {
+        record->owner = t_owner;
+    }
+}
+
+auto AllocationRecord::release(
+    const VmaAllocator  t_allocator,
+    const VmaAllocation t_allocation
+) noexcept -> bool
+{
+    VmaAllocationInfo allocation_info;
+    vmaGetAllocationInfo(t_allocator, t_allocation, &allocation_info);
+    auto* record{ static_cast<AllocationRecord*>(allocation_info.pUserData) };
+    if (record == nullptr) {
+        return true;
+    }
+
+    *record->category_counter -= allocation_info.size;
+
+    if (record->moving) {
+        record->owner    = std::monostate{};
+        record->orphaned = true;
+        return false;
+    }
+
+    const std::unique_ptr<AllocationRecord> owned_record{ record };
+    return true;
+}
+
+}   // namespace core::renderer
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <variant>
+
+#include <vulkan/vulkan.hpp>
+
+#include <vk_mem_alloc.h>
+
+namespace core::renderer {
+
+class Buffer;
+class Image;
+
+// The user data of every allocation made by Allocator.
+// Heap allocated, so that it stays put while the owning object moves around.
+struct AllocationRecord {
+    ///-------------///
+    ///  Variables  ///
+    ///-------------///
+    std::atomic<vk::DeviceSize>* category_counter;
+    // Enough to recreate the resource in the memory it is moved to
+    std::variant<vk::BufferCreateInfo, vk::ImageCreateInfo> create_info;
+    // The object holding the handle, kept up to date by Buffer and Image
+    std::variant<std::monostate, Buffer*, Image*> owner{};
+
+    // Set by the owner once the Defragmenter may move the resource.
+    // Images have to stay in the given layout from then on.
+    bool            movable{};
+    vk::ImageLayout layout{};
+
+    // Set while a defragmentation pass moves the allocation
+    bool moving{};
+    // The owner let go of the allocation in the middle of a move
+    bool orphaned{};
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    static auto create(
+        VmaAllocator       t_allocator,
+        VmaAllocation      t_allocation,
+        AllocationRecord&& t_record
+    ) -> void;
+
+    [[nodiscard]]
+    static auto get(VmaAllocator t_allocator, VmaAllocation t_allocation) noexcept
+        -> AllocationRecord*;
+
+    static auto set_owner(
+        VmaAllocator                                  t_allocator,
+        VmaAllocation                                 t_allocation,
+        std::variant<std::monostate, Buffer*, Image*> t_owner
+    ) noexcept -> void;
+
+    // Returns false if the allocation is in the middle of a move,
+    // the Defragmenter frees it together with its handles then
+    [[nodiscard]]
+    static auto release(VmaAllocator t_allocator, VmaAllocation t_allocation) noexcept
+        -> bool;
+};
+
+}   // namespace core::renderer
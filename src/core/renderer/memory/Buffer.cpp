@@ -1,5 +1,7 @@
 #include "Buffer.hpp"
 
+#include "AllocationRecord.hpp"
+
 namespace core::renderer {
 
 Buffer::Buffer(
@@ -10,7 +12,9 @@ Buffer::Buffer(
     : m_buffer{ t_buffer },
       m_allocation{ t_allocation },
       m_allocator{ t_allocator }
-{}
+{
+    AllocationRecord::set_owner(m_allocator, m_allocation, this);
+}
 
 Buffer::Buffer(Buffer&& t_other) noexcept
     : Buffer{ std::exchange(t_other.m_buffer, nullptr),
@@ -31,6 +35,8 @@ auto Buffer::operator=(Buffer&& t_other) noexcept -> Buffer&
         m_allocator  = std::exchange(t_other.m_allocator, nullptr);
         m_buffer     = std::exchange(t_other.m_buffer, nullptr);
         m_allocation = std::exchange(t_other.m_allocation, nullptr);
+
+        AllocationRecord::set_owner(m_allocator, m_allocation, this);
     }
     return *this;
 }
@@ -57,7 +63,7 @@ auto Buffer::allocator() const noexcept -> VmaAllocator
 
 auto Buffer::reset() noexcept -> void
 {
-    if (m_allocator != nullptr) {
+    if (m_allocator != nullptr && AllocationRecord::release(m_allocator, m_allocation)) {
         vmaDestroyBuffer(m_allocator, m_buffer, m_allocation);
     }
     m_allocation = nullptr;
@@ -0,0 +1,100 @@
+#include "BufferArena.hpp"
+
+#include <algorithm>
+#include <ranges>
+
+#include "core/renderer/base/allocator/Allocator.hpp"
+
+[[nodiscard]]
+static auto align_up(
+    const vk::DeviceSize t_value,
+    const vk::DeviceSize t_alignment
+) noexcept -> vk::DeviceSize
+{
+    return (t_value + t_alignment - 1) / t_alignment * t_alignment;
+}
+
+namespace core::renderer {
+
+BufferArena::BufferArena(
+    const vk::Device           t_device,
+    const Allocator&           t_allocator,
+    const vk::BufferUsageFlags t_usage,
+    const MemoryUsage          t_memory_usage,
+    const vk::DeviceSize       t_block_size
+)
+    : m_device{ t_device },
+      m_allocator{ t_allocator },
+      m_usage{ t_usage | vk::BufferUsageFlagBits::eShaderDeviceAddress },
+      m_memory_usage{ t_memory_usage },
+      m_block_size{ t_block_size }
+{}
+
+auto BufferArena::allocate(const vk::DeviceSize t_size, const vk::DeviceSize t_alignment)
+    -> Allocation
+{
+    if (t_size == 0) {
+        return Allocation{};
+    }
+
+    if (m_blocks.empty()
+        || align_up(m_blocks.back().used, t_alignment) + t_size > m_blocks.back().size)
+    {
+        const vk::BufferCreateInfo buffer_create_info{
+            .size  = std::max(m_block_size, t_size),
+            .usage = m_usage,
+        };
+        MappedBuffer buffer{
+            m_allocator.get().allocate_buffer(buffer_create_info, m_memory_usage)
+        };
+
+        const vk::DeviceAddress address{
+            m_device.getBufferAddress(vk::BufferDeviceAddressInfo{
+                .buffer = buffer.get(),
+            })
+        };
+        m_blocks.push_back(Block{
+            .buffer  = std::move(buffer),
+            .address = address,
+            .size    = buffer_create_info.size,
+            .used    = 0,
+        });
+    }
+
+    Block&               block{ m_blocks.back() };
+    const vk::DeviceSize offset{ align_up(block.used, t_alignment) };
+    block.used = offset + t_size;
+
+    return Allocation{
+        .buffer      = block.buffer.get(),
+        .offset      = offset,
+        .size        = t_size,
+        .address     = block.address + offset,
+        .mapped_data = block.buffer.data() != nullptr
+                         ? block.buffer.span<std::byte>().subspan(offset, t_size)
+                         : std::span<std::byte>{},
+    };
+}
+
+auto BufferArena::buffers() const -> std::vector<vk::Buffer>
+{
+    return m_blocks | std::views::transform([](const Block& block) {
+               return block.buffer.get();
+           })
+         | std::ranges::to<std::vector>();
+}
+
+auto BufferArena::flush() const -> void
+{
+    for (const Block& block : m_blocks) {
+        block.buffer.mark_dirty(0, block.used);
+    }
+    MappedBuffer::flush_dirty(
+        m_blocks | std::views::transform([](const Block& block) {
+            return std::cref(block.buffer);
+        })
+        | std::ranges::to<std::vector>()
+    );
+}
+
+}   // namespace core::renderer
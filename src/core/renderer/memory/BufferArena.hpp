@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "MappedBuffer.hpp"
+#include "MemoryUsage.hpp"
+
+namespace core::renderer {
+
+class Allocator;
+
+// Bump-allocates static device-local buffers out of a few large blocks.
+// Memory is only given back when the arena is destroyed.
+// With MemoryUsage::eUploadDirect, blocks that end up host-visible
+// can be written without staging.
+// Not thread-safe.
+class BufferArena {
+public:
+    ///------------------///
+    ///  Nested classes  ///
+    ///------------------///
+    struct Allocation {
+        vk::Buffer        buffer;
+        vk::DeviceSize    offset;
+        vk::DeviceSize    size;
+        vk::DeviceAddress address;
+        // Empty unless the block is host-visible, call flush() after writing it
+        std::span<std::byte> mapped_data{};
+    };
+
+    constexpr static vk::DeviceSize s_default_block_size{ 16ull * 1024 * 1024 };
+
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    explicit BufferArena(
+        vk::Device           t_device,
+        const Allocator&     t_allocator,
+        vk::BufferUsageFlags t_usage,
+        MemoryUsage          t_memory_usage = MemoryUsage::eDeviceOnly,
+        vk::DeviceSize       t_block_size   = s_default_block_size
+    );
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    // Requests larger than the block size get a block of their own.
+    // An empty allocation is returned for a size of zero.
+    [[nodiscard]]
+    auto allocate(vk::DeviceSize t_size, vk::DeviceSize t_alignment = 1) -> Allocation;
+
+    [[nodiscard]]
+    auto buffers() const -> std::vector<vk::Buffer>;
+
+    // Flushes everything allocated so far with a single call,
+    // only needed for memory that is not host-coherent
+    auto flush() const -> void;
+
+private:
+    ///******************///
+    ///  Nested classes  ///
+    ///******************///
+    struct Block {
+        MappedBuffer      buffer;
+        vk::DeviceAddress address;
+        vk::DeviceSize    size;
+        vk::DeviceSize    used;
+    };
+
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    vk::Device                              m_device;
+    std::reference_wrapper<const Allocator> m_allocator;
+    vk::BufferUsageFlags                    m_usage;
+    MemoryUsage                             m_memory_usage;
+    vk::DeviceSize                          m_block_size;
+    std::vector<Block>                      m_blocks;
+};
+
+}   // namespace core::renderer
@@ -0,0 +1,441 @@
+#include "Defragmenter.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <ranges>
+
+#include "core/renderer/base/allocator/Allocator.hpp"
+#include "core/renderer/base/device/Device.hpp"
+
+#include "AllocationRecord.hpp"
+
+[[nodiscard]]
+static auto aspect_flags(const vk::Format t_format) noexcept -> vk::ImageAspectFlags
+{
+    switch (t_format) {
+        case vk::Format::eD16Unorm:
+        case vk::Format::eX8D24UnormPack32:
+        case vk::Format::eD32Sfloat: return vk::ImageAspectFlagBits::eDepth;
+        case vk::Format::eD16UnormS8Uint:
+        case vk::Format::eD24UnormS8Uint:
+        case vk::Format::eD32SfloatS8Uint:
+            return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+        case vk::Format::eS8Uint: return vk::ImageAspectFlagBits::eStencil;
+        default: return vk::ImageAspectFlagBits::eColor;
+    }
+}
+
+[[nodiscard]]
+static auto mip_extent(const vk::Extent3D& t_extent, const uint32_t t_mip_level) noexcept
+    -> vk::Extent3D
+{
+    return vk::Extent3D{
+        .width  = std::max(t_extent.width >> t_mip_level, 1u),
+        .height = std::max(t_extent.height >> t_mip_level, 1u),
+        .depth  = std::max(t_extent.depth >> t_mip_level, 1u),
+    };
+}
+
+[[nodiscard]]
+static auto is_movable(const core::renderer::AllocationRecord& t_record) noexcept -> bool
+{
+    const auto* create_info{ std::get_if<vk::ImageCreateInfo>(&t_record.create_info) };
+
+    return t_record.movable && create_info != nullptr
+        && create_info->sharingMode != vk::SharingMode::eConcurrent
+        && std::holds_alternative<core::renderer::Image*>(t_record.owner);
+}
+
+// Creates the image again, bound to the memory it is moved to
+[[nodiscard]]
+static auto create_moved_image(
+    const vk::Device                        t_device,
+    const VmaAllocator                      t_allocator,
+    const VmaAllocation                     t_destination,
+    const core::renderer::AllocationRecord& t_record
+) -> vk::Image
+{
+    const vk::Image image{
+        t_device.createImage(std::get<vk::ImageCreateInfo>(t_record.create_info))
+    };
+    vk::resultCheck(
+        vk::Result{
+            vmaBindImageMemory(t_allocator, t_destination, static_cast<VkImage>(image)) },
+        "vmaBindImageMemory failed"
+    );
+    return image;
+}
+
+namespace core::renderer {
+
+Defragmenter::Defragmenter(
+    const Device&                   t_device,
+    const Allocator&                t_allocator,
+    const uint32_t                  t_frame_count,
+    const std::chrono::microseconds t_time_budget,
+    const vk::DeviceSize            t_max_bytes_per_pass,
+    const VmaPool                   t_pool
+)
+    : m_device{ t_device.get() },
+      m_allocator{ t_allocator },
+      m_queue{ t_device.info().get_queue(vkb::QueueType::graphics).value() },
+      m_command_pool{ m_device.createCommandPoolUnique(vk::CommandPoolCreateInfo{
+          .flags = vk::CommandPoolCreateFlagBits::eTransient,
+          .queueFamilyIndex =
+              t_device.info().get_queue_index(vkb::QueueType::graphics).value(),
+      }) },
+      m_frame_count{ t_frame_count },
+      m_time_budget{ t_time_budget },
+      m_max_bytes_per_pass{ t_max_bytes_per_pass },
+      m_pool{ t_pool }
+{}
+
+Defragmenter::Defragmenter(Defragmenter&& t_other) noexcept
+    : m_device{ t_other.m_device },
+      m_allocator{ t_other.m_allocator },
+      m_queue{ t_other.m_queue },
+      m_command_pool{ std::move(t_other.m_command_pool) },
+      m_frame_count{ t_other.m_frame_count },
+      m_time_budget{ t_other.m_time_budget },
+      m_max_bytes_per_pass{ t_other.m_max_bytes_per_pass },
+      m_pool{ t_other.m_pool },
+      m_context{ std::exchange(t_other.m_context, nullptr) },
+      m_pass{ std::exchange(t_other.m_pass, std::nullopt) },
+      m_next_start{ t_other.m_next_start }
+{}
+
+Defragmenter::~Defragmenter()
+{
+    finish();
+}
+
+auto Defragmenter::allow_moves(
+    const Image&          t_image,
+    const vk::ImageLayout t_layout
+) noexcept -> void
+{
+    AllocationRecord* record{
+        AllocationRecord::get(t_image.allocator(), t_image.allocation())
+    };
+    if (record != nullptr) {
+        record->movable = true;
+        record->layout  = t_layout;
+    }
+}
+
+auto Defragmenter::update() -> Relocations
+{
+    const auto start{ std::chrono::steady_clock::now() };
+
+    if (m_pass.has_value()) {
+        if (!m_pass->frames_until_retired.has_value()) {
+            if (m_device.getFenceStatus(m_pass->fence.get()) != vk::Result::eSuccess) {
+                return Relocations{};
+            }
+            m_pass->frames_until_retired = m_frame_count;
+            return swap_handles();
+        }
+
+        if (--*m_pass->frames_until_retired > 0) {
+            return Relocations{};
+        }
+        retire_pass();
+    }
+
+    begin_pass(start);
+    return Relocations{};
+}
+
+auto Defragmenter::finish() -> void
+{
+    if (m_pass.has_value()) {
+        static_cast<void>(m_device.waitForFences(
+            m_pass->fence.get(), vk::True, std::numeric_limits<uint64_t>::max()
+        ));
+
+        // The owners still hold the old handles, so everything stays where it is
+        if (!m_pass->frames_until_retired.has_value()) {
+            for (Move& move : m_pass->moves) {
+                move.move->operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                std::swap(move.old_image, move.new_image);
+            }
+        }
+        retire_pass();
+    }
+
+    if (m_context != nullptr) {
+        end_defragmentation();
+    }
+}
+
+auto Defragmenter::begin_pass(const std::chrono::steady_clock::time_point t_start) -> void
+{
+    const VmaAllocator allocator{ m_allocator.get().get() };
+
+    if (m_context == nullptr) {
+        if (t_start < m_next_start) {
+            return;
+        }
+
+        const VmaDefragmentationInfo defragmentation_info{
+            .pool            = m_pool,
+            .maxBytesPerPass = m_max_bytes_per_pass,
+        };
+        vk::resultCheck(
+            vk::Result{
+                vmaBeginDefragmentation(allocator, &defragmentation_info, &m_context) },
+            "vmaBeginDefragmentation failed"
+        );
+    }
+
+    VmaDefragmentationPassMoveInfo pass_info{};
+    const vk::Result               result{
+        vmaBeginDefragmentationPass(allocator, m_context, &pass_info)
+    };
+    if (result == vk::Result::eSuccess) {
+        end_defragmentation();
+        return;
+    }
+    vk::resultCheck(
+        result, "vmaBeginDefragmentationPass failed", { vk::Result::eIncomplete }
+    );
+
+    std::vector<Move>                       moves;
+    const std::span<VmaDefragmentationMove> pass_moves{ pass_info.pMoves,
+                                                        pass_info.moveCount };
+    for (VmaDefragmentationMove& move : pass_moves) {
+        AllocationRecord* record{ AllocationRecord::get(allocator, move.srcAllocation) };
+        if (record == nullptr || !is_movable(*record)
+            || std::chrono::steady_clock::now() - t_start >= m_time_budget)
+        {
+            move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+            continue;
+        }
+
+        moves.push_back(Move{
+            .move      = &move,
+            .old_image = std::get<Image*>(record->owner)->m_image,
+            .new_image = create_moved_image(
+                m_device, allocator, move.dstTmpAllocation, *record
+            ),
+        });
+        record->moving = true;
+    }
+
+    // Nothing that may be moved is in the way, look again later
+    if (moves.empty()) {
+        static_cast<void>(vmaEndDefragmentationPass(allocator, m_context, &pass_info));
+        end_defragmentation();
+        return;
+    }
+
+    std::vector<vk::UniqueCommandBuffer> command_buffers{
+        m_device.allocateCommandBuffersUnique(vk::CommandBufferAllocateInfo{
+            .commandPool        = m_command_pool.get(),
+            .level              = vk::CommandBufferLevel::ePrimary,
+            .commandBufferCount = 1,
+        })
+    };
+    vk::UniqueCommandBuffer command_buffer{ std::move(command_buffers.front()) };
+
+    command_buffer->begin(vk::CommandBufferBeginInfo{
+        .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+    });
+    record_copies(command_buffer.get(), moves);
+    command_buffer->end();
+
+    vk::UniqueFence fence{ m_device.createFenceUnique(vk::FenceCreateInfo{}) };
+    m_queue.submit(
+        vk::SubmitInfo{
+            .commandBufferCount = 1,
+            .pCommandBuffers    = &command_buffer.get(),
+        },
+        fence.get()
+    );
+
+    m_pass = Pass{
+        .info                 = pass_info,
+        .moves                = std::move(moves),
+        .command_buffer       = std::move(command_buffer),
+        .fence                = std::move(fence),
+        .frames_until_retired = std::nullopt,
+    };
+}
+
+auto Defragmenter::record_copies(
+    const vk::CommandBuffer     t_command_buffer,
+    const std::span<const Move> t_moves
+) const -> void
+{
+    const VmaAllocator allocator{ m_allocator.get().get() };
+
+    std::vector<vk::ImageMemoryBarrier> before_barriers;
+    std::vector<vk::ImageMemoryBarrier> after_barriers;
+    for (const Move& move : t_moves) {
+        const AllocationRecord& record{
+            *AllocationRecord::get(allocator, move.move->srcAllocation)
+        };
+        const auto& create_info{ std::get<vk::ImageCreateInfo>(record.create_info) };
+        const vk::ImageSubresourceRange subresource_range{
+            .aspectMask     = aspect_flags(create_info.format),
+            .baseMipLevel   = 0,
+            .levelCount     = create_info.mipLevels,
+            .baseArrayLayer = 0,
+            .layerCount     = create_info.arrayLayers,
+        };
+
+        before_barriers.push_back(vk::ImageMemoryBarrier{
+            .srcAccessMask       = vk::AccessFlagBits::eMemoryWrite,
+            .dstAccessMask       = vk::AccessFlagBits::eTransferRead,
+            .oldLayout           = record.layout,
+            .newLayout           = vk::ImageLayout::eTransferSrcOptimal,
+            .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+            .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+            .image               = move.old_image,
+            .subresourceRange    = subresource_range,
+        });
+        before_barriers.push_back(vk::ImageMemoryBarrier{
+            .dstAccessMask       = vk::AccessFlagBits::eTransferWrite,
+            .oldLayout           = vk::ImageLayout::eUndefined,
+            .newLayout           = vk::ImageLayout::eTransferDstOptimal,
+            .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+            .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+            .image               = move.new_image,
+            .subresourceRange    = subresource_range,
+        });
+        // The old image is read by the frames recorded before the handles are swapped
+        after_barriers.push_back(vk::ImageMemoryBarrier{
+            .srcAccessMask       = vk::AccessFlagBits::eTransferRead,
+            .dstAccessMask       = vk::AccessFlagBits::eMemoryRead,
+            .oldLayout           = vk::ImageLayout::eTransferSrcOptimal,
+            .newLayout           = record.layout,
+            .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+            .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+            .image               = move.old_image,
+            .subresourceRange    = subresource_range,
+        });
+        after_barriers.push_back(vk::ImageMemoryBarrier{
+            .srcAccessMask       = vk::AccessFlagBits::eTransferWrite,
+            .dstAccessMask       = vk::AccessFlagBits::eMemoryRead,
+            .oldLayout           = vk::ImageLayout::eTransferDstOptimal,
+            .newLayout           = record.layout,
+            .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+            .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+            .image               = move.new_image,
+            .subresourceRange    = subresource_range,
+        });
+    }
+
+    t_command_buffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eAllCommands,
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::DependencyFlags{},
+        nullptr,
+        nullptr,
+        before_barriers
+    );
+
+    for (const Move& move : t_moves) {
+        const AllocationRecord& record{
+            *AllocationRecord::get(allocator, move.move->srcAllocation)
+        };
+
+        const auto& create_info{ std::get<vk::ImageCreateInfo>(record.create_info) };
+        const std::vector regions{
+            std::views::iota(0u, create_info.mipLevels)
+            | std::views::transform([&create_info](const uint32_t mip_level) {
+                  const vk::ImageSubresourceLayers subresource{
+                      .aspectMask     = aspect_flags(create_info.format),
+                      .mipLevel       = mip_level,
+                      .baseArrayLayer = 0,
+                      .layerCount     = create_info.arrayLayers,
+                  };
+                  return vk::ImageCopy{
+                      .srcSubresource = subresource,
+                      .dstSubresource = subresource,
+                      .extent         = mip_extent(create_info.extent, mip_level),
+                  };
+              })
+            | std::ranges::to<std::vector>()
+        };
+        t_command_buffer.copyImage(
+            move.old_image,
+            vk::ImageLayout::eTransferSrcOptimal,
+            move.new_image,
+            vk::ImageLayout::eTransferDstOptimal,
+            regions
+        );
+    }
+
+    t_command_buffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eAllCommands,
+        vk::DependencyFlags{},
+        nullptr,
+        nullptr,
+        after_barriers
+    );
+}
+
+auto Defragmenter::swap_handles() -> Relocations
+{
+    const VmaAllocator allocator{ m_allocator.get().get() };
+
+    Relocations relocations;
+    for (const Move& move : m_pass->moves) {
+        const AllocationRecord& record{
+            *AllocationRecord::get(allocator, move.move->srcAllocation)
+        };
+
+        // Orphaned images have no owner to hand the new handle to
+        if (Image* const* image{ std::get_if<Image*>(&record.owner) }; image != nullptr) {
+            (*image)->m_image = move.new_image;
+            relocations.images.push_back(ImageRelocation{
+                .old_image = move.old_image,
+                .new_image = move.new_image,
+            });
+        }
+    }
+
+    return relocations;
+}
+
+auto Defragmenter::retire_pass() -> void
+{
+    const VmaAllocator allocator{ m_allocator.get().get() };
+
+    for (const Move& move : m_pass->moves) {
+        AllocationRecord* record{
+            AllocationRecord::get(allocator, move.move->srcAllocation)
+        };
+
+        m_device.destroyImage(move.old_image);
+        record->moving = false;
+
+        // Freed by VMA along with the memory it was moved to
+        if (record->orphaned) {
+            m_device.destroyImage(move.new_image);
+            move.move->operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_DESTROY;
+            const std::unique_ptr<AllocationRecord> owned_record{ record };
+        }
+    }
+
+    const vk::Result result{
+        vmaEndDefragmentationPass(allocator, m_context, &m_pass->info)
+    };
+    m_pass.reset();
+
+    if (result == vk::Result::eSuccess) {
+        end_defragmentation();
+    }
+}
+
+auto Defragmenter::end_defragmentation() -> void
+{
+    vmaEndDefragmentation(m_allocator.get().get(), m_context, nullptr);
+    m_context    = nullptr;
+    m_next_start = std::chrono::steady_clock::now() + s_idle_interval;
+}
+
+}   // namespace core::renderer
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include <vk_mem_alloc.h>
+
+#include "Image.hpp"
+
+namespace core::renderer {
+
+class Allocator;
+class Device;
+
+// Compacts device memory incrementally, a few moves per frame.
+// Only images whose owner called allow_moves() are moved. The copies run on the
+// graphics queue, then the owning Image objects get their new handles.
+// Buffers stay where they are, as their device addresses are baked into other buffers.
+// Not thread-safe.
+class Defragmenter {
+public:
+    ///------------------///
+    ///  Nested classes  ///
+    ///------------------///
+    struct ImageRelocation {
+        vk::Image old_image;
+        vk::Image new_image;
+    };
+
+    // Views and descriptors referring to the old handles
+    // have to be recreated by their owners
+    struct Relocations {
+        std::vector<ImageRelocation> images;
+    };
+
+    constexpr static std::chrono::microseconds s_default_time_budget{ 500 };
+    constexpr static vk::DeviceSize s_default_max_bytes_per_pass{ 16ull * 1024 * 1024 };
+    // Delay before looking for new moves once the memory is compact
+    constexpr static std::chrono::seconds s_idle_interval{ 5 };
+
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    // Compacts the given custom pool, or the default pools if it is null
+    explicit Defragmenter(
+        const Device&             t_device,
+        const Allocator&          t_allocator,
+        uint32_t                  t_frame_count,
+        std::chrono::microseconds t_time_budget        = s_default_time_budget,
+        vk::DeviceSize            t_max_bytes_per_pass = s_default_max_bytes_per_pass,
+        VmaPool                   t_pool               = nullptr
+    );
+    Defragmenter(const Defragmenter&) = delete;
+    Defragmenter(Defragmenter&&) noexcept;
+    ~Defragmenter();
+
+    ///-------------///
+    ///  Operators  ///
+    ///-------------///
+    auto operator=(const Defragmenter&) -> Defragmenter& = delete;
+    auto operator=(Defragmenter&&) -> Defragmenter&      = delete;
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    // Movable images have to stay in the given layout
+    static auto allow_moves(const Image& t_image, vk::ImageLayout t_layout) noexcept
+        -> void;
+
+    // Call it once every frame, after waiting for the frame's fence.
+    // Returns the resources whose handles were swapped in this call.
+    // Old handles are destroyed frame_count calls later.
+    [[nodiscard]]
+    auto update() -> Relocations;
+
+    // Waits for the copies in flight and ends the current defragmentation
+    auto finish() -> void;
+
+private:
+    ///******************///
+    ///  Nested classes  ///
+    ///******************///
+    struct Move {
+        // Points into the move info of the pass
+        VmaDefragmentationMove* move;
+        vk::Image               old_image;
+        vk::Image               new_image;
+    };
+
+    struct Pass {
+        VmaDefragmentationPassMoveInfo info;
+        std::vector<Move>              moves;
+        vk::UniqueCommandBuffer        command_buffer;
+        vk::UniqueFence                fence;
+        // Counts down once the handles have been swapped
+        std::optional<uint32_t>        frames_until_retired;
+    };
+
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    vk::Device                              m_device;
+    std::reference_wrapper<const Allocator> m_allocator;
+    vk::Queue                               m_queue;
+    vk::UniqueCommandPool                   m_command_pool;
+    uint32_t                                m_frame_count;
+    std::chrono::microseconds               m_time_budget;
+    vk::DeviceSize                          m_max_bytes_per_pass;
+    VmaPool                                 m_pool;
+
+    VmaDefragmentationContext             m_context{};
+    std::optional<Pass>                   m_pass;
+    std::chrono::steady_clock::time_point m_next_start;
+
+    ///***********///
+    ///  Methods  ///
+    ///***********///
+    auto begin_pass(std::chrono::steady_clock::time_point t_start) -> void;
+    auto record_copies(vk::CommandBuffer t_command_buffer, std::span<const Move> t_moves)
+        const -> void;
+    [[nodiscard]]
+    auto swap_handles() -> Relocations;
+    auto retire_pass() -> void;
+    auto end_defragmentation() -> void;
+};
+
+}   // namespace core::renderer
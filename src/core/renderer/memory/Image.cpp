@@ -1,5 +1,7 @@
 #include "Image.hpp"
 
+#include "AllocationRecord.hpp"
+
 namespace core::renderer {
 
 Image::Image(
@@ -10,7 +12,9 @@ Image::Image(
     : m_image{ t_image },
       m_allocation{ t_allocation },
       m_allocator{ t_allocator }
-{}
+{
+    AllocationRecord::set_owner(m_allocator, m_allocation, this);
+}
 
 Image::Image(Image&& t_other) noexcept
     : Image{ std::exchange(t_other.m_image, nullptr),
@@ -31,6 +35,8 @@ auto Image::operator=(Image&& t_other) noexcept -> Image&
         m_allocator  = std::exchange(t_other.m_allocator, nullptr);
         m_image      = std::exchange(t_other.m_image, nullptr);
         m_allocation = std::exchange(t_other.m_allocation, nullptr);
+
+        AllocationRecord::set_owner(m_allocator, m_allocation, this);
     }
     return *this;
 }
@@ -50,9 +56,15 @@ auto Image::allocation() const noexcept -> VmaAllocation
     return m_allocation;
 }
 
+auto Image::allocator() const noexcept -> VmaAllocator
+{
+    return m_allocator;
+}
+
 auto Image::reset() noexcept -> void
 {
-    if (m_allocator != nullptr) {
+    // Allocations in the middle of a move are freed by the Defragmenter
+    if (m_allocator != nullptr && AllocationRecord::release(m_allocator, m_allocation)) {
         vmaDestroyImage(m_allocator, m_image, m_allocation);
     }
     m_allocation = nullptr;
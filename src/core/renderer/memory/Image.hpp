@@ -36,9 +36,15 @@ public:
 
     [[nodiscard]]
     auto allocation() const noexcept -> VmaAllocation;
+    [[nodiscard]]
+    auto allocator() const noexcept -> VmaAllocator;
+
     auto reset() noexcept -> void;
 
 private:
+    // Swaps the handle for the one bound to the new memory
+    friend class Defragmenter;
+
     ///*************///
     ///  Variables  ///
     ///*************///
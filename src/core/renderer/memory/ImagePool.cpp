@@ -0,0 +1,115 @@
+#include "ImagePool.hpp"
+
+#include "core/renderer/base/allocator/Allocator.hpp"
+
+constexpr static VmaAllocationCreateInfo g_allocation_create_info{
+    .usage    = VMA_MEMORY_USAGE_AUTO,
+    .priority = 1.f,
+};
+
+[[nodiscard]]
+static auto find_memory_type_index(
+    const VmaAllocator         t_allocator,
+    const vk::ImageCreateInfo& t_image_create_info
+) -> uint32_t
+{
+    uint32_t         memory_type_index{};
+    const vk::Result result{ vmaFindMemoryTypeIndexForImageInfo(
+        t_allocator,
+        reinterpret_cast<const VkImageCreateInfo*>(&t_image_create_info),
+        &g_allocation_create_info,
+        &memory_type_index
+    ) };
+    vk::resultCheck(result, "vmaFindMemoryTypeIndexForImageInfo failed");
+
+    return memory_type_index;
+}
+
+[[nodiscard]]
+static auto create_pool(
+    const VmaAllocator   t_allocator,
+    const uint32_t       t_memory_type_index,
+    const vk::DeviceSize t_block_size
+) -> VmaPool
+{
+    const VmaPoolCreateInfo pool_create_info{
+        .memoryTypeIndex = t_memory_type_index,
+        .blockSize       = t_block_size,
+        .priority        = g_allocation_create_info.priority,
+    };
+
+    VmaPool          pool{};
+    const vk::Result result{ vmaCreatePool(t_allocator, &pool_create_info, &pool) };
+    vk::resultCheck(result, "vmaCreatePool failed");
+
+    return pool;
+}
+
+namespace core::renderer {
+
+ImagePool::ImagePool(
+    const Allocator&           t_allocator,
+    const vk::ImageCreateInfo& t_example_image_create_info,
+    const vk::DeviceSize       t_block_size
+)
+    : m_allocator{ t_allocator },
+      m_memory_type_index{
+          find_memory_type_index(t_allocator.get(), t_example_image_create_info)
+      },
+      m_pool{ create_pool(t_allocator.get(), m_memory_type_index, t_block_size) }
+{}
+
+ImagePool::ImagePool(ImagePool&& t_other) noexcept
+    : m_allocator{ t_other.m_allocator },
+      m_memory_type_index{ t_other.m_memory_type_index },
+      m_pool{ std::exchange(t_other.m_pool, nullptr) }
+{}
+
+ImagePool::~ImagePool() noexcept
+{
+    reset();
+}
+
+auto ImagePool::operator=(ImagePool&& t_other) noexcept -> ImagePool&
+{
+    if (this != &t_other) {
+        reset();
+
+        m_allocator         = t_other.m_allocator;
+        m_memory_type_index = t_other.m_memory_type_index;
+        m_pool              = std::exchange(t_other.m_pool, nullptr);
+    }
+    return *this;
+}
+
+auto ImagePool::get() const noexcept -> VmaPool
+{
+    return m_pool;
+}
+
+auto ImagePool::allocate_image(const vk::ImageCreateInfo& t_image_create_info) const
+    -> Image
+{
+    if (find_memory_type_index(m_allocator.get().get(), t_image_create_info)
+        != m_memory_type_index)
+    {
+        return m_allocator.get().allocate_image(
+            t_image_create_info, g_allocation_create_info
+        );
+    }
+
+    VmaAllocationCreateInfo allocation_create_info{ g_allocation_create_info };
+    allocation_create_info.pool = m_pool;
+
+    return m_allocator.get().allocate_image(t_image_create_info, allocation_create_info);
+}
+
+auto ImagePool::reset() noexcept -> void
+{
+    if (m_pool != nullptr) {
+        vmaDestroyPool(m_allocator.get().get(), m_pool);
+        m_pool = nullptr;
+    }
+}
+
+}   // namespace core::renderer
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <functional>
+
+#include <vulkan/vulkan.hpp>
+
+#include <vk_mem_alloc.h>
+
+#include "Image.hpp"
+
+namespace core::renderer {
+
+class Allocator;
+
+// A VMA custom pool sub-allocating images from large memory blocks,
+// so that small textures do not each get a vkAllocateMemory of their own.
+// The pool has to outlive the images allocated from it.
+class ImagePool {
+public:
+    constexpr static vk::DeviceSize s_default_block_size{ 64ull * 1024 * 1024 };
+
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    // The memory type is picked for images like the example one
+    explicit ImagePool(
+        const Allocator&           t_allocator,
+        const vk::ImageCreateInfo& t_example_image_create_info,
+        vk::DeviceSize             t_block_size = s_default_block_size
+    );
+    ImagePool(const ImagePool&) = delete;
+    ImagePool(ImagePool&&) noexcept;
+    ~ImagePool() noexcept;
+
+    ///-------------///
+    ///  Operators  ///
+    ///-------------///
+    auto operator=(const ImagePool&) -> ImagePool& = delete;
+    auto operator=(ImagePool&&) noexcept -> ImagePool&;
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    [[nodiscard]]
+    auto get() const noexcept -> VmaPool;
+
+    // Images preferring another memory type are allocated outside the pool
+    [[nodiscard]]
+    auto allocate_image(const vk::ImageCreateInfo& t_image_create_info) const -> Image;
+
+    auto reset() noexcept -> void;
+
+private:
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    std::reference_wrapper<const Allocator> m_allocator;
+    uint32_t                                m_memory_type_index;
+    VmaPool                                 m_pool;
+};
+
+}   // namespace core::renderer
@@ -0,0 +1,100 @@
+#include "MappedBuffer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace core::renderer {
+
+MappedBuffer::MappedBuffer(
+    const vk::Buffer    t_buffer,
+    const VmaAllocation t_allocation,
+    const VmaAllocator  t_allocator
+) noexcept
+    : Buffer{ t_buffer, t_allocation, t_allocator }
+{
+    VmaAllocationInfo allocation_info;
+    vmaGetAllocationInfo(t_allocator, t_allocation, &allocation_info);
+    m_data = static_cast<std::byte*>(allocation_info.pMappedData);
+    m_size = allocation_info.size;
+
+    VkMemoryPropertyFlags memory_property_flags{};
+    vmaGetAllocationMemoryProperties(t_allocator, t_allocation, &memory_property_flags);
+    m_coherent = (memory_property_flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+}
+
+auto MappedBuffer::data() const noexcept -> void*
+{
+    return m_data;
+}
+
+auto MappedBuffer::size() const noexcept -> vk::DeviceSize
+{
+    return m_size;
+}
+
+auto MappedBuffer::mark_dirty(const vk::DeviceSize t_offset, const vk::DeviceSize t_size)
+    const noexcept -> void
+{
+    if (m_data == nullptr || m_coherent || t_size == 0) {
+        return;
+    }
+
+    m_dirty_begin = std::min(m_dirty_begin, t_offset);
+    m_dirty_end   = std::max(m_dirty_end, t_offset + t_size);
+}
+
+auto MappedBuffer::flush_dirty() const -> void
+{
+    flush_dirty(std::array{ std::cref(*this) });
+}
+
+auto MappedBuffer::flush_dirty(
+    const std::span<const std::reference_wrapper<const MappedBuffer>> t_buffers
+) -> void
+{
+    std::vector<VmaAllocation>  allocations;
+    std::vector<vk::DeviceSize> offsets;
+    std::vector<vk::DeviceSize> sizes;
+    for (const MappedBuffer& buffer : t_buffers) {
+        if (buffer.m_dirty_begin < buffer.m_dirty_end) {
+            allocations.push_back(buffer.allocation());
+            offsets.push_back(buffer.m_dirty_begin);
+            sizes.push_back(buffer.m_dirty_end - buffer.m_dirty_begin);
+            buffer.clear_dirty();
+        }
+    }
+    if (allocations.empty()) {
+        return;
+    }
+
+    const MappedBuffer& first_buffer{ t_buffers.front() };
+    vk::resultCheck(
+        vk::Result{ vmaFlushAllocations(
+            first_buffer.allocator(),
+            static_cast<uint32_t>(allocations.size()),
+            allocations.data(),
+            offsets.data(),
+            sizes.data()
+        ) },
+        "vmaFlushAllocations failed"
+    );
+}
+
+auto MappedBuffer::flush(const vk::DeviceSize t_offset, const vk::DeviceSize t_size) const
+    -> void
+{
+    // VMA skips host-coherent memory types
+    vk::resultCheck(
+        vk::Result{ vmaFlushAllocation(allocator(), allocation(), t_offset, t_size) },
+        "vmaFlushAllocation failed"
+    );
+}
+
+auto MappedBuffer::clear_dirty() const noexcept -> void
+{
+    m_dirty_begin = std::numeric_limits<vk::DeviceSize>::max();
+    m_dirty_end   = 0;
+}
+
+}   // namespace core::renderer
@@ -1,15 +1,79 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <span>
+
 #include "Buffer.hpp"
 
 namespace core::renderer {
 
+// Stays mapped for its whole lifetime.
+// Writes are gathered into one dirty range, which flush_dirty() hands to the driver
+// if the memory is not host-coherent. The mapping is cached,
+// so the buffer must not be given to the Defragmenter.
 class MappedBuffer : public Buffer {
 public:
-    using Buffer::Buffer;
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    MappedBuffer() = default;
+    explicit MappedBuffer(
+        vk::Buffer    t_buffer,
+        VmaAllocation t_allocation,
+        VmaAllocator  t_allocator
+    ) noexcept;
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    [[nodiscard]]
+    auto data() const noexcept -> void*;
+    // Size of the mapped memory, at least the size of the buffer
+    [[nodiscard]]
+    auto size() const noexcept -> vk::DeviceSize;
+
+    // Writes through the span have to be reported with mark_dirty()
+    template <typename T>
+    [[nodiscard]]
+    auto span() const noexcept -> std::span<T>;
+
+    template <typename T>
+    auto set(const T& t_data, vk::DeviceSize t_offset = 0) const -> void;
+    template <typename T>
+    auto write(std::span<const T> t_data, vk::DeviceSize t_offset = 0) const -> void;
+
+    auto mark_dirty(vk::DeviceSize t_offset, vk::DeviceSize t_size) const noexcept
+        -> void;
+
+    // Flushes everything written since the previous flush
+    auto flush_dirty() const -> void;
+    // The same with a single vmaFlushAllocations call,
+    // the buffers have to come from the same allocator
+    static auto flush_dirty(
+        std::span<const std::reference_wrapper<const MappedBuffer>> t_buffers
+    ) -> void;
+
+    auto flush(vk::DeviceSize t_offset = 0, vk::DeviceSize t_size = VK_WHOLE_SIZE) const
+        -> void;
+
+private:
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    std::byte*     m_data{};
+    vk::DeviceSize m_size{};
+    bool           m_coherent{};
+
+    // Writing through a const buffer is fine, only the bookkeeping changes
+    mutable vk::DeviceSize m_dirty_begin{ std::numeric_limits<vk::DeviceSize>::max() };
+    mutable vk::DeviceSize m_dirty_end{};
 
-    template<typename T>
-    auto set(const T& t_data) const -> void;
+    ///***********///
+    ///  Methods  ///
+    ///***********///
+    auto clear_dirty() const noexcept -> void;
 };
 
 }   // namespace core::renderer
@@ -1,13 +1,33 @@
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
 namespace core::renderer {
 
 template <typename T>
-auto MappedBuffer::set(const T& t_data) const -> void
+auto MappedBuffer::span() const noexcept -> std::span<T>
+{
+    static_assert(std::is_trivially_copyable_v<std::remove_const_t<T>>);
+
+    return std::span<T>{ reinterpret_cast<T*>(m_data),
+                         static_cast<size_t>(m_size / sizeof(T)) };
+}
+
+template <typename T>
+auto MappedBuffer::set(const T& t_data, const vk::DeviceSize t_offset) const -> void
 {
-    vk::resultCheck(
-        vk::Result{
-            vmaCopyMemoryToAllocation(allocator(), &t_data, allocation(), 0, sizeof(T)) },
-        "vmaCopyMemoryToAllocation failed"
-    );
+    write<T>(std::span{ &t_data, 1 }, t_offset);
+}
+
+template <typename T>
+auto MappedBuffer::write(const std::span<const T> t_data, const vk::DeviceSize t_offset)
+    const -> void
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    assert(t_offset + t_data.size_bytes() <= m_size);
+
+    std::memcpy(m_data + t_offset, t_data.data(), t_data.size_bytes());
+    mark_dirty(t_offset, t_data.size_bytes());
 }
 
 }   // namespace core::renderer
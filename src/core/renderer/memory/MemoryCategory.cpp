@@ -0,0 +1,68 @@
+#include "MemoryCategory.hpp"
+
+namespace core::renderer {
+
+auto to_string(const MemoryCategory t_category) noexcept -> std::string_view
+{
+    switch (t_category) {
+        case MemoryCategory::eVertex: return "vertex";
+        case MemoryCategory::eIndex: return "index";
+        case MemoryCategory::eTexture: return "texture";
+        case MemoryCategory::eStaging: return "staging";
+        case MemoryCategory::eUniform: return "uniform";
+        case MemoryCategory::eOther: return "other";
+    }
+    return "other";
+}
+
+auto memory_category(const vk::BufferUsageFlags t_usage) noexcept -> MemoryCategory
+{
+    using enum vk::BufferUsageFlagBits;
+
+    if (t_usage & eUniformBuffer) {
+        return MemoryCategory::eUniform;
+    }
+    if (t_usage == eTransferSrc) {
+        return MemoryCategory::eStaging;
+    }
+    if (t_usage & (eVertexBuffer | eStorageBuffer)) {
+        return MemoryCategory::eVertex;
+    }
+    if (t_usage & eIndexBuffer) {
+        return MemoryCategory::eIndex;
+    }
+    return MemoryCategory::eOther;
+}
+
+auto memory_category(const vk::ImageUsageFlags t_usage) noexcept -> MemoryCategory
+{
+    if (t_usage & vk::ImageUsageFlagBits::eSampled) {
+        return MemoryCategory::eTexture;
+    }
+    return MemoryCategory::eOther;
+}
+
+auto MemoryCategoryTotals::track(
+    const VmaAllocator   t_allocator,
+    const VmaAllocation  t_allocation,
+    const MemoryCategory t_category
+) -> std::atomic<vk::DeviceSize>&
+{
+    std::atomic<vk::DeviceSize>& counter{ m_bytes[static_cast<size_t>(t_category)] };
+
+    VmaAllocationInfo allocation_info;
+    vmaGetAllocationInfo(t_allocator, t_allocation, &allocation_info);
+    counter += allocation_info.size;
+
+    vmaSetAllocationName(t_allocator, t_allocation, to_string(t_category).data());
+
+    return counter;
+}
+
+auto MemoryCategoryTotals::get(const MemoryCategory t_category) const noexcept
+    -> vk::DeviceSize
+{
+    return m_bytes[static_cast<size_t>(t_category)];
+}
+
+}   // namespace core::renderer
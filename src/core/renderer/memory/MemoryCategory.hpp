@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <string_view>
+
+#include <vulkan/vulkan.hpp>
+
+#include <vk_mem_alloc.h>
+
+namespace core::renderer {
+
+// What an allocation holds, derived from its usage flags when it is made
+enum class MemoryCategory : uint8_t {
+    eVertex,   // Vertices and other geometry read through storage buffers
+    eIndex,
+    eTexture,
+    eStaging,
+    eUniform,
+    eOther,    // Attachments and anything else
+};
+
+inline constexpr size_t g_memory_category_count{ 6 };
+
+[[nodiscard]]
+auto to_string(MemoryCategory t_category) noexcept -> std::string_view;
+
+[[nodiscard]]
+auto memory_category(vk::BufferUsageFlags t_usage) noexcept -> MemoryCategory;
+[[nodiscard]]
+auto memory_category(vk::ImageUsageFlags t_usage) noexcept -> MemoryCategory;
+
+// Bytes allocated in each category
+class MemoryCategoryTotals {
+public:
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    // Adds the allocation to its category and names it after it.
+    // Take it off the returned counter when freeing the allocation.
+    auto track(
+        VmaAllocator   t_allocator,
+        VmaAllocation  t_allocation,
+        MemoryCategory t_category
+    ) -> std::atomic<vk::DeviceSize>&;
+
+    [[nodiscard]]
+    auto get(MemoryCategory t_category) const noexcept -> vk::DeviceSize;
+
+private:
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    std::array<std::atomic<vk::DeviceSize>, g_memory_category_count> m_bytes{};
+};
+
+}   // namespace core::renderer
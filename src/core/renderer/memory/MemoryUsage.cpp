@@ -0,0 +1,37 @@
+#include "MemoryUsage.hpp"
+
+namespace core::renderer {
+
+auto allocation_create_info(const MemoryUsage t_usage) noexcept -> VmaAllocationCreateInfo
+{
+    switch (t_usage) {
+        case MemoryUsage::eDeviceOnly:
+            return VmaAllocationCreateInfo{
+                .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+            };
+        case MemoryUsage::eUploadDirect:
+            return VmaAllocationCreateInfo{
+                .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT
+                       | VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT
+                       | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+                .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+            };
+        case MemoryUsage::eStaging:
+            return VmaAllocationCreateInfo{
+                .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT
+                       | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+                .usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+            };
+        case MemoryUsage::eReadback:
+            return VmaAllocationCreateInfo{
+                .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT
+                       | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+                .usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+            };
+    }
+    return VmaAllocationCreateInfo{
+        .usage = VMA_MEMORY_USAGE_AUTO,
+    };
+}
+
+}   // namespace core::renderer
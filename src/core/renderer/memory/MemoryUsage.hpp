@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+#include <vk_mem_alloc.h>
+
+namespace core::renderer {
+
+// How the CPU and the GPU access a buffer
+enum class MemoryUsage : uint8_t {
+    eDeviceOnly,     // Filled by transfers or shaders
+    eUploadDirect,   // Device-local, mapped where that memory is host-visible
+    eStaging,        // Written by the CPU once, read by transfers
+    eReadback,       // Written by the GPU, read by the CPU
+};
+
+// eUploadDirect prefers host-visible device-local memory (resizable BAR, UMA)
+// and falls back to unmapped device-local memory, which has to be staged
+[[nodiscard]]
+auto allocation_create_info(MemoryUsage t_usage) noexcept -> VmaAllocationCreateInfo;
+
+}   // namespace core::renderer
@@ -0,0 +1,180 @@
+#include "StagingRing.hpp"
+
+#include <cstring>
+#include <limits>
+
+#include "core/renderer/base/allocator/Allocator.hpp"
+
+[[nodiscard]]
+static auto align_up(const uint64_t t_value, const uint64_t t_alignment) noexcept
+    -> uint64_t
+{
+    return (t_value + t_alignment - 1) / t_alignment * t_alignment;
+}
+
+namespace core::renderer {
+
+StagingRing::StagingRing(
+    const vk::Device     t_device,
+    const Allocator&     t_allocator,
+    const vk::DeviceSize t_capacity
+)
+    : m_device{ t_device },
+      m_allocator{ t_allocator },
+      m_buffer{ t_allocator.allocate_mapped_buffer(vk::BufferCreateInfo{
+          .size  = t_capacity,
+          .usage = vk::BufferUsageFlagBits::eTransferSrc,
+      }) },
+      m_mapping{ static_cast<std::byte*>(m_buffer.data()) },
+      m_capacity{ t_capacity }
+{}
+
+auto StagingRing::allocate(const vk::DeviceSize t_size, const vk::DeviceSize t_alignment)
+    -> Region
+{
+    reclaim();
+
+    while (true) {
+        if (std::optional<Region> region{ try_allocate(t_size, t_alignment) };
+            region.has_value())
+        {
+            return region.value();
+        }
+        if (m_submissions.empty() || t_size > m_capacity) {
+            break;
+        }
+        wait(m_submissions.front());
+        reclaim();
+    }
+
+    const MappedBuffer& buffer{
+        m_dedicated_buffers.emplace_back(m_allocator.get().allocate_mapped_buffer(
+            vk::BufferCreateInfo{
+                .size  = t_size,
+                .usage = vk::BufferUsageFlagBits::eTransferSrc,
+            }
+        ))
+    };
+    return Region{
+        .buffer = buffer.get(),
+        .offset = 0,
+        .data   = std::span{ static_cast<std::byte*>(buffer.data()), t_size },
+    };
+}
+
+auto StagingRing::upload(
+    const std::span<const std::byte> t_data,
+    const vk::DeviceSize             t_alignment
+) -> Region
+{
+    const Region region{ allocate(t_data.size(), t_alignment) };
+    std::memcpy(region.data.data(), t_data.data(), t_data.size());
+    return region;
+}
+
+auto StagingRing::flush() const -> void
+{
+    m_buffer.flush();
+    for (const MappedBuffer& buffer : m_dedicated_buffers) {
+        buffer.flush();
+    }
+}
+
+auto StagingRing::submit(const vk::Fence t_fence) -> void
+{
+    m_submissions.push_back(Submission{
+        .end               = m_head,
+        .dedicated_buffers = std::exchange(m_dedicated_buffers, {}),
+        .signal            = t_fence,
+    });
+}
+
+auto StagingRing::submit(const TimelinePoint& t_timeline_point) -> void
+{
+    m_submissions.push_back(Submission{
+        .end               = m_head,
+        .dedicated_buffers = std::exchange(m_dedicated_buffers, {}),
+        .signal            = t_timeline_point,
+    });
+}
+
+auto StagingRing::reclaim() -> void
+{
+    while (!m_submissions.empty() && is_finished(m_submissions.front())) {
+        m_tail = m_submissions.front().end;
+        m_submissions.pop_front();
+    }
+}
+
+auto StagingRing::capacity() const noexcept -> vk::DeviceSize
+{
+    return m_capacity;
+}
+
+auto StagingRing::try_allocate(
+    const vk::DeviceSize t_size,
+    const vk::DeviceSize t_alignment
+) -> std::optional<Region>
+{
+    const uint64_t position{ m_head % m_capacity };
+    uint64_t       padding{ align_up(position, t_alignment) - position };
+    // Regions are contiguous, so the unused end of the buffer is skipped
+    if (position + padding + t_size > m_capacity) {
+        padding = m_capacity - position;
+    }
+
+    if (m_head + padding + t_size - m_tail > m_capacity) {
+        return std::nullopt;
+    }
+
+    const vk::DeviceSize offset{ (m_head + padding) % m_capacity };
+    m_head += padding + t_size;
+
+    return Region{
+        .buffer = m_buffer.get(),
+        .offset = offset,
+        .data   = std::span{ m_mapping + offset, t_size },
+    };
+}
+
+auto StagingRing::is_finished(const Submission& t_submission) const -> bool
+{
+    return std::visit(
+        [this]<typename Signal>(const Signal& signal) -> bool {
+            if constexpr (std::is_same_v<Signal, vk::Fence>) {
+                return m_device.getFenceStatus(signal) == vk::Result::eSuccess;
+            }
+            else {
+                return m_device.getSemaphoreCounterValue(signal.semaphore)
+                    >= signal.value;
+            }
+        },
+        t_submission.signal
+    );
+}
+
+auto StagingRing::wait(const Submission& t_submission) const -> void
+{
+    std::visit(
+        [this]<typename Signal>(const Signal& signal) {
+            if constexpr (std::is_same_v<Signal, vk::Fence>) {
+                static_cast<void>(m_device.waitForFences(
+                    signal, vk::True, std::numeric_limits<uint64_t>::max()
+                ));
+            }
+            else {
+                const vk::SemaphoreWaitInfo wait_info{
+                    .semaphoreCount = 1,
+                    .pSemaphores    = &signal.semaphore,
+                    .pValues        = &signal.value,
+                };
+                static_cast<void>(m_device.waitSemaphores(
+                    wait_info, std::numeric_limits<uint64_t>::max()
+                ));
+            }
+        },
+        t_submission.signal
+    );
+}
+
+}   // namespace core::renderer
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <span>
+#include <variant>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "MappedBuffer.hpp"
+
+namespace core::renderer {
+
+class Allocator;
+
+// Sub-allocates upload memory from one persistently mapped buffer.
+// Everything handed out since the previous submit() is released together,
+// once the GPU has signaled the fence or timeline value given to it.
+// Not thread-safe.
+class StagingRing {
+public:
+    ///------------------///
+    ///  Nested classes  ///
+    ///------------------///
+    struct Region {
+        vk::Buffer           buffer;
+        vk::DeviceSize       offset;
+        std::span<std::byte> data;
+    };
+
+    struct TimelinePoint {
+        vk::Semaphore semaphore;
+        uint64_t      value;
+    };
+
+    constexpr static vk::DeviceSize s_default_capacity{ 64ull * 1024 * 1024 };
+
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    explicit StagingRing(
+        vk::Device       t_device,
+        const Allocator& t_allocator,
+        vk::DeviceSize   t_capacity = s_default_capacity
+    );
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    // When the ring is full, this waits for the oldest submission first.
+    // Requests that still do not fit get a dedicated buffer for the same lifetime.
+    [[nodiscard]]
+    auto allocate(vk::DeviceSize t_size, vk::DeviceSize t_alignment = 1) -> Region;
+    [[nodiscard]]
+    auto upload(std::span<const std::byte> t_data, vk::DeviceSize t_alignment = 1)
+        -> Region;
+
+    // Makes host writes visible to the device, call it before submitting
+    auto flush() const -> void;
+
+    auto submit(vk::Fence t_fence) -> void;
+    auto submit(const TimelinePoint& t_timeline_point) -> void;
+
+    // Releases the regions of every submission that has finished
+    auto reclaim() -> void;
+
+    [[nodiscard]]
+    auto capacity() const noexcept -> vk::DeviceSize;
+
+private:
+    ///******************///
+    ///  Nested classes  ///
+    ///******************///
+    struct Submission {
+        uint64_t                               end;
+        std::vector<MappedBuffer>              dedicated_buffers;
+        std::variant<vk::Fence, TimelinePoint> signal;
+    };
+
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    vk::Device                              m_device;
+    std::reference_wrapper<const Allocator> m_allocator;
+    MappedBuffer                            m_buffer;
+    std::byte*                              m_mapping;
+    vk::DeviceSize                          m_capacity;
+
+    // Monotonic positions, the physical offset is taken modulo the capacity
+    uint64_t m_head{};
+    uint64_t m_tail{};
+
+    std::vector<MappedBuffer> m_dedicated_buffers;
+    std::deque<Submission>    m_submissions;
+
+    ///***********///
+    ///  Methods  ///
+    ///***********///
+    [[nodiscard]]
+    auto try_allocate(vk::DeviceSize t_size, vk::DeviceSize t_alignment)
+        -> std::optional<Region>;
+
+    [[nodiscard]]
+    auto is_finished(const Submission& t_submission) const -> bool;
+    auto wait(const Submission& t_submission) const -> void;
+};
+
+}   // namespace core::renderer
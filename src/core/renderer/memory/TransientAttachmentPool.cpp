@@ -0,0 +1,271 @@
+#include "TransientAttachmentPool.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <ranges>
+
+#include "core/renderer/base/allocator/Allocator.hpp"
+
+constexpr static vk::ImageUsageFlags g_attachment_usage{
+    vk::ImageUsageFlagBits::eColorAttachment
+    | vk::ImageUsageFlagBits::eDepthStencilAttachment
+    | vk::ImageUsageFlagBits::eInputAttachment
+};
+
+using Attachment = core::renderer::TransientAttachmentPool::Attachment;
+
+[[nodiscard]]
+static auto has_lazily_allocated_memory(const VmaAllocator t_allocator) noexcept -> bool
+{
+    const VkPhysicalDeviceMemoryProperties* memory_properties{};
+    vmaGetMemoryProperties(t_allocator, &memory_properties);
+
+    return std::ranges::any_of(
+        std::span{ memory_properties->memoryTypes }.first(
+            memory_properties->memoryTypeCount
+        ),
+        [](const VkMemoryType& memory_type) {
+            return (memory_type.propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)
+                != 0;
+        }
+    );
+}
+
+[[nodiscard]]
+static auto align_up(
+    const vk::DeviceSize t_value,
+    const vk::DeviceSize t_alignment
+) noexcept -> vk::DeviceSize
+{
+    return (t_value + t_alignment - 1) / t_alignment * t_alignment;
+}
+
+[[nodiscard]]
+static auto lifetimes_overlap(const Attachment& t_lhs, const Attachment& t_rhs) noexcept
+    -> bool
+{
+    return t_lhs.first_pass <= t_rhs.last_pass && t_rhs.first_pass <= t_lhs.last_pass;
+}
+
+// Places the largest images first, each at the lowest offset
+// that is not taken by an already placed image alive at the same time
+[[nodiscard]]
+static auto place_attachments(
+    const std::span<const Attachment>             t_attachments,
+    const std::span<const vk::MemoryRequirements> t_memory_requirements
+) -> std::vector<vk::DeviceSize>
+{
+    std::vector<uint32_t> order{ std::views::iota(0u, t_attachments.size())
+                                 | std::ranges::to<std::vector>() };
+    std::ranges::stable_sort(order, std::ranges::greater{}, [&](const uint32_t index) {
+        return t_memory_requirements[index].size;
+    });
+
+    std::vector<vk::DeviceSize> offsets(t_attachments.size());
+    std::vector<uint32_t>       placed;
+    placed.reserve(order.size());
+
+    for (const uint32_t index : order) {
+        const vk::MemoryRequirements& requirements{ t_memory_requirements[index] };
+
+        const std::vector<uint32_t> conflicts{
+            placed | std::views::filter([&](const uint32_t other) {
+                return lifetimes_overlap(t_attachments[index], t_attachments[other]);
+            })
+            | std::ranges::to<std::vector>()
+        };
+
+        std::vector<vk::DeviceSize> candidates{ 0 };
+        for (const uint32_t other : conflicts) {
+            candidates.push_back(align_up(
+                offsets[other] + t_memory_requirements[other].size, requirements.alignment
+            ));
+        }
+        std::ranges::sort(candidates);
+
+        // The candidate past every conflicting image always fits
+        offsets[index] = *std::ranges::find_if(
+            candidates,
+            [&](const vk::DeviceSize offset) {
+                return std::ranges::none_of(conflicts, [&](const uint32_t other) {
+                    return offset < offsets[other] + t_memory_requirements[other].size
+                        && offsets[other] < offset + requirements.size;
+                });
+            }
+        );
+        placed.push_back(index);
+    }
+
+    return offsets;
+}
+
+namespace core::renderer {
+
+TransientAttachmentPool::TransientAttachmentPool(
+    const vk::Device t_device,
+    const Allocator& t_allocator
+)
+    : m_device{ t_device },
+      m_allocator{ t_allocator },
+      m_lazily_allocated{ has_lazily_allocated_memory(t_allocator.get()) }
+{}
+
+TransientAttachmentPool::TransientAttachmentPool(TransientAttachmentPool&& t_other
+) noexcept
+    : m_device{ t_other.m_device },
+      m_allocator{ t_other.m_allocator },
+      m_lazily_allocated{ t_other.m_lazily_allocated },
+      m_allocation{ std::exchange(t_other.m_allocation, nullptr) },
+      m_memory_size{ std::exchange(t_other.m_memory_size, vk::DeviceSize{}) },
+      m_memory_type_index{ t_other.m_memory_type_index },
+      m_images{ std::move(t_other.m_images) }
+{}
+
+TransientAttachmentPool::~TransientAttachmentPool() noexcept
+{
+    reset();
+}
+
+auto TransientAttachmentPool::operator=(TransientAttachmentPool&& t_other) noexcept
+    -> TransientAttachmentPool&
+{
+    if (this != &t_other) {
+        reset();
+
+        m_device            = t_other.m_device;
+        m_allocator         = t_other.m_allocator;
+        m_lazily_allocated  = t_other.m_lazily_allocated;
+        m_allocation        = std::exchange(t_other.m_allocation, nullptr);
+        m_memory_size       = std::exchange(t_other.m_memory_size, vk::DeviceSize{});
+        m_memory_type_index = t_other.m_memory_type_index;
+        m_images            = std::move(t_other.m_images);
+    }
+    return *this;
+}
+
+auto TransientAttachmentPool::create_attachments(
+    const std::span<const Attachment> t_attachments
+) -> void
+{
+    m_images.clear();
+
+    std::vector<vk::UniqueImage>        images;
+    std::vector<vk::MemoryRequirements> memory_requirements;
+    images.reserve(t_attachments.size());
+    memory_requirements.reserve(t_attachments.size());
+    for (const Attachment& attachment : t_attachments) {
+        vk::ImageCreateInfo create_info{ attachment.create_info };
+        // Only transient images may live in lazily allocated memory
+        if (m_lazily_allocated && !(create_info.usage & ~g_attachment_usage)) {
+            create_info.usage |= vk::ImageUsageFlagBits::eTransientAttachment;
+        }
+
+        images.push_back(m_device.createImageUnique(create_info));
+        memory_requirements.push_back(
+            m_device.getImageMemoryRequirements(images.back().get())
+        );
+    }
+
+    const std::vector<vk::DeviceSize> offsets{
+        place_attachments(t_attachments, memory_requirements)
+    };
+
+    vk::MemoryRequirements total_requirements{
+        .alignment      = 1,
+        .memoryTypeBits = ~0u,
+    };
+    for (const auto& [requirements, offset] :
+         std::views::zip(memory_requirements, offsets))
+    {
+        total_requirements.size =
+            std::max(total_requirements.size, offset + requirements.size);
+        total_requirements.alignment =
+            std::max(total_requirements.alignment, requirements.alignment);
+        total_requirements.memoryTypeBits &= requirements.memoryTypeBits;
+    }
+    reserve(total_requirements);
+
+    for (const auto& [image, offset] : std::views::zip(images, offsets)) {
+        const vk::Result result{ vmaBindImageMemory2(
+            m_allocator.get().get(), m_allocation, offset, image.get(), nullptr
+        ) };
+        vk::resultCheck(result, "vmaBindImageMemory2 failed");
+    }
+
+    m_images = std::move(images);
+}
+
+auto TransientAttachmentPool::image(const uint32_t t_index) const -> vk::Image
+{
+    return m_images.at(t_index).get();
+}
+
+auto TransientAttachmentPool::memory_size() const noexcept -> vk::DeviceSize
+{
+    return m_memory_size;
+}
+
+auto TransientAttachmentPool::lazily_allocated() const noexcept -> bool
+{
+    return m_lazily_allocated;
+}
+
+auto TransientAttachmentPool::reset() noexcept -> void
+{
+    m_images.clear();
+
+    if (m_allocation != nullptr) {
+        vmaFreeMemory(m_allocator.get().get(), m_allocation);
+        m_allocation  = nullptr;
+        m_memory_size = 0;
+    }
+}
+
+auto TransientAttachmentPool::reserve(const vk::MemoryRequirements& t_memory_requirements)
+    -> void
+{
+    if (t_memory_requirements.size == 0) {
+        return;
+    }
+    // Dedicated memory starts at offset 0, so any alignment is satisfied
+    if (m_allocation != nullptr && t_memory_requirements.size <= m_memory_size
+        && (t_memory_requirements.memoryTypeBits & (1u << m_memory_type_index)) != 0)
+    {
+        return;
+    }
+
+    if (m_allocation != nullptr) {
+        vmaFreeMemory(m_allocator.get().get(), m_allocation);
+        m_allocation  = nullptr;
+        m_memory_size = 0;
+    }
+
+    // Lazily allocated memory types are only allowed for transient images,
+    // attachments without them still get plain device local memory
+    const VkMemoryPropertyFlags preferred_flags{
+        m_lazily_allocated ? VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT : 0u
+    };
+    const VmaAllocationCreateInfo allocation_create_info{
+        .flags          = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
+        .requiredFlags  = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        .preferredFlags = preferred_flags,
+        .priority       = 1.f,
+    };
+
+    VmaAllocationInfo allocation_info;
+    const vk::Result  result{ vmaAllocateMemory(
+        m_allocator.get().get(),
+        reinterpret_cast<const VkMemoryRequirements*>(&t_memory_requirements),
+        &allocation_create_info,
+        &m_allocation,
+        &allocation_info
+    ) };
+    vk::resultCheck(result, "vmaAllocateMemory failed");
+
+    vmaSetAllocationName(m_allocator.get().get(), m_allocation, "Transient attachments");
+
+    m_memory_size       = allocation_info.size;
+    m_memory_type_index = allocation_info.memoryType;
+}
+
+}   // namespace core::renderer
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <functional>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include <vk_mem_alloc.h>
+
+namespace core::renderer {
+
+class Allocator;
+
+// One block of memory for attachments that only live within a frame,
+// like depth buffers. It prefers lazily allocated memory where the device has it,
+// and attachments used by disjoint ranges of passes share the same memory.
+// The block is kept when the attachments are recreated, unless it is too small.
+class TransientAttachmentPool {
+public:
+    ///------------------///
+    ///  Nested classes  ///
+    ///------------------///
+    struct Attachment {
+        vk::ImageCreateInfo create_info;
+        // Inclusive range of the passes using the attachment
+        uint32_t            first_pass;
+        uint32_t            last_pass;
+    };
+
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    explicit TransientAttachmentPool(vk::Device t_device, const Allocator& t_allocator);
+    TransientAttachmentPool(const TransientAttachmentPool&) = delete;
+    TransientAttachmentPool(TransientAttachmentPool&&) noexcept;
+    ~TransientAttachmentPool() noexcept;
+
+    ///-------------///
+    ///  Operators  ///
+    ///-------------///
+    auto operator=(const TransientAttachmentPool&) -> TransientAttachmentPool& = delete;
+    auto operator=(TransientAttachmentPool&&) noexcept -> TransientAttachmentPool&;
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    // Replaces the images, the GPU must be done with the previous ones.
+    // Aliased images start out undefined in every pass range,
+    // transition them from eUndefined at their first use.
+    auto create_attachments(std::span<const Attachment> t_attachments) -> void;
+
+    // Indexed like the attachments given to create_attachments()
+    [[nodiscard]]
+    auto image(uint32_t t_index) const -> vk::Image;
+
+    [[nodiscard]]
+    auto memory_size() const noexcept -> vk::DeviceSize;
+    [[nodiscard]]
+    auto lazily_allocated() const noexcept -> bool;
+
+    auto reset() noexcept -> void;
+
+private:
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    vk::Device                              m_device;
+    std::reference_wrapper<const Allocator> m_allocator;
+    bool                                    m_lazily_allocated;
+
+    VmaAllocation                m_allocation{};
+    vk::DeviceSize               m_memory_size{};
+    uint32_t                     m_memory_type_index{};
+    std::vector<vk::UniqueImage> m_images;
+
+    ///***********///
+    ///  Methods  ///
+    ///***********///
+    auto reserve(const vk::MemoryRequirements& t_memory_requirements) -> void;
+};
+
+}   // namespace core::renderer
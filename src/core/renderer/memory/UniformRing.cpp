@@ -0,0 +1,72 @@
+#include "UniformRing.hpp"
+
+#include "core/renderer/base/allocator/Allocator.hpp"
+
+[[nodiscard]]
+static auto min_uniform_buffer_offset_alignment(const VmaAllocator t_allocator
+) noexcept -> vk::DeviceSize
+{
+    const VkPhysicalDeviceProperties* properties{};
+    vmaGetPhysicalDeviceProperties(t_allocator, &properties);
+    return properties->limits.minUniformBufferOffsetAlignment;
+}
+
+[[nodiscard]]
+static auto align_up(
+    const vk::DeviceSize t_value,
+    const vk::DeviceSize t_alignment
+) noexcept -> vk::DeviceSize
+{
+    return (t_value + t_alignment - 1) / t_alignment * t_alignment;
+}
+
+namespace core::renderer {
+
+UniformRing::UniformRing(
+    const Allocator&     t_allocator,
+    const vk::DeviceSize t_slice_size,
+    const uint32_t       t_frame_count
+)
+    : m_slice_size{ t_slice_size },
+      m_stride{ align_up(
+          t_slice_size,
+          min_uniform_buffer_offset_alignment(t_allocator.get())
+      ) },
+      m_frame_count{ t_frame_count },
+      m_buffer{ t_allocator.allocate_mapped_buffer(vk::BufferCreateInfo{
+          .size  = m_stride * t_frame_count,
+          .usage = vk::BufferUsageFlagBits::eUniformBuffer,
+      }) }
+{}
+
+auto UniformRing::flush() const -> void
+{
+    m_buffer.flush_dirty();
+}
+
+auto UniformRing::buffer() const noexcept -> const MappedBuffer&
+{
+    return m_buffer;
+}
+
+auto UniformRing::get() const noexcept -> vk::Buffer
+{
+    return m_buffer.get();
+}
+
+auto UniformRing::dynamic_offset(const uint32_t t_frame_index) const noexcept -> uint32_t
+{
+    return static_cast<uint32_t>(m_stride * t_frame_index);
+}
+
+auto UniformRing::slice_size() const noexcept -> vk::DeviceSize
+{
+    return m_slice_size;
+}
+
+auto UniformRing::frame_count() const noexcept -> uint32_t
+{
+    return m_frame_count;
+}
+
+}   // namespace core::renderer
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include "MappedBuffer.hpp"
+
+namespace core::renderer {
+
+class Allocator;
+
+// One persistently mapped uniform buffer split into a slice per frame in flight.
+// Bind it as a dynamic uniform buffer and select the slice by dynamic offset,
+// so the CPU can write a frame while the GPU still reads the previous ones.
+class UniformRing {
+public:
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    explicit UniformRing(
+        const Allocator& t_allocator,
+        vk::DeviceSize   t_slice_size,
+        uint32_t         t_frame_count
+    );
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    // The GPU must be done with the previous use of the frame's slice.
+    // Call flush() or MappedBuffer::flush_dirty() before submitting.
+    template <typename T>
+    auto set(uint32_t t_frame_index, const T& t_data) const -> void;
+    auto flush() const -> void;
+
+    // For flushing several buffers at once
+    [[nodiscard]]
+    auto buffer() const noexcept -> const MappedBuffer&;
+
+    [[nodiscard]]
+    auto get() const noexcept -> vk::Buffer;
+    [[nodiscard]]
+    auto dynamic_offset(uint32_t t_frame_index) const noexcept -> uint32_t;
+    // Use it as the range of the descriptor
+    [[nodiscard]]
+    auto slice_size() const noexcept -> vk::DeviceSize;
+    [[nodiscard]]
+    auto frame_count() const noexcept -> uint32_t;
+
+private:
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    vk::DeviceSize m_slice_size;
+    vk::DeviceSize m_stride;
+    uint32_t       m_frame_count;
+    MappedBuffer   m_buffer;
+};
+
+}   // namespace core::renderer
+
+#include "UniformRing.inl"
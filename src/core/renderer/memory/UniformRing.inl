@@ -0,0 +1,9 @@
+namespace core::renderer {
+
+template <typename T>
+auto UniformRing::set(const uint32_t t_frame_index, const T& t_data) const -> void
+{
+    m_buffer.set(t_data, dynamic_offset(t_frame_index));
+}
+
+}   // namespace core::renderer
@@ -1,5 +1,15 @@
 #include "RenderModel.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <numeric>
+#include <string_view>
+#include <tuple>
+
+#include <vulkan/vulkan_format_traits.hpp>
+
 #include "core/renderer/material_system/GraphicsPipelineBuilder.hpp"
 #include "core/renderer/memory/Image.hpp"
 
@@ -56,184 +66,222 @@ struct ShaderMaterial {
     glm::vec4                  _padding2;
 };
 
-struct PushConstants {
+// One record per model in the scene-wide table
+struct ShaderModel {
+    vk::DeviceAddress vertices;
+    vk::DeviceAddress transforms;
+    vk::DeviceAddress textures;
+    vk::DeviceAddress materials;
+    vk::DeviceAddress default_material;
+    // ShaderInstance records, indexed by the instance index
+    vk::DeviceAddress instances;
+    uint32_t          first_image;
+    uint32_t          first_sampler;
+    uint32_t          default_sampler;
+    uint32_t          _padding0;
+};
+
+// One record per instance of each indirect draw of a model,
+// the instances of a draw are consecutive
+struct ShaderInstance {
     uint32_t transform_index;
     uint32_t material_index;
 };
 
+// The instance index is gl_InstanceIndex + first_instance, the commands pass it as
+// their first instance where the device can, and first_instance is 0 then
+struct PushConstants {
+    uint32_t model_index;
+    uint32_t first_instance;
+};
+
+// Mip levels larger than this are left to RenderModel::stream_images
+constexpr static uint32_t g_max_initial_mip_extent{ 256 };
+
+constexpr static vk::ImageUsageFlags g_image_usage{
+    vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled
+};
+
+constexpr static vk::DeviceSize g_storage_alignment{ 16 };
+
+constexpr static uint32_t g_draw_command_stride{ sizeof(vk::DrawIndexedIndirectCommand) };
+
+struct BufferUpload {
+    StagingRing::Region     staging_region;
+    BufferArena::Allocation allocation;
+};
+
+struct ImageUpload {
+    vk::Buffer                       staging_buffer;
+    std::vector<vk::BufferImageCopy> regions;
+    // Set if decoding into the staging memory threw
+    std::exception_ptr               decode_error;
+};
+
+// Indirect draws sorted by pipeline, element i of each vector belongs to draw i,
+// except for the instances, which follow each other in draw order
+struct Draws {
+    std::vector<cache::Handle<AsyncPipeline>>   pipelines;
+    std::vector<uint32_t>                       first_instances;
+    std::vector<vk::DrawIndexedIndirectCommand> commands;
+    std::vector<RenderModel::DrawInfo>          infos;
+    std::vector<ShaderInstance>                 shader_instances;
+};
+
 [[nodiscard]]
-static auto create_descriptor_set_layouts(
-    const vk::Device                                  t_device,
-    const RenderModel::DescriptorSetLayoutCreateInfo& t_info
-) -> std::array<vk::UniqueDescriptorSetLayout, 3>
+static auto align_up(
+    const vk::DeviceSize t_value,
+    const vk::DeviceSize t_alignment
+) noexcept -> vk::DeviceSize
 {
-    const std::array bindings_0{
-        // vertices
-        vk::DescriptorSetLayoutBinding{
-                                       .binding         = 0,
-                                       .descriptorType  = vk::DescriptorType::eUniformBuffer,
-                                       .descriptorCount = 1,
-                                       .stageFlags      = vk::ShaderStageFlagBits::eVertex  },
-        // transforms
-        vk::DescriptorSetLayoutBinding{
-                                       .binding         = 1,
-                                       .descriptorType  = vk::DescriptorType::eUniformBuffer,
-                                       .descriptorCount = 1,
-                                       .stageFlags      = vk::ShaderStageFlagBits::eVertex  },
-        // defaultSampler
-        vk::DescriptorSetLayoutBinding{ .binding         = 2,
-                                       .descriptorType  = vk::DescriptorType::eSampler,
-                                       .descriptorCount = 1,
-                                       .stageFlags = vk::ShaderStageFlagBits::eFragment     },
-        // textures
-        vk::DescriptorSetLayoutBinding{
-                                       .binding         = 3,
-                                       .descriptorType  = vk::DescriptorType::eUniformBuffer,
-                                       .descriptorCount = 1,
-                                       .stageFlags      = vk::ShaderStageFlagBits::eFragment },
-        // defaultMaterial
-        vk::DescriptorSetLayoutBinding{
-                                       .binding         = 4,
-                                       .descriptorType  = vk::DescriptorType::eUniformBuffer,
-                                       .descriptorCount = 1,
-                                       .stageFlags      = vk::ShaderStageFlagBits::eFragment },
-        // materials
-        vk::DescriptorSetLayoutBinding{
-                                       .binding         = 5,
-                                       .descriptorType  = vk::DescriptorType::eUniformBuffer,
-                                       .descriptorCount = 1,
-                                       .stageFlags      = vk::ShaderStageFlagBits::eFragment },
-    };
-    const vk::DescriptorSetLayoutCreateInfo create_info_0{
-        .bindingCount = static_cast<uint32_t>(bindings_0.size()),
-        .pBindings    = bindings_0.data(),
-    };
-
-    const std::array bindings_1{
-        vk::DescriptorSetLayoutBinding{
-                                       .binding         = 0,
-                                       .descriptorType  = vk::DescriptorType::eSampledImage,
-                                       .descriptorCount = static_cast<uint32_t>(t_info.max_image_count),
-                                       .stageFlags      = vk::ShaderStageFlagBits::eFragment },
-    };
-    const std::array flags_1{
-        vk::DescriptorBindingFlags{
-            vk::DescriptorBindingFlagBits::eVariableDescriptorCount },
-    };
-    vk::DescriptorSetLayoutBindingFlagsCreateInfoEXT binding_flags_1{
-        .bindingCount  = static_cast<uint32_t>(flags_1.size()),
-        .pBindingFlags = flags_1.data(),
-    };
-    const vk::DescriptorSetLayoutCreateInfo create_info_1{
-        .pNext        = &binding_flags_1,
-        .bindingCount = static_cast<uint32_t>(bindings_1.size()),
-        .pBindings    = bindings_1.data(),
-    };
+    return (t_value + t_alignment - 1) / t_alignment * t_alignment;
+}
 
-    const std::array bindings_2{
-        vk::DescriptorSetLayoutBinding{
-                                       .binding         = 0,
-                                       .descriptorType  = vk::DescriptorType::eSampler,
-                                       .descriptorCount = static_cast<uint32_t>(t_info.max_sampler_count),
-                                       .stageFlags      = vk::ShaderStageFlagBits::eFragment },
-    };
-    const std::array flags_2{
-        vk::DescriptorBindingFlags{
-            vk::DescriptorBindingFlagBits::eVariableDescriptorCount },
-    };
-    vk::DescriptorSetLayoutBindingFlagsCreateInfoEXT binding_flags_2{
-        .bindingCount  = static_cast<uint32_t>(flags_2.size()),
-        .pBindingFlags = flags_2.data(),
-    };
-    const vk::DescriptorSetLayoutCreateInfo create_info_2{
-        .pNext        = &binding_flags_2,
-        .bindingCount = static_cast<uint32_t>(bindings_2.size()),
-        .pBindings    = bindings_2.data(),
+[[nodiscard]]
+static auto mip_extent(const asset::Image& t_image, const uint32_t t_mip_level) noexcept
+    -> vk::Extent3D
+{
+    return vk::Extent3D{
+        .width  = std::max(t_image.width() >> t_mip_level, 1u),
+        .height = std::max(t_image.height() >> t_mip_level, 1u),
+        .depth  = 1,
     };
+}
 
-    return std::array{
-        t_device.createDescriptorSetLayoutUnique(create_info_0),
-        t_device.createDescriptorSetLayoutUnique(create_info_1),
-        t_device.createDescriptorSetLayoutUnique(create_info_2),
-    };
+[[nodiscard]]
+static auto first_resident_mip_level(const asset::Image& t_image) noexcept -> uint32_t
+{
+    uint32_t mip_level{};
+    while (mip_level + 1 < t_image.mip_levels()
+           && (std::max(t_image.width(), t_image.height()) >> mip_level)
+                  > g_max_initial_mip_extent)
+    {
+        ++mip_level;
+    }
+    return mip_level;
 }
 
+// Decodes the mip levels starting from t_base_mip_level straight into the mapped
+// staging memory, so the pixels never exist in an intermediate CPU buffer
 [[nodiscard]]
-static auto create_staging_buffer(
-    const Allocator&                          t_allocator,
-    const void*                               t_data,
-    const uint32_t                            t_size,
-    const std::optional<const vk::DeviceSize> t_min_alignment = std::nullopt
-) -> MappedBuffer
+static auto create_image_upload(
+    StagingRing&        t_staging_ring,
+    const asset::Image& t_image,
+    const uint32_t      t_base_mip_level
+) -> ImageUpload
 {
-    if (t_data == nullptr || t_size == 0) {
-        return MappedBuffer{};
+    // Buffer offsets of image copies must be multiples of the texel block size,
+    // and of 4 on queues without graphics or compute support
+    const vk::DeviceSize alignment{
+        std::lcm(vk::DeviceSize{ vk::blockSize(t_image.format()) }, vk::DeviceSize{ 4 })
+    };
+
+    std::vector<vk::BufferImageCopy> regions;
+    vk::DeviceSize                   size{};
+    for (uint32_t mip_level{ t_base_mip_level }; mip_level < t_image.mip_levels();
+         mip_level++)
+    {
+        size = align_up(size, alignment);
+        regions.push_back(vk::BufferImageCopy{
+            .bufferOffset = size,
+            .imageSubresource =
+                vk::ImageSubresourceLayers{ .aspectMask = vk::ImageAspectFlagBits::eColor,
+                                           .mipLevel   = mip_level,
+                                           .layerCount = 1 },
+            .imageExtent = mip_extent(t_image, mip_level),
+        });
+        size += t_image.level_size(mip_level);
+    }
+
+    if (size == 0) {
+        return ImageUpload{};
     }
 
-    const vk::BufferCreateInfo staging_buffer_create_info{
-        .size  = t_size,
-        .usage = vk::BufferUsageFlagBits::eTransferSrc,
+    const StagingRing::Region staging_region{
+        t_staging_ring.allocate(size, alignment)
     };
 
-    return t_min_alignment
-        .transform([&](const vk::DeviceSize min_alignment) {
-            return t_allocator.allocate_mapped_buffer_with_alignment(
-                staging_buffer_create_info, min_alignment, t_data
+    std::exception_ptr decode_error;
+    for (vk::BufferImageCopy& region : regions) {
+        const uint32_t mip_level{ region.imageSubresource.mipLevel };
+        try {
+            t_image.decode_level_to(
+                mip_level,
+                staging_region.data.subspan(
+                    region.bufferOffset, t_image.level_size(mip_level)
+                )
             );
-        })
-        .value_or(t_allocator.allocate_mapped_buffer(staging_buffer_create_info, t_data));
+        } catch (...) {
+            decode_error = std::current_exception();
+        }
+        region.bufferOffset += staging_region.offset;
+    }
+
+    return ImageUpload{
+        .staging_buffer = staging_region.buffer,
+        .regions        = std::move(regions),
+        .decode_error   = decode_error,
+    };
 }
 
-template <typename T>
-[[nodiscard]]
-static auto create_staging_buffer(
-    const Allocator&                          t_allocator,
-    const std::span<T>                        t_data,
-    const std::optional<const vk::DeviceSize> t_min_alignment = std::nullopt
-) -> MappedBuffer
+// Decodes the mip levels one at a time into host memory,
+// and copies each into the image without going through the GPU
+static auto copy_levels_on_host(
+    const HostImageCopy& t_host_image_copy,
+    const vk::Image      t_texture_image,
+    const asset::Image&  t_image,
+    const uint32_t       t_base_mip_level,
+    const uint32_t       t_level_count
+) -> void
 {
-    return create_staging_buffer(
-        t_allocator,
-        t_data.data(),
-        static_cast<uint32_t>(t_data.size_bytes()),
-        t_min_alignment
-    );
+    std::vector<std::byte> level_data;
+    for (uint32_t mip_level{ t_base_mip_level };
+         mip_level < t_base_mip_level + t_level_count;
+         mip_level++)
+    {
+        level_data.resize(t_image.level_size(mip_level));
+        t_image.decode_level_to(mip_level, level_data);
+        t_host_image_copy.copy(
+            t_texture_image, mip_level, mip_extent(t_image, mip_level), level_data
+        );
+    }
 }
 
+// Writes host-visible device memory directly (resizable BAR, UMA),
+// and stages the data for a copy otherwise
 [[nodiscard]]
-static auto create_gpu_only_buffer(
-    const Allocator&                          t_allocator,
-    const vk::BufferUsageFlags                t_usage_flags,
-    const uint32_t                            t_size,
-    const std::optional<const vk::DeviceSize> t_min_alignment = std::nullopt
-) -> Buffer
+static auto upload_buffer(
+    const BufferArena::Allocation&   t_allocation,
+    StagingRing&                     t_staging_ring,
+    const std::span<const std::byte> t_data
+) -> BufferUpload
 {
-    if (t_size == 0) {
-        return Buffer{};
+    if (!t_allocation.mapped_data.empty()) {
+        std::ranges::copy(t_data, t_allocation.mapped_data.begin());
+        return BufferUpload{ .allocation = t_allocation };
     }
 
-    const vk::BufferCreateInfo buffer_create_info = {
-        .size = t_size, .usage = t_usage_flags | vk::BufferUsageFlagBits::eTransferDst
+    return BufferUpload{
+        .staging_region = t_staging_ring.upload(t_data),
+        .allocation     = t_allocation,
     };
-
-    return t_min_alignment
-        .transform([&](const vk::DeviceSize min_alignment) {
-            return t_allocator.allocate_buffer_with_alignment(
-                buffer_create_info, min_alignment
-            );
-        })
-        .value_or(t_allocator.allocate_buffer(buffer_create_info));
 }
 
-template <typename UniformBlock>
 [[nodiscard]]
-static auto create_buffer(const Allocator& t_allocator) -> MappedBuffer
+static auto create_buffer_upload(
+    BufferArena&                     t_buffer_arena,
+    StagingRing&                     t_staging_ring,
+    const std::span<const std::byte> t_data,
+    const vk::DeviceSize             t_alignment
+) -> BufferUpload
 {
-    constexpr vk::BufferCreateInfo buffer_create_info = {
-        .size = sizeof(UniformBlock), .usage = vk::BufferUsageFlagBits::eUniformBuffer
-    };
+    if (t_data.empty()) {
+        return BufferUpload{};
+    }
 
-    return t_allocator.allocate_mapped_buffer(buffer_create_info);
+    return upload_buffer(
+        t_buffer_arena.allocate(t_data.size(), t_alignment), t_staging_ring, t_data
+    );
 }
 
 [[nodiscard]]
@@ -337,112 +385,12 @@ static auto convert_material(const graphics::Model::Material& t_material
     };
 }
 
-[[nodiscard]]
-static auto create_base_descriptor_set(
-    const vk::Device              t_device,
-    const vk::DescriptorSetLayout t_descriptor_set_layout,
-    const vk::DescriptorPool      t_descriptor_pool,
-    const vk::Buffer              t_vertex_uniform,
-    const vk::Buffer              t_transform_uniform,
-    const vk::Sampler             t_default_sampler,
-    const vk::Buffer              t_texture_uniform,
-    const vk::Buffer              t_default_material_uniform,
-    const vk::Buffer              t_material_uniform
-) -> vk::UniqueDescriptorSet
-{
-    const vk::DescriptorSetAllocateInfo descriptor_set_allocate_info{
-        .descriptorPool     = t_descriptor_pool,
-        .descriptorSetCount = 1,
-        .pSetLayouts        = &t_descriptor_set_layout,
-    };
-    auto descriptor_sets{
-        t_device.allocateDescriptorSetsUnique(descriptor_set_allocate_info)
-    };
-
-    const vk::DescriptorBufferInfo vertex_buffer_info{
-        .buffer = t_vertex_uniform,
-        .range  = sizeof(vk::DeviceAddress),
-    };
-    const vk::DescriptorBufferInfo transform_buffer_info{
-        .buffer = t_transform_uniform,
-        .range  = sizeof(vk::DeviceAddress),
-    };
-    const vk::DescriptorImageInfo default_sampler_image_info{
-        .sampler = t_default_sampler,
-    };
-    const vk::DescriptorBufferInfo texture_buffer_info{
-        .buffer = t_texture_uniform,
-        .range  = sizeof(vk::DeviceAddress),
-    };
-    const vk::DescriptorBufferInfo default_material_buffer_info{
-        .buffer = t_default_material_uniform,
-        .range  = sizeof(ShaderMaterial),
-    };
-    const vk::DescriptorBufferInfo material_buffer_info{
-        .buffer = t_material_uniform,
-        .range  = sizeof(vk::DeviceAddress),
-    };
-
-    std::array write_descriptor_sets{
-        vk::WriteDescriptorSet{
-                               .dstSet          = descriptor_sets.front().get(),
-                               .dstBinding      = 0,
-                               .descriptorCount = 1,
-                               .descriptorType  = vk::DescriptorType::eUniformBuffer,
-                               .pBufferInfo     = &vertex_buffer_info,
-                               },
-        vk::WriteDescriptorSet{
-                               .dstSet          = descriptor_sets.front().get(),
-                               .dstBinding      = 1,
-                               .descriptorCount = 1,
-                               .descriptorType  = vk::DescriptorType::eUniformBuffer,
-                               .pBufferInfo     = &transform_buffer_info,
-                               },
-        vk::WriteDescriptorSet{
-                               .dstSet          = descriptor_sets.front().get(),
-                               .dstBinding      = 2,
-                               .descriptorCount = 1,
-                               .descriptorType  = vk::DescriptorType::eSampler,
-                               .pImageInfo      = &default_sampler_image_info,
-                               },
-        vk::WriteDescriptorSet{
-                               .dstSet          = descriptor_sets.front().get(),
-                               .dstBinding      = 3,
-                               .descriptorCount = 1,
-                               .descriptorType  = vk::DescriptorType::eUniformBuffer,
-                               .pBufferInfo     = &texture_buffer_info,
-                               },
-        vk::WriteDescriptorSet{
-                               .dstSet          = descriptor_sets.front().get(),
-                               .dstBinding      = 4,
-                               .descriptorCount = 1,
-                               .descriptorType  = vk::DescriptorType::eUniformBuffer,
-                               .pBufferInfo     = &default_material_buffer_info,
-                               },
-        vk::WriteDescriptorSet{
-                               .dstSet          = descriptor_sets.front().get(),
-                               .dstBinding      = 5,
-                               .descriptorCount = 1,
-                               .descriptorType  = vk::DescriptorType::eUniformBuffer,
-                               .pBufferInfo     = &material_buffer_info,
-                               },
-    };
-
-    t_device.updateDescriptorSets(
-        static_cast<uint32_t>(write_descriptor_sets.size()),
-        write_descriptor_sets.data(),
-        0,
-        nullptr
-    );
-
-    return std::move(descriptor_sets.front());
-}
-
 [[nodiscard]]
 static auto create_image(
-    const Allocator&    t_allocator,
+    const ImagePool&    t_image_pool,
     uint32_t            t_width,
     uint32_t            t_height,
+    uint32_t            t_mip_levels,
     vk::Format          t_format,
     vk::ImageTiling     t_tiling,
     vk::ImageUsageFlags t_usage
@@ -452,7 +400,7 @@ static auto create_image(
         .imageType     = vk::ImageType::e2D,
         .format        = t_format,
         .extent        = vk::Extent3D{ .width = t_width, .height = t_height, .depth = 1 },
-        .mipLevels     = 1,
+        .mipLevels     = t_mip_levels,
         .arrayLayers   = 1,
         .samples       = vk::SampleCountFlagBits::e1,
         .tiling        = t_tiling,
@@ -461,20 +409,16 @@ static auto create_image(
         .initialLayout = vk::ImageLayout::eUndefined,
     };
 
-    constexpr static VmaAllocationCreateInfo allocation_create_info = {
-        .flags    = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
-        .usage    = VMA_MEMORY_USAGE_AUTO,
-        .priority = 1.f,
-    };
-
-    return t_allocator.allocate_image(image_create_info, allocation_create_info);
+    return t_image_pool.allocate_image(image_create_info);
 }
 
 [[nodiscard]]
 static auto create_image_view(
     const vk::Device t_device,
     const vk::Image  t_image,
-    const vk::Format t_format
+    const vk::Format t_format,
+    const uint32_t   t_base_mip_level,
+    const uint32_t   t_level_count
 ) -> vk::UniqueImageView
 {
     const vk::ImageViewCreateInfo view_create_info{
@@ -483,8 +427,8 @@ static auto create_image_view(
         .format   = t_format,
         .subresourceRange =
             vk::ImageSubresourceRange{ .aspectMask     = vk::ImageAspectFlagBits::eColor,
-                                      .baseMipLevel   = 0,
-                                      .levelCount     = 1,
+                                      .baseMipLevel   = t_base_mip_level,
+                                      .levelCount     = t_level_count,
                                       .baseArrayLayer = 0,
                                       .layerCount     = 1 },
     };
@@ -492,28 +436,15 @@ static auto create_image_view(
     return t_device.createImageViewUnique(view_create_info);
 }
 
-[[nodiscard]]
-static auto create_image_descriptor_set(
+static auto write_image_descriptors(
     const vk::Device                        t_device,
-    const vk::DescriptorSetLayout           t_descriptor_set_layout,
-    const vk::DescriptorPool                t_descriptor_pool,
+    const RenderModel::SceneSlot&           t_scene_slot,
     const std::vector<vk::UniqueImageView>& t_image_views
-) -> vk::UniqueDescriptorSet
+) -> void
 {
-    const uint32_t descriptor_count{ static_cast<uint32_t>(t_image_views.size()) };
-    const vk::DescriptorSetVariableDescriptorCountAllocateInfo variable_info{
-        .descriptorSetCount = 1,
-        .pDescriptorCounts  = &descriptor_count,
-    };
-    const vk::DescriptorSetAllocateInfo descriptor_set_allocate_info{
-        .pNext              = &variable_info,
-        .descriptorPool     = t_descriptor_pool,
-        .descriptorSetCount = 1,
-        .pSetLayouts        = &t_descriptor_set_layout,
-    };
-    auto descriptor_sets{
-        t_device.allocateDescriptorSetsUnique(descriptor_set_allocate_info)
-    };
+    if (t_image_views.empty()) {
+        return;
+    }
 
     const std::vector image_infos{
         t_image_views | std::views::transform([](const vk::UniqueImageView& image_view) {
@@ -525,28 +456,21 @@ static auto create_image_descriptor_set(
         | std::ranges::to<std::vector>()
     };
 
-    std::vector write_descriptor_sets{ std::views::iota(0u, image_infos.size())
-                                       | std::views::transform([&](const uint32_t index) {
-                                             return vk::WriteDescriptorSet{
-                                                 .dstSet = descriptor_sets.front().get(),
-                                                 .dstBinding      = 0,
-                                                 .dstArrayElement = index,
-                                                 .descriptorCount = 1,
-                                                 .descriptorType =
-                                                     vk::DescriptorType::eSampledImage,
-                                                 .pImageInfo = &image_infos.at(index),
-                                             };
-                                         })
-                                       | std::ranges::to<std::vector>() };
-
-    t_device.updateDescriptorSets(
-        static_cast<uint32_t>(write_descriptor_sets.size()),
-        write_descriptor_sets.data(),
-        0,
-        nullptr
-    );
-
-    return std::move(descriptor_sets.front());
+    const std::vector writes{
+        t_scene_slot.descriptor_sets
+        | std::views::transform([&](const vk::DescriptorSet descriptor_set) {
+              return vk::WriteDescriptorSet{
+                  .dstSet          = descriptor_set,
+                  .dstBinding      = RenderModel::s_image_binding,
+                  .dstArrayElement = t_scene_slot.first_image,
+                  .descriptorCount = static_cast<uint32_t>(image_infos.size()),
+                  .descriptorType  = vk::DescriptorType::eSampledImage,
+                  .pImageInfo      = image_infos.data(),
+              };
+          })
+        | std::ranges::to<std::vector>()
+    };
+    t_device.updateDescriptorSets(writes, nullptr);
 }
 
 [[nodiscard]]
@@ -624,30 +548,15 @@ static auto create_sampler(
     return t_device.createSamplerUnique(sampler_create_info);
 }
 
-[[nodiscard]]
-static auto create_sampler_descriptor_set(
+// The default sampler is written after the ones of the model
+static auto write_sampler_descriptors(
     const vk::Device                      t_device,
-    const vk::DescriptorSetLayout         t_descriptor_set_layout,
-    const vk::DescriptorPool              t_descriptor_pool,
-    const std::vector<vk::UniqueSampler>& t_samplers
-) -> vk::UniqueDescriptorSet
+    const RenderModel::SceneSlot&         t_scene_slot,
+    const std::vector<vk::UniqueSampler>& t_samplers,
+    const vk::Sampler                     t_default_sampler
+) -> void
 {
-    const uint32_t descriptor_count{ static_cast<uint32_t>(t_samplers.size()) };
-    const vk::DescriptorSetVariableDescriptorCountAllocateInfo variable_info{
-        .descriptorSetCount = 1,
-        .pDescriptorCounts  = &descriptor_count,
-    };
-    const vk::DescriptorSetAllocateInfo descriptor_set_allocate_info{
-        .pNext              = &variable_info,
-        .descriptorPool     = t_descriptor_pool,
-        .descriptorSetCount = 1,
-        .pSetLayouts        = &t_descriptor_set_layout,
-    };
-    auto descriptor_sets{
-        t_device.allocateDescriptorSetsUnique(descriptor_set_allocate_info)
-    };
-
-    const std::vector image_infos{
+    std::vector image_infos{
         t_samplers | std::views::transform([](const vk::UniqueSampler& sampler) {
             return vk::DescriptorImageInfo{
                 .sampler = sampler.get(),
@@ -655,29 +564,25 @@ static auto create_sampler_descriptor_set(
         })
         | std::ranges::to<std::vector>()
     };
+    image_infos.push_back(vk::DescriptorImageInfo{
+        .sampler = t_default_sampler,
+    });
 
-    std::vector write_descriptor_sets{ std::views::iota(0u, image_infos.size())
-                                       | std::views::transform([&](const uint32_t index) {
-                                             return vk::WriteDescriptorSet{
-                                                 .dstSet = descriptor_sets.front().get(),
-                                                 .dstBinding      = 0,
-                                                 .dstArrayElement = index,
-                                                 .descriptorCount = 1,
-                                                 .descriptorType =
-                                                     vk::DescriptorType::eSampler,
-                                                 .pImageInfo = &image_infos.at(index),
-                                             };
-                                         })
-                                       | std::ranges::to<std::vector>() };
-
-    t_device.updateDescriptorSets(
-        static_cast<uint32_t>(write_descriptor_sets.size()),
-        write_descriptor_sets.data(),
-        0,
-        nullptr
-    );
-
-    return std::move(descriptor_sets.front());
+    const std::vector writes{
+        t_scene_slot.descriptor_sets
+        | std::views::transform([&](const vk::DescriptorSet descriptor_set) {
+              return vk::WriteDescriptorSet{
+                  .dstSet          = descriptor_set,
+                  .dstBinding      = RenderModel::s_sampler_binding,
+                  .dstArrayElement = t_scene_slot.first_sampler,
+                  .descriptorCount = static_cast<uint32_t>(image_infos.size()),
+                  .descriptorType  = vk::DescriptorType::eSampler,
+                  .pImageInfo      = image_infos.data(),
+              };
+          })
+        | std::ranges::to<std::vector>()
+    };
+    t_device.updateDescriptorSets(writes, nullptr);
 }
 
 [[nodiscard]]
@@ -699,39 +604,190 @@ static auto convert(graphics::Model::Mesh::Primitive::Topology t_topology
     }
 }
 
+[[nodiscard]]
+static auto draw_state(
+    const graphics::Model::Mesh::Primitive& t_primitive,
+    const graphics::Model::Material&        t_material
+) -> RenderModel::DrawState
+{
+    return RenderModel::DrawState{
+        .cull_mode = t_material.double_sided ? vk::CullModeFlagBits::eNone
+                                             : vk::CullModeFlagBits::eBack,
+        .primitive_topology = convert(t_primitive.mode),
+        .blend_enable =
+            t_material.alpha_mode == core::graphics::Model::Material::AlphaMode::eBlend,
+    };
+}
+
 [[nodiscard]]
 static auto create_pipeline(
     const vk::Device                       t_device,
     const RenderModel::PipelineCreateInfo& t_create_info,
-    const graphics::Model::Mesh::Primitive t_primitive,
-    const graphics::Model::Material        t_material,
+    const RenderModel::DrawFeatures&       t_draw_features,
+    const RenderModel::DrawState&          t_draw_state,
     cache::Cache&                          t_cache
-) -> cache::Handle<vk::UniquePipeline>
+) -> cache::Handle<AsyncPipeline>
 {
     GraphicsPipelineBuilder builder{ t_create_info.effect };
 
     builder.set_layout(t_create_info.layout);
     builder.set_render_pass(t_create_info.render_pass);
-    builder.set_primitive_topology(convert(t_primitive.mode));
-    builder.set_cull_mode(
-        t_material.double_sided ? vk::CullModeFlagBits::eNone : vk::CullModeFlagBits::eBack
-    );
-    if (t_material.alpha_mode == core::graphics::Model::Material::AlphaMode::eBlend) {
+    builder.set_primitive_topology(t_draw_state.primitive_topology);
+    builder.set_cull_mode(t_draw_state.cull_mode);
+    if (t_draw_state.blend_enable) {
         builder.enable_blending();
     }
+    // Draws differing only in dynamic states share the pipeline
+    if (t_draw_features.extended_dynamic_state) {
+        builder.enable_extended_dynamic_state();
+    }
+    if (t_draw_features.dynamic_blending) {
+        builder.enable_dynamic_blending();
+    }
 
     auto hash{ hash_value(builder) };
 
-    return t_cache.find<vk::UniquePipeline>(hash).value_or(
-        t_cache.emplace<vk::UniquePipeline>(hash, builder.build(t_device))
+    if (std::optional<cache::Handle<AsyncPipeline>> pipeline{
+            t_cache.find<AsyncPipeline>(hash) };
+        pipeline.has_value())
+    {
+        return *pipeline;
+    }
+
+    if (!t_create_info.thread_pool.has_value()) {
+        std::promise<vk::UniquePipeline> pipeline;
+        pipeline.set_value(builder.build(t_device, t_create_info.pipeline_cache));
+        return t_cache.emplace<AsyncPipeline>(
+            hash, pipeline.get_future().share(), t_create_info.fallback_pipeline
+        );
+    }
+
+    // Loading goes on while the driver compiles
+    return t_cache.emplace<AsyncPipeline>(
+        hash,
+        builder.build_async(
+            t_create_info.thread_pool->get(),
+            t_device,
+            t_create_info.pipeline_cache,
+            t_create_info.fallback_pipeline
+        )
     );
 }
 
+// A draw for each primitive of every mesh that nodes refer to,
+// with an instance for each of those nodes and their EXT_mesh_gpu_instancing copies
+[[nodiscard]]
+static auto create_draws(
+    const vk::Device                             t_device,
+    const RenderModel::PipelineCreateInfo&       t_pipeline_create_info,
+    const RenderModel::DrawFeatures&             t_draw_features,
+    const graphics::Model&                       t_model,
+    const std::span<const glm::mat4>             t_transforms,
+    const std::span<const std::vector<uint32_t>> t_mesh_instances,
+    cache::Cache&                                t_cache
+) -> Draws
+{
+    Draws                 draws;
+    std::vector<uint32_t> mesh_indices;
+    for (const auto& [mesh, instances, mesh_index] : std::views::zip(
+             t_model.meshes(),
+             t_mesh_instances,
+             std::views::iota(0u, t_model.meshes().size())
+         ))
+    {
+        if (instances.empty()) {
+            continue;
+        }
+
+        glm::vec3 position{};
+        for (const uint32_t transform_index : instances) {
+            position += glm::vec3{ t_transforms[transform_index][3] };
+        }
+        position /= static_cast<float>(instances.size());
+
+        for (const graphics::Model::Mesh::Primitive& primitive : mesh.primitives) {
+            const graphics::Model::Material material{
+                primitive.material_index
+                    .transform([&t_model](const size_t material_index) {
+                        return t_model.materials().at(material_index);
+                    })
+                    .value_or(graphics::Model::default_material())
+            };
+            graphics::Model::Bounds bounds{
+                primitive.bounds.transformed(t_transforms[instances.front()])
+            };
+            for (const uint32_t transform_index : instances | std::views::drop(1)) {
+                bounds = bounds.merged(
+                    primitive.bounds.transformed(t_transforms[transform_index])
+                );
+            }
+
+            const RenderModel::DrawState state{ draw_state(primitive, material) };
+
+            draws.pipelines.push_back(create_pipeline(
+                t_device, t_pipeline_create_info, t_draw_features, state, t_cache
+            ));
+            draws.commands.push_back(vk::DrawIndexedIndirectCommand{
+                .indexCount    = primitive.index_count,
+                .instanceCount = static_cast<uint32_t>(instances.size()),
+                .firstIndex    = primitive.first_index_index,
+            });
+            draws.infos.push_back(RenderModel::DrawInfo{
+                .pipeline       = draws.pipelines.back().get().get(),
+                .alpha_mode     = material.alpha_mode,
+                .material_index = primitive.material_index.value_or(
+                    std::numeric_limits<uint32_t>::max()
+                ),
+                .position       = position,
+                .bounds         = bounds,
+                .state          = state,
+            });
+            mesh_indices.push_back(mesh_index);
+        }
+    }
+
+    std::vector<uint32_t> order{ std::views::iota(0u, draws.commands.size())
+                                 | std::ranges::to<std::vector>() };
+    // Then by state, so the draws of a pipeline change it as few times as possible
+    std::ranges::stable_sort(order, std::ranges::less{}, [&draws](const uint32_t index) {
+        const RenderModel::DrawState& state{ draws.infos[index].state };
+        return std::tuple{ draws.pipelines[index].get().get(),
+                           static_cast<VkCullModeFlags>(state.cull_mode),
+                           std::to_underlying(state.primitive_topology),
+                           state.blend_enable };
+    });
+
+    Draws sorted;
+    for (const uint32_t index : order) {
+        const auto first_instance{
+            static_cast<uint32_t>(sorted.shader_instances.size())
+        };
+        for (const uint32_t transform_index : t_mesh_instances[mesh_indices[index]]) {
+            sorted.shader_instances.push_back(ShaderInstance{
+                .transform_index = transform_index,
+                .material_index  = draws.infos[index].material_index,
+            });
+        }
+
+        sorted.pipelines.push_back(draws.pipelines[index]);
+        sorted.first_instances.push_back(first_instance);
+        sorted.commands.push_back(draws.commands[index]);
+        sorted.infos.push_back(draws.infos[index]);
+        if (t_draw_features.draw_indirect_first_instance) {
+            sorted.commands.back().firstInstance = first_instance;
+        }
+    }
+
+    return sorted;
+}
+
 static void transition_image_layout(
     vk::CommandBuffer t_command_buffer,
     vk::Image         t_image,
     vk::ImageLayout   t_old_layout,
-    vk::ImageLayout   t_new_layout
+    vk::ImageLayout   t_new_layout,
+    uint32_t          t_base_mip_level,
+    uint32_t          t_level_count
 )
 {
     vk::ImageMemoryBarrier barrier{
@@ -742,8 +798,8 @@ static void transition_image_layout(
         .image               = t_image,
         .subresourceRange =
             vk::ImageSubresourceRange{ .aspectMask     = vk::ImageAspectFlagBits::eColor,
-                                      .baseMipLevel   = 0,
-                                      .levelCount     = 1,
+                                      .baseMipLevel   = t_base_mip_level,
+                                      .levelCount     = t_level_count,
                                       .baseArrayLayer = 0,
                                       .layerCount     = 1 },
     };
@@ -762,11 +818,12 @@ static void transition_image_layout(
     else if (t_old_layout == vk::ImageLayout::eTransferDstOptimal
              && t_new_layout == vk::ImageLayout::eShaderReadOnlyOptimal)
     {
+        // Shader stages are not available on transfer-only queues
         barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-        barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+        barrier.dstAccessMask = vk::AccessFlagBits::eMemoryRead;
 
         source_stage      = vk::PipelineStageFlagBits::eTransfer;
-        destination_stage = vk::PipelineStageFlagBits::eFragmentShader;
+        destination_stage = vk::PipelineStageFlagBits::eAllCommands;
     }
     else {
         throw std::invalid_argument("unsupported layout transition!");
@@ -785,91 +842,96 @@ static void transition_image_layout(
     );
 }
 
-static void copy_buffer_to_image(
-    vk::CommandBuffer t_command_buffer,
-    vk::Buffer        t_buffer,
-    vk::Image         t_image,
-    vk::Extent2D      t_extent
-)
-{
-    const vk::BufferImageCopy region{
-        .imageSubresource =
-            vk::ImageSubresourceLayers{ .aspectMask = vk::ImageAspectFlagBits::eColor,
-                                       .layerCount = 1 },
-        .imageExtent = vk::Extent3D{ t_extent.width, t_extent.height, 1 },
-    };
+namespace core::renderer {
 
-    t_command_buffer.copyBufferToImage(
-        t_buffer, t_image, vk::ImageLayout::eTransferDstOptimal, 1, &region
-    );
+auto RenderModel::model_record_size() noexcept -> vk::DeviceSize
+{
+    return sizeof(ShaderModel);
 }
 
-namespace core::renderer {
+auto RenderModel::image_count(const graphics::Model& t_model) noexcept -> uint32_t
+{
+    return static_cast<uint32_t>(t_model.images().size());
+}
 
-auto RenderModel::descriptor_set_count() noexcept -> uint32_t
+auto RenderModel::sampler_count(const graphics::Model& t_model) noexcept -> uint32_t
 {
-    return 3;
+    return static_cast<uint32_t>(t_model.samplers().size()) + 1;
 }
 
-auto RenderModel::descriptor_pool_sizes(const DescriptorSetLayoutCreateInfo& t_info
-) -> std::vector<vk::DescriptorPoolSize>
+auto RenderModel::draw_features(const vk::PhysicalDevice t_physical_device)
+    -> DrawFeatures
 {
-    std::vector<vk::DescriptorPoolSize> pool_sizes{
-        // vertices
-        vk::DescriptorPoolSize{ .type            = vk::DescriptorType::eUniformBuffer,
-                               .descriptorCount = 1u },
-        // transforms
-        vk::DescriptorPoolSize{ .type            = vk::DescriptorType::eUniformBuffer,
-                               .descriptorCount = 1u },
-        // defaultSampler
-        vk::DescriptorPoolSize{       .type            = vk::DescriptorType::eSampler,
-                               .descriptorCount = 1u },
-        // textures
-        vk::DescriptorPoolSize{ .type            = vk::DescriptorType::eUniformBuffer,
-                               .descriptorCount = 1u },
-        // defaultMaterial
-        vk::DescriptorPoolSize{ .type            = vk::DescriptorType::eUniformBuffer,
-                               .descriptorCount = 1u },
-        // materials
-        vk::DescriptorPoolSize{ .type            = vk::DescriptorType::eUniformBuffer,
-                               .descriptorCount = 1u },
-    };
+    // Requirements enables these whenever they are supported
+    const vk::PhysicalDeviceFeatures features{ t_physical_device.getFeatures() };
 
-    if (t_info.max_image_count > 0) {
-        pool_sizes.push_back(vk::DescriptorPoolSize{
-            .type            = vk::DescriptorType::eSampledImage,
-            .descriptorCount = t_info.max_image_count,
-        });
+    const std::vector<vk::ExtensionProperties> extensions{
+        t_physical_device.enumerateDeviceExtensionProperties()
+    };
+    const auto supports{ [&extensions](const std::string_view extension_name) {
+        return std::ranges::any_of(
+            extensions,
+            [extension_name](const vk::ExtensionProperties& extension) {
+                return std::string_view{ extension.extensionName.data() }
+                    == extension_name;
+            }
+        );
+    } };
+
+    // Blending is only made dynamic along with the other states
+    bool extended_dynamic_state{};
+    bool dynamic_blending{};
+    if (supports(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)) {
+        extended_dynamic_state =
+            t_physical_device
+                .getFeatures2KHR<
+                    vk::PhysicalDeviceFeatures2,
+                    vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>()
+                .get<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>()
+                .extendedDynamicState
+            == vk::True;
     }
-    if (t_info.max_sampler_count > 0) {
-        pool_sizes.push_back(vk::DescriptorPoolSize{
-            .type            = vk::DescriptorType::eSampler,
-            .descriptorCount = t_info.max_sampler_count,
-        });
+    if (extended_dynamic_state
+        && supports(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME))
+    {
+        dynamic_blending =
+            t_physical_device
+                .getFeatures2KHR<
+                    vk::PhysicalDeviceFeatures2,
+                    vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT>()
+                .get<vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT>()
+                .extendedDynamicState3ColorBlendEnable
+            == vk::True;
     }
 
-    return pool_sizes;
+    return DrawFeatures{
+        .multi_draw_indirect          = features.multiDrawIndirect == vk::True,
+        .draw_indirect_first_instance = features.drawIndirectFirstInstance == vk::True,
+        .extended_dynamic_state       = extended_dynamic_state,
+        .dynamic_blending             = dynamic_blending,
+    };
 }
 
 auto RenderModel::create_loader(
-    const vk::Device                                  t_device,
-    const Allocator&                                  t_allocator,
-    const std::span<const vk::DescriptorSetLayout, 3> t_descriptor_set_layouts,
-    const PipelineCreateInfo&                         t_pipeline_create_info,
-    const vk::DescriptorPool                          t_descriptor_pool,
-    cache::Handle<graphics::Model>                    t_model,
-    cache::Cache&                                     t_cache
+    const vk::Device                    t_device,
+    const ImagePool&                    t_image_pool,
+    const std::optional<HostImageCopy>& t_host_image_copy,
+    BufferArena&                        t_buffer_arena,
+    StagingRing&                        t_staging_ring,
+    const SceneSlot&                    t_scene_slot,
+    const PipelineCreateInfo&           t_pipeline_create_info,
+    const DrawFeatures&                 t_draw_features,
+    cache::Handle<graphics::Model>      t_model,
+    cache::Cache&                       t_cache
 ) -> std::packaged_task<RenderModel(vk::CommandBuffer)>
 {
     // TODO: handle model buffers with no elements
 
-    MappedBuffer index_staging_buffer{
-        create_staging_buffer(t_allocator, std::span{ t_model->indices() })
-    };
-    Buffer index_buffer{ create_gpu_only_buffer(
-        t_allocator,
-        vk::BufferUsageFlagBits::eIndexBuffer,
-        static_cast<uint32_t>(std::span{ t_model->indices() }.size_bytes())
+    const BufferUpload index_upload{ create_buffer_upload(
+        t_buffer_arena,
+        t_staging_ring,
+        std::as_bytes(std::span{ t_model->indices() }),
+        sizeof(uint32_t)
     ) };
 
     std::vector<ShaderVertex> vertices{
@@ -885,44 +947,38 @@ auto RenderModel::create_loader(
           })
         | std::ranges::to<std::vector>()
     };
-    MappedBuffer vertex_staging_buffer{
-        create_staging_buffer(t_allocator, std::span{ vertices }, sizeof(ShaderVertex))
-    };
-    Buffer       vertex_buffer{ create_gpu_only_buffer(
-        t_allocator,
-        vk::BufferUsageFlagBits::eStorageBuffer
-            | vk::BufferUsageFlagBits::eShaderDeviceAddress,
-        static_cast<uint32_t>(std::span{ vertices }.size_bytes()),
+    const BufferUpload vertex_upload{ create_buffer_upload(
+        t_buffer_arena,
+        t_staging_ring,
+        std::as_bytes(std::span{ vertices }),
         sizeof(ShaderVertex)
     ) };
-    MappedBuffer vertex_uniform{ create_buffer<vk::DeviceAddress>(t_allocator) };
 
-    std::vector nodes_with_mesh{
-        t_model->nodes() | std::views::filter([](const graphics::Model::Node& node) {
-            return node.mesh_index.has_value();
-        })
-        | std::views::transform([](const graphics::Model::Node& node) {
-              return std::cref(node);
-          })
-        | std::ranges::to<std::vector>()
-    };
-    std::vector<glm::mat4> transforms(nodes_with_mesh.size());
-    std::ranges::for_each(
-        nodes_with_mesh,
-        [&transforms](const graphics::Model::Node& node) {
-            transforms.at(node.mesh_index.value()) = node.matrix();
+    // A transform for each node instance, and the indices of those of each mesh
+    std::vector<glm::mat4>             transforms;
+    std::vector<std::vector<uint32_t>> mesh_instances(t_model->meshes().size());
+    for (const graphics::Model::Node& node : t_model->nodes()) {
+        if (!node.mesh_index.has_value()) {
+            continue;
         }
-    );
-    MappedBuffer transform_staging_buffer{
-        create_staging_buffer(t_allocator, std::span{ transforms })
-    };
-    Buffer       transform_buffer{ create_gpu_only_buffer(
-        t_allocator,
-        vk::BufferUsageFlagBits::eStorageBuffer
-            | vk::BufferUsageFlagBits::eShaderDeviceAddress,
-        static_cast<uint32_t>(std::span{ transforms }.size_bytes())
+        std::vector<uint32_t>& instances{ mesh_instances.at(*node.mesh_index) };
+
+        const glm::mat4 matrix{ node.matrix() };
+        if (node.instance_matrices.empty()) {
+            instances.push_back(static_cast<uint32_t>(transforms.size()));
+            transforms.push_back(matrix);
+        }
+        for (const glm::mat4& instance_matrix : node.instance_matrices) {
+            instances.push_back(static_cast<uint32_t>(transforms.size()));
+            transforms.push_back(matrix * instance_matrix);
+        }
+    }
+    const BufferUpload transform_upload{ create_buffer_upload(
+        t_buffer_arena,
+        t_staging_ring,
+        std::as_bytes(std::span{ transforms }),
+        g_storage_alignment
     ) };
-    MappedBuffer transform_uniform{ create_buffer<vk::DeviceAddress>(t_allocator) };
 
     vk::UniqueSampler default_sampler{
         create_sampler(t_device, graphics::Model::default_sampler())
@@ -939,264 +995,313 @@ auto RenderModel::create_loader(
           })
         | std::ranges::to<std::vector>()
     };
-    MappedBuffer texture_staging_buffer{
-        create_staging_buffer(t_allocator, std::span{ textures })
-    };
-    Buffer       texture_buffer{ create_gpu_only_buffer(
-        t_allocator,
-        vk::BufferUsageFlagBits::eStorageBuffer
-            | vk::BufferUsageFlagBits::eShaderDeviceAddress,
-        static_cast<uint32_t>(std::span{ textures }.size_bytes())
-    ) };
-    MappedBuffer texture_uniform{ create_buffer<vk::DeviceAddress>(t_allocator) };
-
-    const ShaderMaterial default_material{
-        convert_material(graphics::Model::default_material())
-    };
-    MappedBuffer default_material_uniform{ t_allocator.allocate_mapped_buffer(
-        vk::BufferCreateInfo{
-            .size  = static_cast<uint32_t>(sizeof(ShaderMaterial)),
-            .usage = vk::BufferUsageFlagBits::eUniformBuffer,
-        },
-        &default_material
+    const BufferUpload texture_upload{ create_buffer_upload(
+        t_buffer_arena,
+        t_staging_ring,
+        std::as_bytes(std::span{ textures }),
+        g_storage_alignment
     ) };
 
     std::vector<ShaderMaterial> materials{ t_model->materials()
                                            | std::views::transform(convert_material)
                                            | std::ranges::to<std::vector>() };
-    MappedBuffer                material_staging_buffer{
-        create_staging_buffer(t_allocator, std::span{ materials }, sizeof(ShaderMaterial))
+    const BufferUpload          material_upload{ create_buffer_upload(
+        t_buffer_arena,
+        t_staging_ring,
+        std::as_bytes(std::span{ materials }),
+        sizeof(ShaderMaterial)
+    ) };
+
+    const ShaderMaterial default_material{
+        convert_material(graphics::Model::default_material())
     };
-    Buffer       material_buffer{ create_gpu_only_buffer(
-        t_allocator,
-        vk::BufferUsageFlagBits::eStorageBuffer
-            | vk::BufferUsageFlagBits::eShaderDeviceAddress,
-        static_cast<uint32_t>(std::span{ materials }.size_bytes()),
+    const BufferUpload default_material_upload{ create_buffer_upload(
+        t_buffer_arena,
+        t_staging_ring,
+        std::as_bytes(std::span{ &default_material, 1 }),
         sizeof(ShaderMaterial)
     ) };
-    MappedBuffer material_uniform{ create_buffer<vk::DeviceAddress>(t_allocator) };
 
-    vk::UniqueDescriptorSet base_descriptor_set{ create_base_descriptor_set(
+    const Draws draws{ create_draws(
         t_device,
-        t_descriptor_set_layouts[0],
-        t_descriptor_pool,
-        vertex_uniform.get(),
-        transform_uniform.get(),
-        default_sampler.get(),
-        texture_uniform.get(),
-        default_material_uniform.get(),
-        material_uniform.get()
+        t_pipeline_create_info,
+        t_draw_features,
+        *t_model,
+        transforms,
+        mesh_instances,
+        t_cache
+    ) };
+    const BufferUpload instance_upload{ create_buffer_upload(
+        t_buffer_arena,
+        t_staging_ring,
+        std::as_bytes(std::span{ draws.shader_instances }),
+        g_storage_alignment
     ) };
+    const BufferUpload draw_command_upload{ create_buffer_upload(
+        t_buffer_arena,
+        t_staging_ring,
+        std::as_bytes(std::span{ draws.commands }),
+        alignof(vk::DrawIndexedIndirectCommand)
+    ) };
+
+    std::vector<DrawGroup> draw_groups;
+    for (const auto& [pipeline, info, draw_index] : std::views::zip(
+             draws.pipelines, draws.infos, std::views::iota(0u, draws.pipelines.size())
+         ))
+    {
+        if (draw_groups.empty() || draw_groups.back().pipeline != pipeline
+            || draw_groups.back().state != info.state)
+        {
+            draw_groups.push_back(DrawGroup{
+                .pipeline   = pipeline,
+                .state      = info.state,
+                .first_draw = draw_index,
+                .draw_count = 0,
+            });
+        }
+        ++draw_groups.back().draw_count;
+    }
 
-    std::vector<vk::Extent2D> image_extents{
+    const ShaderModel shader_model{
+        .vertices         = vertex_upload.allocation.address,
+        .transforms       = transform_upload.allocation.address,
+        .textures         = texture_upload.allocation.address,
+        .materials        = material_upload.allocation.address,
+        .default_material = default_material_upload.allocation.address,
+        .instances        = instance_upload.allocation.address,
+        .first_image      = t_scene_slot.first_image,
+        .first_sampler    = t_scene_slot.first_sampler,
+        .default_sampler  = t_scene_slot.first_sampler
+                         + static_cast<uint32_t>(t_model->samplers().size()),
+        ._padding0        = 0,
+    };
+    const BufferUpload model_upload{ upload_buffer(
+        t_scene_slot.model_record,
+        t_staging_ring,
+        std::as_bytes(std::span{ &shader_model, 1 })
+    ) };
+
+    std::vector<BufferUpload> buffer_uploads{
+        index_upload,
+        vertex_upload,
+        transform_upload,
+        texture_upload,
+        material_upload,
+        default_material_upload,
+        instance_upload,
+        draw_command_upload,
+        model_upload,
+    };
+
+    std::vector<uint32_t> resident_mip_levels{
         t_model->images()
-        | std::views::transform([&](const graphics::Model::Image& image) {
-              return vk::Extent2D{ image->width(), image->height() };
+        | std::views::transform([](const graphics::Model::Image& image) {
+              return first_resident_mip_level(*image);
           })
         | std::ranges::to<std::vector>()
     };
-    std::vector<MappedBuffer> image_staging_buffers{
+    std::vector<bool> host_copied_images{
         t_model->images()
         | std::views::transform([&](const graphics::Model::Image& image) {
-              return create_staging_buffer(
-                  t_allocator, image->data(), static_cast<uint32_t>(image->size())
-              );
+              return t_host_image_copy.has_value()
+                  && t_host_image_copy->supports(image->format(), g_image_usage);
+          })
+        | std::ranges::to<std::vector>()
+    };
+    std::vector<ImageUpload> image_uploads{
+        std::views::zip(t_model->images(), resident_mip_levels, host_copied_images)
+        | std::views::transform([&](const auto& zipped) {
+              const auto& [image, mip_level, host_copied]{ zipped };
+              if (host_copied) {
+                  return ImageUpload{};
+              }
+              return create_image_upload(t_staging_ring, *image, mip_level);
           })
         | std::ranges::to<std::vector>()
     };
     std::vector<Image> images{
-        t_model->images()
-        | std::views::transform([&](const graphics::Model::Image& image) {
+        std::views::zip(t_model->images(), host_copied_images)
+        | std::views::transform([&](const auto& image_and_host_copied) {
+              const auto& [image, host_copied]{ image_and_host_copied };
               return create_image(
-                  t_allocator,
+                  t_image_pool,
                   image->width(),
                   image->height(),
+                  image->mip_levels(),
                   image->format(),
                   vk::ImageTiling::eOptimal,
-                  vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled
+                  host_copied ? g_image_usage | HostImageCopy::s_image_usage
+                              : g_image_usage
               );
           })
         | std::ranges::to<std::vector>()
     };
+    std::vector<std::future<void>> host_image_copies;
+    for (const uint32_t image_index : std::views::iota(0u, images.size())) {
+        if (!host_copied_images[image_index]) {
+            continue;
+        }
+        const vk::Image image{ images[image_index].get() };
+        t_host_image_copy->prepare(image, t_model->images()[image_index]->mip_levels());
+
+        // The model handle keeps the source alive until the copy is done
+        host_image_copies.push_back(std::async(
+            std::launch::async,
+            [image,
+             image_index,
+             host_image_copy = *t_host_image_copy,
+             model           = t_model,
+             mip_level       = resident_mip_levels[image_index]] {
+                const asset::Image& source{ *model->images()[image_index] };
+                copy_levels_on_host(
+                    host_image_copy,
+                    image,
+                    source,
+                    mip_level,
+                    source.mip_levels() - mip_level
+                );
+            }
+        ));
+    }
     std::vector<vk::UniqueImageView> image_views{
-        std::views::zip(
-            images | std::views::transform(&Image::get),
-            t_model->images()
-                | std::views::transform([](const graphics::Model::Image& image) {
-                      return image->format();
-                  })
-        )
-        | std::views::transform([t_device](auto image_and_format) {
-              return std::apply(
-                  std::bind_front(create_image_view, t_device), image_and_format
+        std::views::zip(images, t_model->images(), resident_mip_levels)
+        | std::views::transform([t_device](const auto& zipped) {
+              const auto& [image, source, mip_level]{ zipped };
+              return create_image_view(
+                  t_device,
+                  image.get(),
+                  source->format(),
+                  mip_level,
+                  source->mip_levels() - mip_level
               );
           })
         | std::ranges::to<std::vector>()
     };
-    vk::UniqueDescriptorSet image_descriptor_set{ create_image_descriptor_set(
-        t_device, t_descriptor_set_layouts[1], t_descriptor_pool, image_views
-    ) };
+    write_image_descriptors(t_device, t_scene_slot, image_views);
+    std::vector<ImageStream> image_streams{
+        std::views::iota(0u, resident_mip_levels.size())
+        | std::views::filter([&resident_mip_levels](const uint32_t image_index) {
+              return resident_mip_levels[image_index] > 0;
+          })
+        | std::views::transform([&resident_mip_levels](const uint32_t image_index) {
+              return ImageStream{
+                  .image_index        = image_index,
+                  .resident_mip_level = resident_mip_levels[image_index],
+              };
+          })
+        | std::ranges::to<std::vector>()
+    };
 
     std::vector<vk::UniqueSampler> samplers{
         t_model->samplers()
         | std::views::transform(std::bind_front(create_sampler, t_device))
         | std::ranges::to<std::vector>()
     };
-    vk::UniqueDescriptorSet sampler_descriptor_set{ create_sampler_descriptor_set(
-        t_device, t_descriptor_set_layouts[2], t_descriptor_pool, samplers
-    ) };
+    write_sampler_descriptors(t_device, t_scene_slot, samplers, default_sampler.get());
 
-    std::vector<Mesh> meshes{
-        t_model->meshes() | std::views::transform([&](const graphics::Model::Mesh& mesh) {
-            return Mesh{
-                .primitives =
-                    mesh.primitives
-                    | std::views::transform([&](const graphics::Model::Mesh::Primitive&
-                                                    primitive) {
-                          return Mesh::Primitive{
-                              .pipeline = create_pipeline(
-                                  t_device,
-                                  t_pipeline_create_info,
-                                  primitive,
-                                  primitive.material_index
-                                      .transform([&t_model](const size_t material_index) {
-                                          return t_model->materials().at(material_index);
-                                      })
-                                      .value_or(graphics::Model::default_material()),
-                                  t_cache
-                              ),
-                              .material_index    = primitive.material_index,
-                              .first_index_index = primitive.first_index_index,
-                              .index_count       = primitive.index_count,
-                              .vertex_count      = primitive.vertex_count,
-                          };
-                      })
-                    | std::ranges::to<std::vector>()
-            };
-        })
-        | std::ranges::to<std::vector>()
-    };
+    t_staging_ring.flush();
+    t_buffer_arena.flush();
 
     return std::packaged_task<RenderModel(vk::CommandBuffer)>{
-        [device = t_device,
-         index_buffer_size =
-             static_cast<uint32_t>(std::span{ t_model->indices() }.size_bytes()),
-         index_staging_buffer = auto{ std::move(index_staging_buffer) },
-         index_buffer         = auto{ std::move(index_buffer) },
-         vertex_buffer_size   = static_cast<uint32_t>(std::span{ vertices }.size_bytes()),
-         vertex_staging_buffer = auto{ std::move(vertex_staging_buffer) },
-         vertex_buffer         = auto{ std::move(vertex_buffer) },
-         vertex_uniform        = auto{ std::move(vertex_uniform) },
-         transform_buffer_size =
-             static_cast<uint32_t>(std::span{ transforms }.size_bytes()),
-         transform_staging_buffer = auto{ std::move(transform_staging_buffer) },
-         transform_buffer         = auto{ std::move(transform_buffer) },
-         transform_uniform        = auto{ std::move(transform_uniform) },
-         default_sampler          = auto{ std::move(default_sampler) },
-         texture_buffer_size = static_cast<uint32_t>(std::span{ textures }.size_bytes()),
-         texture_staging_buffer   = auto{ std::move(texture_staging_buffer) },
-         texture_buffer           = auto{ std::move(texture_buffer) },
-         texture_uniform          = auto{ std::move(texture_uniform) },
-         default_material_uniform = auto{ std::move(default_material_uniform) },
-         material_buffer_size = static_cast<uint32_t>(std::span{ materials }.size_bytes()),
-         material_staging_buffer = auto{ std::move(material_staging_buffer) },
-         material_buffer         = auto{ std::move(material_buffer) },
-         material_uniform        = auto{ std::move(material_uniform) },
-         base_descriptor_set     = auto{ std::move(base_descriptor_set) },
-         image_extents           = auto{ std::move(image_extents) },
-         image_staging_buffers   = auto{ std::move(image_staging_buffers) },
-         images                  = auto{ std::move(images) },
-         image_views             = auto{ std::move(image_views) },
-         image_descriptor_set    = auto{ std::move(image_descriptor_set) },
-         samplers                = auto{ std::move(samplers) },
-         sampler_descriptor_set  = auto{ std::move(sampler_descriptor_set) },
-         meshes                  = auto{ std::move(meshes
-         ) }](const vk::CommandBuffer t_transfer_command_buffer) mutable -> RenderModel {
-            t_transfer_command_buffer.copyBuffer(
-                index_staging_buffer.get(),
-                index_buffer.get(),
-                std::array{ vk::BufferCopy{ .size = index_buffer_size } }
-            );
-
-            t_transfer_command_buffer.copyBuffer(
-                vertex_staging_buffer.get(),
-                vertex_buffer.get(),
-                std::array{ vk::BufferCopy{ .size = vertex_buffer_size } }
-            );
-
-            t_transfer_command_buffer.copyBuffer(
-                transform_staging_buffer.get(),
-                transform_buffer.get(),
-                std::array{ vk::BufferCopy{ .size = transform_buffer_size } }
-            );
-
-            if (texture_buffer_size > 0) {
+        [index_buffer       = index_upload.allocation,
+         scene_slot         = t_scene_slot,
+         buffer_uploads     = auto{ std::move(buffer_uploads) },
+         default_sampler    = auto{ std::move(default_sampler) },
+         image_uploads      = auto{ std::move(image_uploads) },
+         images             = auto{ std::move(images) },
+         host_image_copies  = auto{ std::move(host_image_copies) },
+         image_views        = auto{ std::move(image_views) },
+         model              = auto{ std::move(t_model) },
+         image_streams      = auto{ std::move(image_streams) },
+         host_image_copy    = t_host_image_copy,
+         host_copied_images = auto{ std::move(host_copied_images) },
+         samplers           = auto{ std::move(samplers) },
+         draw_commands      = draw_command_upload.allocation,
+         draw_groups        = auto{ std::move(draw_groups) },
+         draw_infos         = draws.infos,
+         first_instances    = draws.first_instances,
+         draw_features      = t_draw_features](
+            const vk::CommandBuffer t_transfer_command_buffer
+        ) mutable -> RenderModel {
+            for (const BufferUpload& upload : buffer_uploads) {
+                // Written directly, or empty
+                if (!upload.staging_region.buffer) {
+                    continue;
+                }
                 t_transfer_command_buffer.copyBuffer(
-                    texture_staging_buffer.get(),
-                    texture_buffer.get(),
-                    std::array{ vk::BufferCopy{ .size = texture_buffer_size } }
+                    upload.staging_region.buffer,
+                    upload.allocation.buffer,
+                    vk::BufferCopy{
+                        .srcOffset = upload.staging_region.offset,
+                        .dstOffset = upload.allocation.offset,
+                        .size      = upload.allocation.size,
+                    }
                 );
             }
 
-            if (material_buffer_size > 0) {
-                t_transfer_command_buffer.copyBuffer(
-                    material_staging_buffer.get(),
-                    material_buffer.get(),
-                    std::array{ vk::BufferCopy{ .size = material_buffer_size } }
-                );
-            }
-
-            for (auto&& [buffer, texture_image, extent] :
-                 std::views::zip(image_staging_buffers, images, image_extents))
+            for (auto&& [upload, texture_image] :
+                 std::views::zip(image_uploads, images))
             {
+                // Headers are all that was validated while loading the file
+                if (upload.decode_error) {
+                    std::rethrow_exception(upload.decode_error);
+                }
+                if (upload.regions.empty()) {
+                    continue;
+                }
+                const uint32_t base_mip_level{
+                    upload.regions.front().imageSubresource.mipLevel
+                };
+                const auto level_count{ static_cast<uint32_t>(upload.regions.size()) };
+
                 transition_image_layout(
                     t_transfer_command_buffer,
                     texture_image.get(),
                     vk::ImageLayout::eUndefined,
-                    vk::ImageLayout::eTransferDstOptimal
+                    vk::ImageLayout::eTransferDstOptimal,
+                    base_mip_level,
+                    level_count
                 );
-                copy_buffer_to_image(
-                    t_transfer_command_buffer, buffer.get(), texture_image.get(), extent
+                t_transfer_command_buffer.copyBufferToImage(
+                    upload.staging_buffer,
+                    texture_image.get(),
+                    vk::ImageLayout::eTransferDstOptimal,
+                    upload.regions
                 );
                 transition_image_layout(
                     t_transfer_command_buffer,
                     texture_image.get(),
                     vk::ImageLayout::eTransferDstOptimal,
-                    vk::ImageLayout::eShaderReadOnlyOptimal
+                    vk::ImageLayout::eShaderReadOnlyOptimal,
+                    base_mip_level,
+                    level_count
                 );
             }
 
-            return RenderModel{ device,
-                                std::move(index_buffer),
-                                std::move(vertex_buffer),
-                                std::move(vertex_uniform),
-                                std::move(transform_buffer),
-                                std::move(transform_uniform),
+            // Rethrows what the copying threads threw
+            for (std::future<void>& host_image_copy_done : host_image_copies) {
+                host_image_copy_done.get();
+            }
+
+            return RenderModel{ index_buffer,
+                                scene_slot,
                                 std::move(default_sampler),
-                                std::move(texture_buffer),
-                                std::move(texture_uniform),
-                                std::move(default_material_uniform),
-                                std::move(material_buffer),
-                                std::move(material_uniform),
-                                std::move(base_descriptor_set),
                                 std::move(images),
                                 std::move(image_views),
-                                std::move(image_descriptor_set),
+                                std::move(model),
+                                std::move(image_streams),
+                                host_image_copy,
+                                std::move(host_copied_images),
                                 std::move(samplers),
-                                std::move(sampler_descriptor_set),
-                                std::move(meshes) };
+                                draw_commands,
+                                std::move(draw_groups),
+                                std::move(draw_infos),
+                                std::move(first_instances),
+                                draw_features };
         }
     };
 }
 
-auto RenderModel::create_descriptor_set_layouts(
-    const vk::Device                     t_device,
-    const DescriptorSetLayoutCreateInfo& t_info
-) -> std::array<vk::UniqueDescriptorSetLayout, 3>
-{
-    return ::create_descriptor_set_layouts(t_device, t_info);
-}
-
 auto RenderModel::push_constant_range() noexcept -> vk::PushConstantRange
 {
     return vk::PushConstantRange{
@@ -1207,37 +1312,120 @@ auto RenderModel::push_constant_range() noexcept -> vk::PushConstantRange
 }
 
 auto RenderModel::draw(
-    vk::CommandBuffer  t_graphics_command_buffer,
-    vk::PipelineLayout t_pipeline_layout
+    const vk::CommandBuffer  t_graphics_command_buffer,
+    const vk::PipelineLayout t_pipeline_layout
+) const noexcept -> void
+{
+    bind(t_graphics_command_buffer, t_pipeline_layout);
+
+    for (const DrawGroup& draw_group : m_draw_groups) {
+        const vk::Pipeline pipeline{ draw_group.pipeline->get() };
+        if (!pipeline) {
+            continue;
+        }
+
+        t_graphics_command_buffer.bindPipeline(
+            vk::PipelineBindPoint::eGraphics, pipeline
+        );
+        set_draw_state(t_graphics_command_buffer, draw_group.state);
+        draw_range(
+            t_graphics_command_buffer,
+            t_pipeline_layout,
+            draw_group.first_draw,
+            draw_group.draw_count
+        );
+    }
+}
+
+auto RenderModel::draw_infos() const noexcept -> std::span<const DrawInfo>
+{
+    return m_draw_infos;
+}
+
+auto RenderModel::draw_groups() const noexcept -> std::span<const DrawGroup>
+{
+    return m_draw_groups;
+}
+
+auto RenderModel::draw_command_address(const uint32_t t_draw_index) const noexcept
+    -> vk::DeviceAddress
+{
+    return m_draw_commands.address
+         + vk::DeviceSize{ t_draw_index } * g_draw_command_stride;
+}
+
+auto RenderModel::bind(
+    const vk::CommandBuffer  t_graphics_command_buffer,
+    const vk::PipelineLayout t_pipeline_layout
 ) const noexcept -> void
 {
     t_graphics_command_buffer.bindIndexBuffer(
-        m_index_buffer.get(), 0, vk::IndexType::eUint32
+        m_index_buffer.buffer, m_index_buffer.offset, vk::IndexType::eUint32
     );
 
-    t_graphics_command_buffer.bindDescriptorSets(
-        vk::PipelineBindPoint::eGraphics,
+    const PushConstants push_constants{
+        .model_index    = m_scene_slot.model_index,
+        .first_instance = 0,
+    };
+    t_graphics_command_buffer.pushConstants(
         t_pipeline_layout,
-        1,
-        std::array{ m_base_descriptor_set.get(),
-                    m_image_descriptor_set.get(),
-                    m_sampler_descriptor_set.get() },
-        nullptr
+        vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment,
+        0,
+        sizeof(PushConstants),
+        &push_constants
     );
+}
+
+auto RenderModel::set_draw_state(
+    const vk::CommandBuffer t_graphics_command_buffer,
+    const DrawState&        t_draw_state
+) const noexcept -> void
+{
+    if (!m_draw_features.extended_dynamic_state) {
+        return;
+    }
 
-    for (const auto& [mesh, mesh_index] :
-         std::views::zip(m_meshes, std::views::iota(0u, m_meshes.size())))
+    // The states the pipelines would have baked in
+    t_graphics_command_buffer.setCullModeEXT(t_draw_state.cull_mode);
+    t_graphics_command_buffer.setFrontFaceEXT(vk::FrontFace::eCounterClockwise);
+    t_graphics_command_buffer.setPrimitiveTopologyEXT(t_draw_state.primitive_topology);
+    t_graphics_command_buffer.setDepthTestEnableEXT(vk::True);
+    t_graphics_command_buffer.setDepthWriteEnableEXT(vk::True);
+
+    if (m_draw_features.dynamic_blending) {
+        t_graphics_command_buffer.setColorBlendEnableEXT(
+            0, vk::Bool32{ t_draw_state.blend_enable ? vk::True : vk::False }
+        );
+    }
+}
+
+auto RenderModel::draw_range(
+    const vk::CommandBuffer  t_graphics_command_buffer,
+    const vk::PipelineLayout t_pipeline_layout,
+    const uint32_t           t_first_draw,
+    const uint32_t           t_draw_count
+) const noexcept -> void
+{
+    if (m_draw_features.multi_draw_indirect
+        && m_draw_features.draw_indirect_first_instance)
     {
-        for (const auto& primitive : mesh.primitives) {
-            t_graphics_command_buffer.bindPipeline(
-                vk::PipelineBindPoint::eGraphics, primitive.pipeline.get()->get()
-            );
+        t_graphics_command_buffer.drawIndexedIndirect(
+            m_draw_commands.buffer,
+            m_draw_commands.offset
+                + vk::DeviceSize{ t_first_draw } * g_draw_command_stride,
+            t_draw_count,
+            g_draw_command_stride
+        );
+        return;
+    }
 
-            PushConstants push_constants{
-                .transform_index = mesh_index,
-                .material_index  = primitive.material_index.value_or(
-                    std::numeric_limits<uint32_t>::max()
-                ),
+    for (const uint32_t draw_index :
+         std::views::iota(t_first_draw, t_first_draw + t_draw_count))
+    {
+        if (!m_draw_features.draw_indirect_first_instance) {
+            const PushConstants push_constants{
+                .model_index    = m_scene_slot.model_index,
+                .first_instance = m_first_instances[draw_index],
             };
             t_graphics_command_buffer.pushConstants(
                 t_pipeline_layout,
@@ -1246,83 +1434,294 @@ auto RenderModel::draw(
                 sizeof(PushConstants),
                 &push_constants
             );
+        }
+        t_graphics_command_buffer.drawIndexedIndirect(
+            m_draw_commands.buffer,
+            m_draw_commands.offset + vk::DeviceSize{ draw_index } * g_draw_command_stride,
+            1,
+            g_draw_command_stride
+        );
+    }
+}
+
+auto RenderModel::uploaded_resources() const -> UploadedResources
+{
+    UploadedResources result;
+
+    for (const auto& [image, image_index] :
+         std::views::zip(m_images, std::views::iota(0u, m_images.size())))
+    {
+        // Host copies do not belong to any queue family
+        if (m_host_copied_images[image_index]) {
+            continue;
+        }
+
+        const auto stream{ std::ranges::find(
+            m_image_streams, image_index, &ImageStream::image_index
+        ) };
+        const uint32_t resident_mip_level{
+            stream != m_image_streams.cend() ? stream->resident_mip_level : 0
+        };
+
+        result.images.push_back(UploadedResources::Image{
+            .image  = image.get(),
+            .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
+            .subresource_range =
+                vk::ImageSubresourceRange{
+                    .aspectMask     = vk::ImageAspectFlagBits::eColor,
+                    .baseMipLevel   = resident_mip_level,
+                    .levelCount     = vk::RemainingMipLevels,
+                    .baseArrayLayer = 0,
+                    .layerCount     = 1,
+                },
+        });
+    }
+
+    return result;
+}
+
+auto RenderModel::stream_images(
+    const vk::Device        t_device,
+    const Allocator&        t_allocator,
+    const vk::CommandBuffer t_transfer_command_buffer,
+    const uint32_t          t_frame_index
+) -> void
+{
+    retire_image_views(t_device, t_frame_index);
+
+    // The ownership of these has been acquired by the graphics queue by now
+    if (!m_loaded_images_movable) {
+        for (const auto& [image, image_index] :
+             std::views::zip(m_images, std::views::iota(0u, m_images.size())))
+        {
+            const auto stream{ std::ranges::find(
+                m_image_streams, image_index, &ImageStream::image_index
+            ) };
+            if (stream == m_image_streams.cend()) {
+                Defragmenter::allow_moves(image, vk::ImageLayout::eShaderReadOnlyOptimal);
+            }
+        }
+        m_loaded_images_movable = true;
+    }
+
+    for (ImageStream& stream : m_image_streams) {
+        if (stream.resident_mip_level == 0) {
+            stream.staging_buffer.reset();
+            continue;
+        }
+
+        const asset::Image& source{ *m_model->images().at(stream.image_index) };
+        const uint32_t      mip_level{ stream.resident_mip_level - 1 };
+
+        const vk::Image image{ m_images.at(stream.image_index).get() };
+        const bool      host_copied{ m_host_copied_images[stream.image_index] };
+
+        if (!stream.decoded_level.valid() && host_copied) {
+            stream.decoded_level = std::async(
+                std::launch::async,
+                [host_image_copy = *m_host_image_copy, image, &source, mip_level] {
+                    copy_levels_on_host(host_image_copy, image, source, mip_level, 1);
+                }
+            );
+            continue;
+        }
+
+        // Whatever copied out of the previous staging buffer has finished by now.
+        // Decoding spans several frames, so this cannot come from a StagingRing.
+        if (!stream.decoded_level.valid()) {
+            const size_t level_size{ source.level_size(mip_level) };
+            stream.staging_buffer = t_allocator.allocate_mapped_buffer(
+                vk::BufferCreateInfo{
+                    .size  = level_size,
+                    .usage = vk::BufferUsageFlagBits::eTransferSrc,
+                }
+            );
+            stream.decoded_level = std::async(
+                std::launch::async,
+                [&source,
+                 mip_level,
+                 destination = std::span{
+                     static_cast<std::byte*>(stream.staging_buffer.data()),
+                     level_size,
+                 }] {
+                    source.decode_level_to(mip_level, destination);
+                }
+            );
+            continue;
+        }
 
-            t_graphics_command_buffer.drawIndexed(
-                primitive.index_count, 1, primitive.first_index_index, 0, 0
+        if (stream.decoded_level.wait_for(std::chrono::seconds{ 0 })
+            != std::future_status::ready)
+        {
+            continue;
+        }
+        stream.decoded_level.get();
+
+        if (!host_copied) {
+            stream.staging_buffer.flush();
+
+            transition_image_layout(
+                t_transfer_command_buffer,
+                image,
+                vk::ImageLayout::eUndefined,
+                vk::ImageLayout::eTransferDstOptimal,
+                mip_level,
+                1
+            );
+            const vk::BufferImageCopy region{
+                .imageSubresource =
+                    vk::ImageSubresourceLayers{
+                        .aspectMask = vk::ImageAspectFlagBits::eColor,
+                        .mipLevel   = mip_level,
+                        .layerCount = 1,
+                    },
+                .imageExtent = mip_extent(source, mip_level),
+            };
+            t_transfer_command_buffer.copyBufferToImage(
+                stream.staging_buffer.get(),
+                image,
+                vk::ImageLayout::eTransferDstOptimal,
+                region
+            );
+            transition_image_layout(
+                t_transfer_command_buffer,
+                image,
+                vk::ImageLayout::eTransferDstOptimal,
+                vk::ImageLayout::eShaderReadOnlyOptimal,
+                mip_level,
+                1
+            );
+        }
+
+        // The view's base level acts as the LOD clamp,
+        // so that sampling never touches a level that is not resident yet
+        stream.resident_mip_level = mip_level;
+        refresh_image_view(t_device, stream.image_index, mip_level, t_frame_index);
+
+        if (mip_level == 0) {
+            Defragmenter::allow_moves(
+                m_images.at(stream.image_index), vk::ImageLayout::eShaderReadOnlyOptimal
             );
         }
     }
 }
 
+auto RenderModel::relocate(
+    const vk::Device                 t_device,
+    const Defragmenter::Relocations& t_relocations,
+    const uint32_t                   t_frame_index
+) -> void
+{
+    for (const auto& [image, image_index] :
+         std::views::zip(m_images, std::views::iota(0u, m_images.size())))
+    {
+        const auto relocation{ std::ranges::find(
+            t_relocations.images, image.get(), &Defragmenter::ImageRelocation::new_image
+        ) };
+        if (relocation != t_relocations.images.cend()) {
+            refresh_image_view(t_device, image_index, 0, t_frame_index);
+        }
+    }
+}
+
+
 RenderModel::RenderModel(
-    vk::Device                         t_device,
-    Buffer&&                           t_index_buffer,
-    Buffer&&                           t_vertex_buffer,
-    MappedBuffer&&                     t_vertex_uniform,
-    Buffer&&                           t_transform_buffer,
-    MappedBuffer&&                     t_transform_uniform,
-    vk::UniqueSampler&&                t_default_sampler,
-    Buffer&&                           t_texture_buffer,
-    MappedBuffer&&                     t_texture_uniform,
-    MappedBuffer&&                     t_default_material_uniform,
-    Buffer&&                           t_material_buffer,
-    MappedBuffer&&                     t_material_uniform,
-    vk::UniqueDescriptorSet&&          t_base_descriptor_set,
-    std::vector<Image>&&               t_images,
-    std::vector<vk::UniqueImageView>&& t_image_views,
-    vk::UniqueDescriptorSet&&          t_image_descriptor_set,
-    std::vector<vk::UniqueSampler>&&   t_samplers,
-    vk::UniqueDescriptorSet&&          t_sampler_descriptor_set,
-    std::vector<Mesh>&&                t_meshes
+    const BufferArena::Allocation&      t_index_buffer,
+    const SceneSlot&                    t_scene_slot,
+    vk::UniqueSampler&&                 t_default_sampler,
+    std::vector<Image>&&                t_images,
+    std::vector<vk::UniqueImageView>&&  t_image_views,
+    cache::Handle<graphics::Model>&&    t_model,
+    std::vector<ImageStream>&&          t_image_streams,
+    const std::optional<HostImageCopy>& t_host_image_copy,
+    std::vector<bool>&&                 t_host_copied_images,
+    std::vector<vk::UniqueSampler>&&    t_samplers,
+    const BufferArena::Allocation&      t_draw_commands,
+    std::vector<DrawGroup>&&            t_draw_groups,
+    std::vector<DrawInfo>&&             t_draw_infos,
+    std::vector<uint32_t>&&             t_first_instances,
+    const DrawFeatures&                 t_draw_features
 )
-    : m_index_buffer{ std::move(t_index_buffer) },
-      m_vertex_buffer{ std::move(t_vertex_buffer) },
-      m_vertex_uniform{ std::move(t_vertex_uniform) },
-      m_transform_buffer{ std::move(t_transform_buffer) },
-      m_transform_uniform{ std::move(t_transform_uniform) },
+    : m_index_buffer{ t_index_buffer },
+      m_scene_slot{ t_scene_slot },
       m_default_sampler{ std::move(t_default_sampler) },
-      m_texture_buffer{ std::move(t_texture_buffer) },
-      m_texture_uniform{ std::move(t_texture_uniform) },
-      m_default_material_uniform{ std::move(t_default_material_uniform) },
-      m_material_buffer{ std::move(t_material_buffer) },
-      m_material_uniform{ std::move(t_material_uniform) },
-      m_base_descriptor_set{ std::move(t_base_descriptor_set) },
       m_images{ std::move(t_images) },
       m_image_views{ std::move(t_image_views) },
-      m_image_descriptor_set{ std::move(t_image_descriptor_set) },
+      m_model{ std::move(t_model) },
+      m_image_streams{ std::move(t_image_streams) },
+      m_host_image_copy{ t_host_image_copy },
+      m_host_copied_images{ std::move(t_host_copied_images) },
       m_samplers{ std::move(t_samplers) },
-      m_sampler_descriptor_set{ std::move(t_sampler_descriptor_set) },
-      m_meshes{ std::move(t_meshes) }
+      m_draw_commands{ t_draw_commands },
+      m_draw_groups{ std::move(t_draw_groups) },
+      m_draw_infos{ std::move(t_draw_infos) },
+      m_first_instances{ std::move(t_first_instances) },
+      m_draw_features{ t_draw_features }
+{}
+
+auto RenderModel::retire_image_views(
+    const vk::Device t_device,
+    const uint32_t   t_frame_index
+) -> void
 {
-    m_vertex_buffer_address = t_device.getBufferAddress(vk::BufferDeviceAddressInfo{
-        .buffer = m_vertex_buffer.get(),
+    for (RetiredImageView& retired_image_view : m_retired_image_views) {
+        write_image_descriptor(t_device, retired_image_view.image_index, t_frame_index);
+        --retired_image_view.frames_until_destroyed;
+    }
+    std::erase_if(m_retired_image_views, [](const RetiredImageView& retired_image_view) {
+        return retired_image_view.frames_until_destroyed == 0;
     });
-    m_vertex_uniform.set(m_vertex_buffer_address);
+}
 
-    m_transform_buffer_address = t_device.getBufferAddress(vk::BufferDeviceAddressInfo{
-        .buffer = m_transform_buffer.get(),
+auto RenderModel::refresh_image_view(
+    const vk::Device t_device,
+    const uint32_t   t_image_index,
+    const uint32_t   t_base_mip_level,
+    const uint32_t   t_frame_index
+) -> void
+{
+    const asset::Image& source{ *m_model->images().at(t_image_index) };
+
+    // The sets of the other frames are written by the next retire_image_views() calls,
+    // the last one of them comes after the frames using the old view have finished
+    const auto frame_count{ static_cast<uint32_t>(m_scene_slot.descriptor_sets.size()) };
+    m_retired_image_views.push_back(RetiredImageView{
+        .image_index            = t_image_index,
+        .image_view             = std::move(m_image_views.at(t_image_index)),
+        .frames_until_destroyed = frame_count,
     });
-    m_transform_uniform.set(m_transform_buffer_address);
+    m_image_views.at(t_image_index) = create_image_view(
+        t_device,
+        m_images.at(t_image_index).get(),
+        source.format(),
+        t_base_mip_level,
+        source.mip_levels() - t_base_mip_level
+    );
 
-    if (m_texture_buffer.get()) {
-        m_texture_buffer_address = t_device.getBufferAddress(vk::BufferDeviceAddressInfo{
-            .buffer = m_texture_buffer.get(),
-        });
-    }
-    else {
-        m_texture_buffer_address = vk::DeviceAddress{};
-    }
-    m_texture_uniform.set(m_texture_buffer_address);
+    write_image_descriptor(t_device, t_image_index, t_frame_index);
+}
 
-    if (m_material_buffer.get()) {
-        m_material_buffer_address = t_device.getBufferAddress(vk::BufferDeviceAddressInfo{
-            .buffer = m_material_buffer.get(),
-        });
-    }
-    else {
-        m_material_buffer_address = vk::DeviceAddress{};
-    }
-    m_material_uniform.set(m_material_buffer_address);
+auto RenderModel::write_image_descriptor(
+    const vk::Device t_device,
+    const uint32_t   t_image_index,
+    const uint32_t   t_frame_index
+) const -> void
+{
+    const vk::DescriptorImageInfo image_info{
+        .imageView   = m_image_views.at(t_image_index).get(),
+        .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+    };
+    t_device.updateDescriptorSets(
+        vk::WriteDescriptorSet{
+            .dstSet          = m_scene_slot.descriptor_sets.at(t_frame_index),
+            .dstBinding      = s_image_binding,
+            .dstArrayElement = m_scene_slot.first_image + t_image_index,
+            .descriptorCount = 1,
+            .descriptorType  = vk::DescriptorType::eSampledImage,
+            .pImageInfo      = &image_info,
+        },
+        nullptr
+    );
 }
 
 }   // namespace core::renderer
@@ -1,11 +1,19 @@
 #pragma once
 
 #include <future>
+#include <optional>
 
 #include "core/graphics/model/Model.hpp"
 #include "core/renderer/base/allocator/Allocator.hpp"
-#include "core/renderer/base/descriptor_pool/DescriptorPool.hpp"
+#include "core/renderer/material_system/AsyncPipeline.hpp"
 #include "core/renderer/material_system/Effect.hpp"
+#include "core/renderer/memory/BufferArena.hpp"
+#include "core/renderer/memory/Defragmenter.hpp"
+#include "core/renderer/memory/ImagePool.hpp"
+#include "core/renderer/memory/StagingRing.hpp"
+#include "core/renderer/transfer/HostImageCopy.hpp"
+#include "core/renderer/transfer/TransferScheduler.hpp"
+#include "core/utility/ThreadPool.hpp"
 
 namespace core::renderer {
 
@@ -13,119 +21,254 @@ class RenderModel {
 public:
     class Requirements;
 
-    struct DescriptorSetLayoutCreateInfo {
-        uint32_t max_image_count;
-        uint32_t max_sampler_count;
+    // Bindings of the scene-wide descriptor set
+    constexpr static uint32_t s_image_binding{ 1 };
+    constexpr static uint32_t s_sampler_binding{ 2 };
+
+    // Where the model lives in the scene-wide record table and descriptor arrays
+    struct SceneSlot {
+        // One for each frame in flight, indexed by frame index
+        std::vector<vk::DescriptorSet> descriptor_sets;
+        uint32_t                       model_index;
+        BufferArena::Allocation        model_record;
+        uint32_t                       first_image;
+        uint32_t                       first_sampler;
     };
 
     struct PipelineCreateInfo {
         Effect             effect;
         vk::PipelineLayout layout;
         vk::RenderPass     render_pass;
+        vk::PipelineCache  pipeline_cache;
+        // Drawn with until the pipeline of a draw is compiled, the draw is skipped
+        // without one. It has to be compatible with the layout and the render pass.
+        vk::Pipeline       fallback_pipeline;
+        // Pipelines compile on it in the background,
+        // or while loading without one
+        std::optional<std::reference_wrapper<utils::ThreadPool>> thread_pool;
+    };
+
+    // Optional device features that RenderModel::Requirements enables when present
+    struct DrawFeatures {
+        // Submits every draw of a pipeline with a single command
+        bool multi_draw_indirect;
+        // Passes the first instance record in the command instead of a push constant
+        bool draw_indirect_first_instance;
+        // VK_EXT_extended_dynamic_state, draws set their DrawState,
+        // so the pipelines only differ in topology class and blending
+        bool extended_dynamic_state;
+        // VK_EXT_extended_dynamic_state3, draws set blending too
+        bool dynamic_blending;
+    };
+
+    // Pipeline state of a draw, set through set_draw_state() where DrawFeatures allow,
+    // baked into a pipeline for each combination otherwise
+    struct DrawState {
+        vk::CullModeFlags     cull_mode;
+        vk::PrimitiveTopology primitive_topology;
+        bool                  blend_enable;
+
+        [[nodiscard]]
+        auto operator==(const DrawState&) const -> bool = default;
+    };
+
+    // Consecutive indirect draws sharing a pipeline and a state
+    struct DrawGroup {
+        cache::Handle<AsyncPipeline> pipeline;
+        DrawState                    state;
+        uint32_t                     first_draw;
+        uint32_t                     draw_count;
+    };
+
+    // What a render queue needs to know to order a draw
+    struct DrawInfo {
+        // Owned by the model, see AsyncPipeline::get()
+        gsl::not_null<const AsyncPipeline*>  pipeline;
+        graphics::Model::Material::AlphaMode alpha_mode;
+        // Max for the default material
+        uint32_t                             material_index;
+        // Mean origin of the instances in model space
+        glm::vec3                            position;
+        // In model space, around every instance
+        graphics::Model::Bounds              bounds;
+        DrawState                            state;
     };
 
     [[nodiscard]]
-    static auto descriptor_set_count() noexcept -> uint32_t;
+    static auto model_record_size() noexcept -> vk::DeviceSize;
+    [[nodiscard]]
+    static auto image_count(const graphics::Model& model) noexcept -> uint32_t;
+    // Includes the default sampler
     [[nodiscard]]
-    static auto descriptor_pool_sizes(const DescriptorSetLayoutCreateInfo& info
-    ) -> std::vector<vk::DescriptorPoolSize>;
+    static auto sampler_count(const graphics::Model& model) noexcept -> uint32_t;
 
+    [[nodiscard]]
+    static auto draw_features(vk::PhysicalDevice physical_device) -> DrawFeatures;
+
+    // Buffers are sub-allocated from buffer_arena and images from image_pool,
+    // both have to outlive the model. The staging memory comes from staging_ring,
+    // submit it along with the command buffer given to the task.
+    // Images of formats supported by host_image_copy skip the staging memory,
+    // they are decoded and copied on worker threads that the task waits for.
+    // Pipelines are compiled on worker threads that the task does not wait for,
+    // see PipelineCreateInfo::fallback_pipeline.
     [[nodiscard]]
     static auto create_loader(
-        vk::Device                                  device,
-        const Allocator&                            allocator,
-        std::span<const vk::DescriptorSetLayout, 3> descriptor_set_layouts,
-        const PipelineCreateInfo&                   pipeline_create_info,
-        vk::DescriptorPool                          descriptor_pool,
-        cache::Handle<graphics::Model>              model,
-        cache::Cache&                               cache
+        vk::Device                          device,
+        const ImagePool&                    image_pool,
+        const std::optional<HostImageCopy>& host_image_copy,
+        BufferArena&                        buffer_arena,
+        StagingRing&                        staging_ring,
+        const SceneSlot&                    scene_slot,
+        const PipelineCreateInfo&           pipeline_create_info,
+        const DrawFeatures&                 draw_features,
+        cache::Handle<graphics::Model>      model,
+        cache::Cache&                       cache
     ) -> std::packaged_task<RenderModel(vk::CommandBuffer)>;
 
-    [[nodiscard]]
-    static auto create_descriptor_set_layouts(
-        vk::Device                           t_device,
-        const DescriptorSetLayoutCreateInfo& info
-    ) -> std::array<vk::UniqueDescriptorSetLayout, 3>;
     [[nodiscard]]
     static auto push_constant_range() noexcept -> vk::PushConstantRange;
 
+    // Draws from the indirect command buffer built by the loader,
+    // binding each pipeline once
     auto draw(
         vk::CommandBuffer  t_graphics_command_buffer,
         vk::PipelineLayout t_pipeline_layout
     ) const noexcept -> void;
 
-private:
-    struct Mesh {
-        struct Primitive {
-            cache::Handle<vk::UniquePipeline> pipeline;
-            std::optional<uint32_t>           material_index;
-            uint32_t                          first_index_index;
-            uint32_t                          index_count;
-            uint32_t                          vertex_count;
-        };
-
-        std::vector<Primitive> primitives;
-    };
+    // Indexed by draw index, draws sharing a pipeline have consecutive indices
+    [[nodiscard]]
+    auto draw_infos() const noexcept -> std::span<const DrawInfo>;
+    [[nodiscard]]
+    auto draw_groups() const noexcept -> std::span<const DrawGroup>;
+    // Of the vk::DrawIndexedIndirectCommand written by the loader,
+    // for GPU culling to copy
+    [[nodiscard]]
+    auto draw_command_address(uint32_t t_draw_index) const noexcept -> vk::DeviceAddress;
 
-    Buffer m_index_buffer;
+    // Binds the index buffer and push constants of the model for draw_range()
+    auto bind(
+        vk::CommandBuffer  t_graphics_command_buffer,
+        vk::PipelineLayout t_pipeline_layout
+    ) const noexcept -> void;
 
-    // Base descriptor set
-    Buffer            m_vertex_buffer;
-    vk::DeviceAddress m_vertex_buffer_address;
-    MappedBuffer      m_vertex_uniform;
+    // Call it after binding the pipeline, as binding a pipeline with a static state
+    // would override it. Does nothing when the states are baked into the pipelines.
+    auto set_draw_state(
+        vk::CommandBuffer t_graphics_command_buffer,
+        const DrawState&  t_draw_state
+    ) const noexcept -> void;
 
-    Buffer            m_transform_buffer;
-    vk::DeviceAddress m_transform_buffer_address;
-    MappedBuffer      m_transform_uniform;
+    // The draws have to share the bound pipeline
+    auto draw_range(
+        vk::CommandBuffer  t_graphics_command_buffer,
+        vk::PipelineLayout t_pipeline_layout,
+        uint32_t           t_first_draw,
+        uint32_t           t_draw_count
+    ) const noexcept -> void;
 
-    vk::UniqueSampler m_default_sampler;
+    // Resident mip levels written by the loader,
+    // the buffers belong to the arena given to it
+    [[nodiscard]]
+    auto uploaded_resources() const -> UploadedResources;
 
-    Buffer            m_texture_buffer;
-    vk::DeviceAddress m_texture_buffer_address;
-    MappedBuffer      m_texture_uniform;
+    // Uploads the next finer mip level of each image that has finished decoding
+    // in the background, and starts decoding the one after it.
+    // Host copied images get their levels written by the decoding thread.
+    // Call it once every frame, after waiting for the fence of the frame
+    // and before recording it. Replaced views are written to the descriptor set
+    // of each frame in turn, and destroyed once no frame in flight uses them.
+    auto stream_images(
+        vk::Device        t_device,
+        const Allocator&  t_allocator,
+        vk::CommandBuffer t_transfer_command_buffer,
+        uint32_t          t_frame_index
+    ) -> void;
 
-    MappedBuffer m_default_material_uniform;
+    // Images become movable once all of their mip levels are resident.
+    // Recreates the views of the moved ones, call it before recording the frame
+    // whose Defragmenter::update() returned the relocations.
+    auto relocate(
+        vk::Device                       t_device,
+        const Defragmenter::Relocations& t_relocations,
+        uint32_t                         t_frame_index
+    ) -> void;
 
-    Buffer            m_material_buffer;
-    vk::DeviceAddress m_material_buffer_address;
-    MappedBuffer      m_material_uniform;
+private:
+    struct ImageStream {
+        uint32_t          image_index;
+        uint32_t          resident_mip_level;
+        MappedBuffer      staging_buffer{};
+        std::future<void> decoded_level{};
+    };
+
+    // Still written in the descriptor sets of earlier frames
+    struct RetiredImageView {
+        uint32_t            image_index;
+        vk::UniqueImageView image_view;
+        uint32_t            frames_until_destroyed;
+    };
 
-    vk::UniqueDescriptorSet m_base_descriptor_set;
+    BufferArena::Allocation m_index_buffer;
+
+    SceneSlot         m_scene_slot;
+    vk::UniqueSampler m_default_sampler;
 
-    // Image descriptor set
     std::vector<Image>               m_images;
     std::vector<vk::UniqueImageView> m_image_views;
-    vk::UniqueDescriptorSet          m_image_descriptor_set;
+    std::vector<RetiredImageView>    m_retired_image_views;
+    // Set once the images resident since loading were allowed to move
+    bool                             m_loaded_images_movable{};
+
+    // Mip level streaming
+    cache::Handle<graphics::Model> m_model;
+    std::vector<ImageStream>       m_image_streams;
+    std::optional<HostImageCopy>   m_host_image_copy;
+    // Set for the images written through m_host_image_copy
+    std::vector<bool>              m_host_copied_images;
 
-    // Sampler descriptor set
     std::vector<vk::UniqueSampler> m_samplers;
-    vk::UniqueDescriptorSet        m_sampler_descriptor_set;
 
-    // Pipelines
-    std::vector<Mesh> m_meshes;
+    // Indirect draws
+    BufferArena::Allocation m_draw_commands;
+    std::vector<DrawGroup>  m_draw_groups;
+    std::vector<DrawInfo>   m_draw_infos;
+    // Indexed by draw index, where the instance records of the draw start
+    std::vector<uint32_t>   m_first_instances;
+    DrawFeatures            m_draw_features;
 
 
     explicit RenderModel(
-        vk::Device                         device,
-        Buffer&&                           index_buffer,
-        Buffer&&                           vertex_buffer,
-        MappedBuffer&&                     vertex_uniform,
-        Buffer&&                           transform_buffer,
-        MappedBuffer&&                     transform_uniform,
-        vk::UniqueSampler&&                default_sampler,
-        Buffer&&                           texture_buffer,
-        MappedBuffer&&                     texture_uniform,
-        MappedBuffer&&                     default_material_uniform,
-        Buffer&&                           material_buffer,
-        MappedBuffer&&                     material_uniform,
-        vk::UniqueDescriptorSet&&          base_descriptor_set,
-        std::vector<Image>&&               images,
-        std::vector<vk::UniqueImageView>&& image_views,
-        vk::UniqueDescriptorSet&&          image_descriptor_set,
-        std::vector<vk::UniqueSampler>&&   samplers,
-        vk::UniqueDescriptorSet&&          sampler_descriptor_set,
-        std::vector<Mesh>&&                meshes
+        const BufferArena::Allocation&      index_buffer,
+        const SceneSlot&                    scene_slot,
+        vk::UniqueSampler&&                 default_sampler,
+        std::vector<Image>&&                images,
+        std::vector<vk::UniqueImageView>&&  image_views,
+        cache::Handle<graphics::Model>&&    model,
+        std::vector<ImageStream>&&          image_streams,
+        const std::optional<HostImageCopy>& host_image_copy,
+        std::vector<bool>&&                 host_copied_images,
+        std::vector<vk::UniqueSampler>&&    samplers,
+        const BufferArena::Allocation&      draw_commands,
+        std::vector<DrawGroup>&&            draw_groups,
+        std::vector<DrawInfo>&&             draw_infos,
+        std::vector<uint32_t>&&             first_instances,
+        const DrawFeatures&                 draw_features
     );
+
+    // Writes the current views of the retired ones to the set of the frame
+    auto retire_image_views(vk::Device t_device, uint32_t t_frame_index) -> void;
+    auto refresh_image_view(
+        vk::Device t_device,
+        uint32_t   t_image_index,
+        uint32_t   t_base_mip_level,
+        uint32_t   t_frame_index
+    ) -> void;
+    auto write_image_descriptor(
+        vk::Device t_device,
+        uint32_t   t_image_index,
+        uint32_t   t_frame_index
+    ) const -> void;
 };
 
 }   // namespace core::renderer
@@ -3,6 +3,11 @@
 // Required extensions:
 //     - VK_KHR_buffer_device_address
 //     - VK_EXT_descriptor_indexing
+// Optional extensions:
+//     - VK_EXT_extended_dynamic_state
+//     - VK_EXT_extended_dynamic_state3
+//     - VK_EXT_host_image_copy
+//     - VK_KHR_draw_indirect_count
 
 namespace core::renderer {
 
@@ -50,6 +55,7 @@ auto RenderModel::Requirements::require_device_settings(
     constexpr static vk::PhysicalDeviceDescriptorIndexingFeatures
         descriptor_indexing_features{
             .shaderSampledImageArrayNonUniformIndexing = vk::True,
+            .descriptorBindingPartiallyBound           = vk::True,
             .descriptorBindingVariableDescriptorCount  = vk::True,
             .runtimeDescriptorArray                    = vk::True,
         };
@@ -57,8 +63,68 @@ auto RenderModel::Requirements::require_device_settings(
     );
 }
 
-auto RenderModel::Requirements::enable_optional_device_settings(vkb::PhysicalDevice&)
-    -> void
-{}
+auto RenderModel::Requirements::enable_optional_device_settings(
+    vkb::PhysicalDevice& t_physical_device
+) -> void
+{
+    // RenderModel::DrawFeatures, each one is used on its own
+    t_physical_device.enable_features_if_present(vk::PhysicalDeviceFeatures{
+        .multiDrawIndirect = vk::True,
+    });
+    t_physical_device.enable_features_if_present(vk::PhysicalDeviceFeatures{
+        .drawIndirectFirstInstance = vk::True,
+    });
+
+    // VK_KHR_draw_indirect_count, for OcclusionCuller
+    t_physical_device.enable_extension_if_present(
+        VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME
+    );
+
+    // VK_EXT_extended_dynamic_state, RenderModel::DrawFeatures
+    if (t_physical_device.enable_extension_if_present(
+            VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME
+        ))
+    {
+        constexpr static vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT
+            extended_dynamic_state_features{
+                .extendedDynamicState = vk::True,
+            };
+        t_physical_device.enable_extension_features_if_present(
+            extended_dynamic_state_features
+        );
+
+        // VK_EXT_extended_dynamic_state3, only for blending
+        if (t_physical_device.enable_extension_if_present(
+                VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME
+            ))
+        {
+            constexpr static vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT
+                extended_dynamic_state_3_features{
+                    .extendedDynamicState3ColorBlendEnable = vk::True,
+                };
+            t_physical_device.enable_extension_features_if_present(
+                extended_dynamic_state_3_features
+            );
+        }
+    }
+
+    // VK_EXT_host_image_copy
+    if (t_physical_device.enable_extension_if_present(
+            VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME
+        ))
+    {
+        t_physical_device.enable_extension_if_present(
+            VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME
+        );
+        t_physical_device.enable_extension_if_present(
+            VK_KHR_FORMAT_FEATURE_FLAGS_2_EXTENSION_NAME
+        );
+        constexpr static vk::PhysicalDeviceHostImageCopyFeaturesEXT
+            host_image_copy_features{
+                .hostImageCopy = vk::True,
+            };
+        t_physical_device.enable_extension_features_if_present(host_image_copy_features);
+    }
+}
 
 }   // namespace core::renderer
@@ -0,0 +1,701 @@
+#include "Builder.hpp"
+
+#include <algorithm>
+#include <ranges>
+
+#include "core/renderer/base/device/Device.hpp"
+
+using namespace core::renderer;
+
+using ImageAccess  = RenderGraph::ImageAccess;
+using BufferAccess = RenderGraph::BufferAccess;
+
+constexpr static uint32_t g_graphics_queue_index{ 0 };
+constexpr static uint32_t g_compute_queue_index{ 1 };
+
+constexpr static vk::AccessFlags2 g_write_accesses{
+    vk::AccessFlagBits2::eShaderWrite | vk::AccessFlagBits2::eShaderStorageWrite
+    | vk::AccessFlagBits2::eColorAttachmentWrite
+    | vk::AccessFlagBits2::eDepthStencilAttachmentWrite
+    | vk::AccessFlagBits2::eTransferWrite | vk::AccessFlagBits2::eHostWrite
+    | vk::AccessFlagBits2::eMemoryWrite
+};
+
+// An access of a resource by the passes of a batch
+struct Use {
+    uint32_t                queue_index;
+    uint32_t                batch_index;
+    vk::PipelineStageFlags2 stage_mask;
+    vk::AccessFlags2        access_mask;
+};
+
+struct ResourceState {
+    vk::ImageLayout    layout{ vk::ImageLayout::eUndefined };
+    std::optional<Use> write;
+    // Since the last write, merged for each queue.
+    // The last write is already visible to these.
+    std::vector<Use>   reads;
+};
+
+[[nodiscard]]
+static auto writes(const vk::AccessFlags2 t_access_mask) noexcept -> bool
+{
+    return static_cast<bool>(t_access_mask & g_write_accesses);
+}
+
+[[nodiscard]]
+static auto reads(const vk::AccessFlags2 t_access_mask) noexcept -> bool
+{
+    return static_cast<bool>(t_access_mask & ~g_write_accesses);
+}
+
+[[nodiscard]]
+static auto queue_index(
+    const RenderGraph::QueueType t_queue_type,
+    const bool                   t_async_compute
+) noexcept -> uint32_t
+{
+    return t_queue_type == RenderGraph::QueueType::eAsyncCompute && t_async_compute
+             ? g_compute_queue_index
+             : g_graphics_queue_index;
+}
+
+static auto merge(std::vector<Use>& t_uses, const Use& t_use) -> void
+{
+    const auto iter{ std::ranges::find(t_uses, t_use.queue_index, &Use::queue_index) };
+    if (iter == t_uses.end()) {
+        t_uses.push_back(t_use);
+        return;
+    }
+
+    iter->batch_index  = std::max(iter->batch_index, t_use.batch_index);
+    iter->stage_mask  |= t_use.stage_mask;
+    iter->access_mask |= t_use.access_mask;
+}
+
+[[nodiscard]]
+static auto is_visible(const std::vector<Use>& t_reads, const Use& t_use) noexcept -> bool
+{
+    return std::ranges::any_of(t_reads, [&](const Use& read) {
+        return read.queue_index == t_use.queue_index
+            && (read.stage_mask & t_use.stage_mask) == t_use.stage_mask
+            && (read.access_mask & t_use.access_mask) == t_use.access_mask;
+    });
+}
+
+// Records the use, and returns the earlier ones it has to wait for
+[[nodiscard]]
+static auto
+    track_use(ResourceState& t_state, const Use& t_use, const vk::ImageLayout t_layout)
+        -> std::vector<Use>
+{
+    std::vector<Use> sources;
+
+    // Layout transitions write the image too
+    if (writes(t_use.access_mask) || t_layout != t_state.layout) {
+        if (t_state.write.has_value()) {
+            sources.push_back(*t_state.write);
+        }
+        sources.insert(sources.end(), t_state.reads.begin(), t_state.reads.end());
+
+        t_state.write = Use{
+            .queue_index = t_use.queue_index,
+            .batch_index = t_use.batch_index,
+            .stage_mask  = t_use.stage_mask,
+            .access_mask = t_use.access_mask & g_write_accesses,
+        };
+
+        t_state.layout = t_layout;
+        t_state.reads.clear();
+        return sources;
+    }
+
+    // Reads of the same data need no barrier between each other
+    if (t_state.write.has_value() && !is_visible(t_state.reads, t_use)) {
+        sources.push_back(*t_state.write);
+    }
+    merge(t_state.reads, t_use);
+    return sources;
+}
+
+[[nodiscard]]
+static auto view_type(const vk::ImageCreateInfo& t_create_info) noexcept
+    -> vk::ImageViewType
+{
+    const bool array{ t_create_info.arrayLayers > 1 };
+    switch (t_create_info.imageType) {
+        case vk::ImageType::e1D:
+            return array ? vk::ImageViewType::e1DArray : vk::ImageViewType::e1D;
+        case vk::ImageType::e3D: return vk::ImageViewType::e3D;
+        default: return array ? vk::ImageViewType::e2DArray : vk::ImageViewType::e2D;
+    }
+}
+
+[[nodiscard]]
+static auto create_command_pool(
+    const vk::Device t_device,
+    const uint32_t   t_queue_family_index
+) -> vk::UniqueCommandPool
+{
+    return t_device.createCommandPoolUnique(vk::CommandPoolCreateInfo{
+        .flags            = vk::CommandPoolCreateFlagBits::eTransient,
+        .queueFamilyIndex = t_queue_family_index,
+    });
+}
+
+namespace core::renderer {
+
+auto RenderGraph::Builder::import_image(const ImportedImage& t_image) -> ImageHandle
+{
+    m_images.push_back(ImageInfo{
+        .aspect_mask = t_image.aspect_mask,
+        .imported    = t_image,
+    });
+    return ImageHandle{ static_cast<uint32_t>(m_images.size() - 1) };
+}
+
+auto RenderGraph::Builder::create_image(
+    const vk::ImageCreateInfo& t_create_info,
+    const vk::ImageAspectFlags t_aspect_mask
+) -> ImageHandle
+{
+    m_images.push_back(ImageInfo{
+        .aspect_mask = t_aspect_mask,
+        .create_info = t_create_info,
+    });
+    return ImageHandle{ static_cast<uint32_t>(m_images.size() - 1) };
+}
+
+auto RenderGraph::Builder::import_buffer() -> BufferHandle
+{
+    return BufferHandle{ m_buffer_count++ };
+}
+
+auto RenderGraph::Builder::add_pass(Pass&& t_pass) -> Builder&
+{
+    m_passes.push_back(std::move(t_pass));
+    return *this;
+}
+
+auto RenderGraph::Builder::build(
+    const Device&            t_device,
+    TransientAttachmentPool& t_transient_attachments,
+    const uint32_t           t_frame_count
+) const -> RenderGraph
+{
+    const vkb::Device device{ t_device.info() };
+    const uint32_t    graphics_family_index{
+        device.get_queue_index(vkb::QueueType::graphics).value()
+    };
+    const auto separate_compute_family_index{
+        device.get_queue_index(vkb::QueueType::compute)
+    };
+    const bool async_compute{ separate_compute_family_index.has_value() };
+
+    // Compute passes stay on the graphics queue without a separate family
+    const uint32_t compute_family_index{
+        async_compute ? separate_compute_family_index.value() : graphics_family_index
+    };
+
+    const std::array<Queue, s_queue_count> queues{
+        Queue{
+            .queue        = t_device->getQueue(graphics_family_index, 0),
+            .family_index = graphics_family_index,
+        },
+        Queue{
+            .queue        = t_device->getQueue(compute_family_index, 0),
+            .family_index = compute_family_index,
+        },
+    };
+
+    std::vector<CompiledPass> passes;
+    for (Pass& pass : live_passes()) {
+        passes.push_back(CompiledPass{ .pass = std::move(pass) });
+    }
+
+    std::vector<Batch> batches;
+    for (const auto& [pass, pass_index] :
+         std::views::zip(passes, std::views::iota(0u, passes.size())))
+    {
+        const uint32_t queue{ queue_index(pass.pass.queue_type, async_compute) };
+        if (batches.empty() || batches.back().queue_index != queue) {
+            batches.push_back(Batch{
+                .queue_index = queue,
+                .first_pass  = pass_index,
+                .pass_count  = 0,
+            });
+        }
+        ++batches.back().pass_count;
+    }
+
+    std::vector<bool> compute_images(m_images.size());
+    for (const Batch& batch : batches) {
+        if (batch.queue_index != g_compute_queue_index) {
+            continue;
+        }
+        for (const CompiledPass& pass :
+             std::span{ passes }.subspan(batch.first_pass, batch.pass_count))
+        {
+            for (const ImageAccess& access : pass.pass.images) {
+                compute_images[access.image.index] = true;
+            }
+        }
+    }
+
+    std::vector<ImageResource> images(m_images.size());
+    create_transient_images(
+        t_device.get(), t_transient_attachments, passes, compute_images, queues, images
+    );
+
+    place_barriers(passes, batches, compute_images);
+
+    size_t semaphore_count{};
+    for (const Batch& batch : batches) {
+        semaphore_count += batch.dependencies.size();
+    }
+    const bool waits_for_previous_submission{
+        std::ranges::any_of(batches, &Batch::waits_for_previous_submission)
+    };
+
+    std::vector<Frame> frames{
+        std::views::iota(0u, t_frame_count) | std::views::transform([&](uint32_t) {
+            return Frame{
+                .command_pools = {
+                    FrameCommandPool{
+                        .command_pool =
+                            create_command_pool(t_device.get(), graphics_family_index),
+                    },
+                    FrameCommandPool{
+                        .command_pool =
+                            create_command_pool(t_device.get(), compute_family_index),
+                    },
+                },
+                .semaphores = std::views::iota(size_t{}, semaphore_count)
+                            | std::views::transform([&](size_t) {
+                                  return t_device->createSemaphoreUnique({});
+                              })
+                            | std::ranges::to<std::vector>(),
+                .submission_semaphore = waits_for_previous_submission
+                                          ? t_device->createSemaphoreUnique({})
+                                          : vk::UniqueSemaphore{},
+            };
+        })
+        | std::ranges::to<std::vector>()
+    };
+
+    return RenderGraph{ t_device.get(),
+                        queues,
+                        async_compute,
+                        std::move(passes),
+                        std::move(batches),
+                        std::move(frames),
+                        std::move(images),
+                        m_buffer_count };
+}
+
+auto RenderGraph::Builder::live_passes() const -> std::vector<Pass>
+{
+    std::vector<bool> read_images(m_images.size());
+    std::vector<bool> live(m_passes.size());
+
+    // A pass is live if it writes imported resources,
+    // or images read by later live passes
+    for (size_t pass_index{ m_passes.size() }; pass_index-- > 0;) {
+        const Pass& pass{ m_passes[pass_index] };
+
+        const bool writes_result{
+            std::ranges::any_of(
+                pass.buffers,
+                [](const BufferAccess& access) { return writes(access.access_mask); }
+            )
+            || std::ranges::any_of(pass.images, [&](const ImageAccess& access) {
+                   return writes(access.access_mask)
+                       && (m_images[access.image.index].imported.has_value()
+                           || read_images[access.image.index]);
+               })
+        };
+        if (!writes_result) {
+            continue;
+        }
+
+        live[pass_index] = true;
+        for (const ImageAccess& access : pass.images) {
+            if (reads(access.access_mask)) {
+                read_images[access.image.index] = true;
+            }
+        }
+    }
+
+    std::vector<Pass> passes;
+    for (const auto& [pass, is_live] : std::views::zip(m_passes, live)) {
+        if (is_live) {
+            passes.push_back(pass);
+        }
+    }
+    return passes;
+}
+
+auto RenderGraph::Builder::create_transient_images(
+    const vk::Device                    t_device,
+    TransientAttachmentPool&            t_transient_attachments,
+    const std::span<const CompiledPass> t_passes,
+    const std::vector<bool>&            t_compute_images,
+    const std::span<const Queue>        t_queues,
+    std::vector<ImageResource>&         t_images
+) const -> void
+{
+    const std::array queue_family_indices{
+        t_queues[g_graphics_queue_index].family_index,
+        t_queues[g_compute_queue_index].family_index,
+    };
+    const bool separate_families{ queue_family_indices[0] != queue_family_indices[1] };
+
+    std::vector<TransientAttachmentPool::Attachment> attachments;
+    std::vector<uint32_t>                            attachment_images;
+    for (const auto& [image, image_index] :
+         std::views::zip(m_images, std::views::iota(0u, m_images.size())))
+    {
+        if (!image.create_info.has_value()) {
+            continue;
+        }
+
+        std::optional<uint32_t> first_pass;
+        uint32_t                last_pass{};
+        for (const auto& [pass, pass_index] :
+             std::views::zip(t_passes, std::views::iota(0u, t_passes.size())))
+        {
+            if (std::ranges::any_of(pass.pass.images, [&](const ImageAccess& access) {
+                    return access.image.index == image_index;
+                }))
+            {
+                first_pass = first_pass.value_or(pass_index);
+                last_pass  = pass_index;
+            }
+        }
+        // Only used by culled passes
+        if (!first_pass.has_value()) {
+            continue;
+        }
+
+        TransientAttachmentPool::Attachment attachment{
+            .create_info = *image.create_info,
+            .first_pass  = *first_pass,
+            .last_pass   = last_pass,
+        };
+        // Async compute passes overlap graphics passes, so the order of the passes
+        // tells nothing about when these images are in use
+        if (t_compute_images[image_index]) {
+            attachment.first_pass = 0;
+            attachment.last_pass  = static_cast<uint32_t>(t_passes.size() - 1);
+            if (separate_families) {
+                attachment.create_info.sharingMode = vk::SharingMode::eConcurrent;
+                attachment.create_info.queueFamilyIndexCount =
+                    static_cast<uint32_t>(queue_family_indices.size());
+                attachment.create_info.pQueueFamilyIndices = queue_family_indices.data();
+            }
+        }
+        attachments.push_back(attachment);
+        attachment_images.push_back(image_index);
+    }
+
+    // Keeps the memory of the pool even without attachments, for later rebuilds
+    t_transient_attachments.create_attachments(attachments);
+
+    for (const auto& [image_index, attachment_index] : std::views::zip(
+             attachment_images, std::views::iota(0u, attachment_images.size())
+         ))
+    {
+        const ImageInfo&           info{ m_images[image_index] };
+        const vk::ImageCreateInfo& create_info{ *info.create_info };
+        ImageResource&             image{ t_images[image_index] };
+
+        image.image      = t_transient_attachments.image(attachment_index);
+        image.owned_view = t_device.createImageViewUnique(vk::ImageViewCreateInfo{
+            .image            = image.image,
+            .viewType         = view_type(create_info),
+            .format           = create_info.format,
+            .subresourceRange = vk::ImageSubresourceRange{
+                .aspectMask = info.aspect_mask,
+                .levelCount = create_info.mipLevels,
+                .layerCount = create_info.arrayLayers,
+            },
+        });
+        image.view       = image.owned_view.get();
+    }
+}
+
+auto RenderGraph::Builder::place_barriers(
+    const std::span<CompiledPass> t_passes,
+    const std::span<Batch>        t_batches,
+    const std::vector<bool>&      t_compute_images
+) const -> void
+{
+    if (t_batches.empty()) {
+        return;
+    }
+
+    // Transient images start out undefined in every submission,
+    // but the previous submission, or an aliased image of this one,
+    // may still be using their memory on the same queue
+    vk::PipelineStageFlags2 transient_stage_mask{};
+    vk::AccessFlags2        transient_write_mask{};
+    for (const CompiledPass& pass : t_passes) {
+        for (const ImageAccess& access : pass.pass.images) {
+            if (m_images[access.image.index].create_info.has_value()
+                && !t_compute_images[access.image.index])
+            {
+                transient_stage_mask |= access.stage_mask;
+                transient_write_mask |= access.access_mask & g_write_accesses;
+            }
+        }
+    }
+
+    const auto initial_state{ [&](const uint32_t image_index, const Use& first_use) {
+        const ImageInfo& image{ m_images[image_index] };
+        if (image.imported.has_value()) {
+            ResourceState state{ .layout = image.imported->initial_layout };
+            // The external wait semaphores are waited by the first batch
+            if (image.imported->initial_stage_mask) {
+                state.write = Use{
+                    .queue_index = t_batches.front().queue_index,
+                    .batch_index = 0,
+                    .stage_mask  = image.imported->initial_stage_mask,
+                };
+            }
+            return state;
+        }
+
+        // Images of the compute queue are ordered after the previous submission
+        // by a semaphore, see Batch::waits_for_previous_submission
+        const bool compute_image{ t_compute_images[image_index] };
+        return ResourceState{
+            .write = Use{
+                .queue_index = first_use.queue_index,
+                .batch_index = first_use.batch_index,
+                .stage_mask  = compute_image ? vk::PipelineStageFlagBits2::eAllCommands
+                                             : transient_stage_mask,
+                .access_mask = compute_image ? vk::AccessFlagBits2::eMemoryWrite
+                                             : transient_write_mask,
+            },
+        };
+    } };
+
+    // Returns the source masks of the barrier on the queue of the use,
+    // the other queue is waited for with semaphores
+    const auto synchronize{ [&](const std::vector<Use>& sources,
+                                const Use&              use,
+                                const bool              transition) {
+        vk::PipelineStageFlags2 stage_mask{};
+        vk::AccessFlags2        access_mask{};
+        for (const Use& source : sources) {
+            if (source.queue_index == use.queue_index) {
+                stage_mask  |= source.stage_mask;
+                access_mask |= source.access_mask & g_write_accesses;
+                continue;
+            }
+
+            add_dependency(
+                t_batches[use.batch_index],
+                Dependency{
+                    .source_batch      = source.batch_index,
+                    .source_stage_mask = source.stage_mask,
+                    .target_stage_mask = use.stage_mask,
+                }
+            );
+            // Layout transitions have to chain with the wait of the semaphore
+            if (transition) {
+                stage_mask |= use.stage_mask;
+            }
+        }
+        return std::pair{ stage_mask, access_mask };
+    } };
+
+    const auto image_barrier{ [&](const uint32_t                image_index,
+                                  const vk::ImageLayout         old_layout,
+                                  const vk::ImageLayout         new_layout,
+                                  const vk::PipelineStageFlags2 src_stage_mask,
+                                  const vk::AccessFlags2        src_access_mask,
+                                  const Use&                    use) {
+        return ImageBarrier{
+            .image_index = image_index,
+            .barrier =
+                vk::ImageMemoryBarrier2{
+                    .srcStageMask        = src_stage_mask,
+                    .srcAccessMask       = src_access_mask,
+                    .dstStageMask        = use.stage_mask,
+                    .dstAccessMask       = use.access_mask,
+                    .oldLayout           = old_layout,
+                    .newLayout           = new_layout,
+                    .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+                    .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+                    .subresourceRange =
+                        vk::ImageSubresourceRange{
+                            .aspectMask = m_images[image_index].aspect_mask,
+                            .levelCount = vk::RemainingMipLevels,
+                            .layerCount = vk::RemainingArrayLayers,
+                        },
+                },
+        };
+    } };
+
+    const auto add_memory_barrier{ [](Barriers&                     barriers,
+                                      const vk::PipelineStageFlags2 src_stage_mask,
+                                      const vk::AccessFlags2        src_access_mask,
+                                      const Use&                    use) {
+        if (!src_stage_mask && !src_access_mask) {
+            return;
+        }
+        if (!barriers.memory_barrier.has_value()) {
+            barriers.memory_barrier.emplace();
+        }
+        barriers.memory_barrier->srcStageMask  |= src_stage_mask;
+        barriers.memory_barrier->srcAccessMask |= src_access_mask;
+        barriers.memory_barrier->dstStageMask  |= use.stage_mask;
+        barriers.memory_barrier->dstAccessMask |= use.access_mask;
+    } };
+
+    std::vector<std::optional<ResourceState>> image_states(m_images.size());
+    std::vector<ResourceState>                buffer_states(m_buffer_count);
+
+    for (const auto& [batch, batch_index] :
+         std::views::zip(t_batches, std::views::iota(0u, t_batches.size())))
+    {
+        for (CompiledPass& pass : t_passes.subspan(batch.first_pass, batch.pass_count)) {
+            for (const ImageAccess& access : pass.pass.images) {
+                const Use use{
+                    .queue_index = batch.queue_index,
+                    .batch_index = batch_index,
+                    .stage_mask  = access.stage_mask,
+                    .access_mask = access.access_mask,
+                };
+
+                std::optional<ResourceState>& state{ image_states[access.image.index] };
+                if (!state.has_value()) {
+                    state = initial_state(access.image.index, use);
+                }
+                const vk::ImageLayout  old_layout{ state->layout };
+                const std::vector<Use> sources{ track_use(*state, use, access.layout) };
+                const bool             transition{ old_layout != access.layout };
+
+                const auto [src_stage_mask, src_access_mask]{
+                    synchronize(sources, use, transition)
+                };
+                if (transition) {
+                    pass.barriers.image_barriers.push_back(image_barrier(
+                        access.image.index,
+                        old_layout,
+                        access.layout,
+                        src_stage_mask,
+                        src_access_mask,
+                        use
+                    ));
+                }
+                else {
+                    add_memory_barrier(
+                        pass.barriers, src_stage_mask, src_access_mask, use
+                    );
+                }
+            }
+
+            for (const BufferAccess& access : pass.pass.buffers) {
+                const Use use{
+                    .queue_index = batch.queue_index,
+                    .batch_index = batch_index,
+                    .stage_mask  = access.stage_mask,
+                    .access_mask = access.access_mask,
+                };
+
+                ResourceState&         state{ buffer_states[access.buffer.index] };
+                const std::vector<Use> sources{ track_use(state, use, state.layout) };
+
+                const auto [src_stage_mask, src_access_mask]{
+                    synchronize(sources, use, false)
+                };
+                add_memory_barrier(pass.barriers, src_stage_mask, src_access_mask, use);
+            }
+        }
+    }
+
+    // The fence and the external signal semaphores are submitted with the last batch,
+    // so it waits for the other queue too
+    Batch& last_batch{ t_batches.back() };
+
+    const Use final_use{
+        .queue_index = last_batch.queue_index,
+        .batch_index = static_cast<uint32_t>(t_batches.size() - 1),
+        .stage_mask  = vk::PipelineStageFlagBits2::eAllCommands,
+    };
+
+    for (const auto& [image, image_index] :
+         std::views::zip(m_images, std::views::iota(0u, m_images.size())))
+    {
+        if (!image.imported.has_value()
+            || image.imported->final_layout == vk::ImageLayout::eUndefined)
+        {
+            continue;
+        }
+
+        std::optional<ResourceState>& state{ image_states[image_index] };
+        if (!state.has_value()) {
+            state = initial_state(image_index, final_use);
+        }
+        if (state->layout == image.imported->final_layout) {
+            continue;
+        }
+
+        const vk::ImageLayout  old_layout{ state->layout };
+        const std::vector<Use> sources{
+            track_use(*state, final_use, image.imported->final_layout)
+        };
+        const auto [src_stage_mask, src_access_mask]{
+            synchronize(sources, final_use, true)
+        };
+        last_batch.final_barriers.image_barriers.push_back(image_barrier(
+            image_index,
+            old_layout,
+            image.imported->final_layout,
+            src_stage_mask,
+            src_access_mask,
+            final_use
+        ));
+    }
+
+    std::optional<uint32_t> other_last_batch_index;
+    for (const auto& [batch, batch_index] :
+         std::views::zip(t_batches, std::views::iota(0u, t_batches.size())))
+    {
+        if (batch.queue_index != last_batch.queue_index) {
+            if (!other_last_batch_index.has_value()) {
+                batch.waits_for_previous_submission = true;
+            }
+            other_last_batch_index = batch_index;
+        }
+    }
+    if (other_last_batch_index.has_value()) {
+        add_dependency(
+            last_batch,
+            Dependency{
+                .source_batch      = *other_last_batch_index,
+                .source_stage_mask = vk::PipelineStageFlagBits2::eAllCommands,
+                .target_stage_mask = vk::PipelineStageFlagBits2::eAllCommands,
+            }
+        );
+    }
+}
+
+auto RenderGraph::Builder::add_dependency(Batch& t_batch, const Dependency& t_dependency)
+    -> void
+{
+    const auto iter{ std::ranges::find(
+        t_batch.dependencies, t_dependency.source_batch, &Dependency::source_batch
+    ) };
+    if (iter == t_batch.dependencies.end()) {
+        t_batch.dependencies.push_back(t_dependency);
+        return;
+    }
+
+    iter->source_stage_mask |= t_dependency.source_stage_mask;
+    iter->target_stage_mask |= t_dependency.target_stage_mask;
+}
+
+}   // namespace core::renderer
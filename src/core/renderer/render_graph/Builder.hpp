@@ -0,0 +1,70 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "core/renderer/memory/TransientAttachmentPool.hpp"
+
+#include "RenderGraph.hpp"
+
+namespace core::renderer {
+
+class Device;
+
+class RenderGraph::Builder {
+public:
+    auto import_image(const ImportedImage& image) -> ImageHandle;
+    // Owned by the graph, sharing memory with images of other passes where possible
+    auto create_image(
+        const vk::ImageCreateInfo& create_info,
+        vk::ImageAspectFlags       aspect_mask
+    ) -> ImageHandle;
+    auto import_buffer() -> BufferHandle;
+
+    auto add_pass(Pass&& pass) -> Builder&;
+
+    // Culls the passes, places the barriers and creates the transient images.
+    // Each of the frame_count frames in flight gets its own command buffers.
+    // The transient images replace the ones of the graph built before with the same
+    // pool, which must not be submitted anymore. Keeping the pool across rebuilds,
+    // like after the swapchain is recreated, lets it reuse its memory.
+    [[nodiscard]]
+    auto build(
+        const Device&            device,
+        TransientAttachmentPool& transient_attachments,
+        uint32_t                 frame_count
+    ) const -> RenderGraph;
+
+private:
+    struct ImageInfo {
+        vk::ImageAspectFlags               aspect_mask;
+        std::optional<ImportedImage>       imported;
+        std::optional<vk::ImageCreateInfo> create_info;
+    };
+
+    std::vector<ImageInfo> m_images;
+    uint32_t               m_buffer_count{};
+    std::vector<Pass>      m_passes;
+
+    [[nodiscard]]
+    auto live_passes() const -> std::vector<Pass>;
+    // Images used on the compute queue are shared by both queues,
+    // and are kept apart from other images for the whole graph
+    auto create_transient_images(
+        vk::Device                    device,
+        TransientAttachmentPool&      transient_attachments,
+        std::span<const CompiledPass> passes,
+        const std::vector<bool>&      compute_images,
+        std::span<const Queue>        queues,
+        std::vector<ImageResource>&   images
+    ) const -> void;
+    auto place_barriers(
+        std::span<CompiledPass>  passes,
+        std::span<Batch>         batches,
+        const std::vector<bool>& compute_images
+    ) const -> void;
+
+    static auto add_dependency(Batch& batch, const Dependency& dependency) -> void;
+};
+
+}   // namespace core::renderer
@@ -0,0 +1,257 @@
+#include "RenderGraph.hpp"
+
+#include <ranges>
+
+#include "Builder.hpp"
+
+namespace core::renderer {
+
+RenderGraph::RenderGraph(RenderGraph&&) noexcept = default;
+
+RenderGraph::~RenderGraph() noexcept = default;
+
+auto RenderGraph::operator=(RenderGraph&&) noexcept -> RenderGraph& = default;
+
+auto RenderGraph::create() -> Builder
+{
+    return Builder{};
+}
+
+auto RenderGraph::set_image(
+    const ImageHandle   t_handle,
+    const vk::Image     t_image,
+    const vk::ImageView t_image_view
+) -> void
+{
+    ImageResource& image{ m_images.at(t_handle.index) };
+    image.image = t_image;
+    image.view  = t_image_view;
+}
+
+auto RenderGraph::set_buffer(const BufferHandle t_handle, const vk::Buffer t_buffer)
+    -> void
+{
+    m_buffers.at(t_handle.index) = t_buffer;
+}
+
+auto RenderGraph::submit(const SubmitInfo& t_submit_info) -> void
+{
+    Frame& frame{ m_frames.at(t_submit_info.frame_index) };
+    for (FrameCommandPool& command_pool : frame.command_pools) {
+        m_device.resetCommandPool(command_pool.command_pool.get());
+        command_pool.used_count = 0;
+    }
+
+    // Everything was culled, the semaphores and the fence are still expected
+    if (m_batches.empty()) {
+        m_queues.front().queue.submit2KHR(
+            vk::SubmitInfo2{
+                .waitSemaphoreInfoCount =
+                    static_cast<uint32_t>(t_submit_info.wait_semaphores.size()),
+                .pWaitSemaphoreInfos = t_submit_info.wait_semaphores.data(),
+                .signalSemaphoreInfoCount =
+                    static_cast<uint32_t>(t_submit_info.signal_semaphores.size()),
+                .pSignalSemaphoreInfos = t_submit_info.signal_semaphores.data(),
+            },
+            t_submit_info.fence
+        );
+        return;
+    }
+
+    for (const auto& [batch, batch_index] :
+         std::views::zip(m_batches, std::views::iota(0u, m_batches.size())))
+    {
+        const vk::CommandBuffer command_buffer{
+            acquire_command_buffer(frame, batch.queue_index)
+        };
+        command_buffer.begin(vk::CommandBufferBeginInfo{
+            .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+        });
+        for (const CompiledPass& pass :
+             std::span{ m_passes }.subspan(batch.first_pass, batch.pass_count))
+        {
+            record_barriers(command_buffer, pass.barriers);
+            pass.pass.record(command_buffer, *this);
+        }
+        record_barriers(command_buffer, batch.final_barriers);
+        command_buffer.end();
+
+        const bool last_batch{ batch_index + 1 == m_batches.size() };
+
+        std::vector<vk::SemaphoreSubmitInfo> wait_semaphores;
+        for (const auto& [dependency, semaphore_index] : std::views::zip(
+                 batch.dependencies,
+                 std::views::iota(m_first_semaphores[batch_index])
+             ))
+        {
+            wait_semaphores.push_back(vk::SemaphoreSubmitInfo{
+                .semaphore = frame.semaphores[semaphore_index].get(),
+                .stageMask = dependency.target_stage_mask,
+            });
+        }
+        if (batch_index == 0) {
+            wait_semaphores.insert(
+                wait_semaphores.end(),
+                t_submit_info.wait_semaphores.begin(),
+                t_submit_info.wait_semaphores.end()
+            );
+        }
+        if (batch.waits_for_previous_submission && m_previous_frame_index.has_value()) {
+            wait_semaphores.push_back(vk::SemaphoreSubmitInfo{
+                .semaphore =
+                    m_frames[*m_previous_frame_index].submission_semaphore.get(),
+                .stageMask = vk::PipelineStageFlagBits2::eAllCommands,
+            });
+        }
+
+        std::vector<vk::SemaphoreSubmitInfo> signal_semaphores;
+        for (const auto& [target_batch, first_semaphore] :
+             std::views::zip(m_batches, m_first_semaphores))
+        {
+            for (const auto& [dependency, semaphore_index] : std::views::zip(
+                     target_batch.dependencies, std::views::iota(first_semaphore)
+                 ))
+            {
+                if (dependency.source_batch == batch_index) {
+                    signal_semaphores.push_back(vk::SemaphoreSubmitInfo{
+                        .semaphore = frame.semaphores[semaphore_index].get(),
+                        .stageMask = dependency.source_stage_mask,
+                    });
+                }
+            }
+        }
+        if (last_batch) {
+            signal_semaphores.insert(
+                signal_semaphores.end(),
+                t_submit_info.signal_semaphores.begin(),
+                t_submit_info.signal_semaphores.end()
+            );
+            if (frame.submission_semaphore) {
+                signal_semaphores.push_back(vk::SemaphoreSubmitInfo{
+                    .semaphore = frame.submission_semaphore.get(),
+                    .stageMask = vk::PipelineStageFlagBits2::eAllCommands,
+                });
+            }
+        }
+
+        const vk::CommandBufferSubmitInfo command_buffer_info{
+            .commandBuffer = command_buffer,
+        };
+        m_queues[batch.queue_index].queue.submit2KHR(
+            vk::SubmitInfo2{
+                .waitSemaphoreInfoCount = static_cast<uint32_t>(wait_semaphores.size()),
+                .pWaitSemaphoreInfos    = wait_semaphores.data(),
+                .commandBufferInfoCount = 1,
+                .pCommandBufferInfos    = &command_buffer_info,
+                .signalSemaphoreInfoCount =
+                    static_cast<uint32_t>(signal_semaphores.size()),
+                .pSignalSemaphoreInfos = signal_semaphores.data(),
+            },
+            last_batch ? t_submit_info.fence : vk::Fence{}
+        );
+    }
+
+    m_previous_frame_index = t_submit_info.frame_index;
+}
+
+auto RenderGraph::image(const ImageHandle t_handle) const -> vk::Image
+{
+    return m_images.at(t_handle.index).image;
+}
+
+auto RenderGraph::image_view(const ImageHandle t_handle) const -> vk::ImageView
+{
+    return m_images.at(t_handle.index).view;
+}
+
+auto RenderGraph::buffer(const BufferHandle t_handle) const -> vk::Buffer
+{
+    return m_buffers.at(t_handle.index);
+}
+
+auto RenderGraph::pass_count() const noexcept -> uint32_t
+{
+    return static_cast<uint32_t>(m_passes.size());
+}
+
+auto RenderGraph::async_compute() const noexcept -> bool
+{
+    return m_async_compute;
+}
+
+RenderGraph::RenderGraph(
+    const vk::Device                        t_device,
+    const std::array<Queue, s_queue_count>& t_queues,
+    const bool                              t_async_compute,
+    std::vector<CompiledPass>&&             t_passes,
+    std::vector<Batch>&&                    t_batches,
+    std::vector<Frame>&&                    t_frames,
+    std::vector<ImageResource>&&            t_images,
+    const uint32_t                          t_buffer_count
+)
+    : m_device{ t_device },
+      m_queues{ t_queues },
+      m_async_compute{ t_async_compute },
+      m_passes{ std::move(t_passes) },
+      m_batches{ std::move(t_batches) },
+      m_frames{ std::move(t_frames) },
+      m_images{ std::move(t_images) },
+      m_buffers(t_buffer_count)
+{
+    uint32_t semaphore_count{};
+    for (const Batch& batch : m_batches) {
+        m_first_semaphores.push_back(semaphore_count);
+        semaphore_count += static_cast<uint32_t>(batch.dependencies.size());
+    }
+}
+
+auto RenderGraph::record_barriers(
+    const vk::CommandBuffer t_command_buffer,
+    const Barriers&         t_barriers
+) const -> void
+{
+    if (!t_barriers.memory_barrier.has_value() && t_barriers.image_barriers.empty()) {
+        return;
+    }
+
+    const std::vector<vk::ImageMemoryBarrier2> image_barriers{
+        t_barriers.image_barriers
+        | std::views::transform([this](const ImageBarrier& image_barrier) {
+              vk::ImageMemoryBarrier2 barrier{ image_barrier.barrier };
+              barrier.image = m_images[image_barrier.image_index].image;
+              return barrier;
+          })
+        | std::ranges::to<std::vector>()
+    };
+
+    t_command_buffer.pipelineBarrier2KHR(vk::DependencyInfo{
+        .memoryBarrierCount = t_barriers.memory_barrier.has_value() ? 1u : 0u,
+        .pMemoryBarriers    = t_barriers.memory_barrier.has_value()
+                                ? &*t_barriers.memory_barrier
+                                : nullptr,
+        .imageMemoryBarrierCount = static_cast<uint32_t>(image_barriers.size()),
+        .pImageMemoryBarriers    = image_barriers.data(),
+    });
+}
+
+auto RenderGraph::acquire_command_buffer(Frame& t_frame, const uint32_t t_queue_index)
+    -> vk::CommandBuffer
+{
+    FrameCommandPool& command_pool{ t_frame.command_pools.at(t_queue_index) };
+
+    if (command_pool.used_count == command_pool.command_buffers.size()) {
+        command_pool.command_buffers.push_back(
+            m_device
+                .allocateCommandBuffers(vk::CommandBufferAllocateInfo{
+                    .commandPool        = command_pool.command_pool.get(),
+                    .level              = vk::CommandBufferLevel::ePrimary,
+                    .commandBufferCount = 1,
+                })
+                .front()
+        );
+    }
+
+    return command_pool.command_buffers[command_pool.used_count++];
+}
+
+}   // namespace core::renderer
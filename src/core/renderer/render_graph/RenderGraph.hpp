@@ -0,0 +1,241 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+namespace core::renderer {
+
+// Passes declare the images and buffers they access, the graph works out the rest:
+//  - passes whose results are never used are culled,
+//  - synchronization2 barriers are placed right before the passes that need them,
+//    one vkCmdPipelineBarrier2 per pass, merging every buffer into a global barrier,
+//  - images created by the graph live in a TransientAttachmentPool given to the
+//    builder, sharing memory when their passes do not overlap,
+//  - compute passes run on a separate compute queue where the device has one,
+//    with semaphores between the batches of the two queues.
+// Passes are recorded in the order they were added, that order defines the data flow.
+class RenderGraph {
+public:
+    ///------------------///
+    ///  Nested classes  ///
+    ///------------------///
+    class Builder;
+    class Requirements;
+
+    struct ImageHandle {
+        uint32_t index;
+    };
+
+    struct BufferHandle {
+        uint32_t index;
+    };
+
+    enum class QueueType : uint8_t {
+        eGraphics,
+        // Falls back to the graphics queue
+        eAsyncCompute,
+    };
+
+    // A pass may access a resource once, with the union of its stages and accesses
+    struct ImageAccess {
+        ImageHandle             image;
+        vk::PipelineStageFlags2 stage_mask;
+        vk::AccessFlags2        access_mask;
+        // The pass gets the image in this layout, and has to leave it in it
+        vk::ImageLayout         layout;
+    };
+
+    struct BufferAccess {
+        BufferHandle            buffer;
+        vk::PipelineStageFlags2 stage_mask;
+        vk::AccessFlags2        access_mask;
+    };
+
+    struct Pass {
+        std::string               name;
+        QueueType                 queue_type{ QueueType::eGraphics };
+        std::vector<ImageAccess>  images;
+        std::vector<BufferAccess> buffers;
+        // Resources are looked up through the graph
+        std::function<void(vk::CommandBuffer, const RenderGraph&)> record;
+    };
+
+    // An image owned outside of the graph, like a swapchain image.
+    // Passes writing imported resources are never culled.
+    struct ImportedImage {
+        vk::ImageAspectFlags    aspect_mask{ vk::ImageAspectFlagBits::eColor };
+        vk::ImageLayout         initial_layout{ vk::ImageLayout::eUndefined };
+        // Where the wait semaphores guarding the image block, like the stage
+        // waiting for the image acquired semaphore of a swapchain image
+        vk::PipelineStageFlags2 initial_stage_mask{ vk::PipelineStageFlagBits2::eNone };
+        // Left in eUndefined, the image keeps the layout of its last use
+        vk::ImageLayout         final_layout{ vk::ImageLayout::eUndefined };
+    };
+
+    struct SubmitInfo {
+        uint32_t                                 frame_index;
+        // Waited by the first batch of the graphics queue
+        std::span<const vk::SemaphoreSubmitInfo> wait_semaphores;
+        // Signaled, along with the fence, once both queues are done
+        std::span<const vk::SemaphoreSubmitInfo> signal_semaphores;
+        vk::Fence                                fence;
+    };
+
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph(RenderGraph&&) noexcept;
+    ~RenderGraph() noexcept;
+
+    ///-------------///
+    ///  Operators  ///
+    ///-------------///
+    auto operator=(const RenderGraph&) -> RenderGraph& = delete;
+    auto operator=(RenderGraph&&) noexcept -> RenderGraph&;
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    [[nodiscard]]
+    static auto create() -> Builder;
+
+    // Imported resources have to be set before every submission
+    auto set_image(ImageHandle t_handle, vk::Image t_image, vk::ImageView t_image_view)
+        -> void;
+    auto set_buffer(BufferHandle t_handle, vk::Buffer t_buffer) -> void;
+
+    // Records the passes and submits them.
+    // The GPU must be done with the previous submission of the frame index.
+    auto submit(const SubmitInfo& t_submit_info) -> void;
+
+    [[nodiscard]]
+    auto image(ImageHandle t_handle) const -> vk::Image;
+    [[nodiscard]]
+    auto image_view(ImageHandle t_handle) const -> vk::ImageView;
+    [[nodiscard]]
+    auto buffer(BufferHandle t_handle) const -> vk::Buffer;
+
+    // Of the passes left after culling
+    [[nodiscard]]
+    auto pass_count() const noexcept -> uint32_t;
+    [[nodiscard]]
+    auto async_compute() const noexcept -> bool;
+
+private:
+    friend Builder;
+
+    ///******************///
+    ///  Nested classes  ///
+    ///******************///
+    constexpr static uint32_t s_queue_count{ 2 };
+
+    struct ImageBarrier {
+        uint32_t                image_index;
+        // With a null image, filled in when recorded
+        vk::ImageMemoryBarrier2 barrier;
+    };
+
+    struct Barriers {
+        std::optional<vk::MemoryBarrier2> memory_barrier;
+        std::vector<ImageBarrier>         image_barriers;
+    };
+
+    struct CompiledPass {
+        Pass     pass;
+        // Recorded right before the pass
+        Barriers barriers;
+    };
+
+    // A semaphore from the batch of one queue to a later batch of the other
+    struct Dependency {
+        uint32_t                source_batch;
+        vk::PipelineStageFlags2 source_stage_mask;
+        vk::PipelineStageFlags2 target_stage_mask;
+    };
+
+    // Consecutive passes of the same queue, submitted together
+    struct Batch {
+        uint32_t                queue_index;
+        uint32_t                first_pass;
+        uint32_t                pass_count;
+        std::vector<Dependency> dependencies;
+        // Recorded after the last pass, like transitions to the final layouts
+        Barriers                final_barriers;
+        // The first batch of the queue not submitting last waits for the previous
+        // submission to finish, so it cannot race it on the resources of the graph
+        bool                    waits_for_previous_submission{};
+    };
+
+    struct Queue {
+        vk::Queue queue;
+        uint32_t  family_index;
+    };
+
+    struct FrameCommandPool {
+        vk::UniqueCommandPool          command_pool;
+        // Reused after each reset, it only grows
+        std::vector<vk::CommandBuffer> command_buffers;
+        uint32_t                       used_count{};
+    };
+
+    struct Frame {
+        std::array<FrameCommandPool, s_queue_count> command_pools;
+        // One for every dependency, in the order of the batches
+        std::vector<vk::UniqueSemaphore>            semaphores;
+        // Signaled by the last batch, null if no batch waits for it
+        vk::UniqueSemaphore                         submission_semaphore;
+    };
+
+    struct ImageResource {
+        vk::Image           image;
+        vk::ImageView       view;
+        vk::UniqueImageView owned_view;
+    };
+
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    vk::Device                       m_device;
+    std::array<Queue, s_queue_count> m_queues;
+    bool                             m_async_compute;
+    std::vector<CompiledPass>        m_passes;
+    std::vector<Batch>               m_batches;
+    std::vector<uint32_t>            m_first_semaphores;
+    std::vector<Frame>               m_frames;
+    std::vector<ImageResource>       m_images;
+    std::vector<vk::Buffer>          m_buffers;
+    std::optional<uint32_t>          m_previous_frame_index;
+
+    ///******************************///
+    ///  Constructors / Destructors  ///
+    ///******************************///
+    explicit RenderGraph(
+        vk::Device                              t_device,
+        const std::array<Queue, s_queue_count>& t_queues,
+        bool                                    t_async_compute,
+        std::vector<CompiledPass>&&             t_passes,
+        std::vector<Batch>&&                    t_batches,
+        std::vector<Frame>&&                    t_frames,
+        std::vector<ImageResource>&&            t_images,
+        uint32_t                                t_buffer_count
+    );
+
+    ///***********///
+    ///  Methods  ///
+    ///***********///
+    auto record_barriers(vk::CommandBuffer t_command_buffer, const Barriers& t_barriers)
+        const -> void;
+    [[nodiscard]]
+    auto acquire_command_buffer(Frame& t_frame, uint32_t t_queue_index)
+        -> vk::CommandBuffer;
+};
+
+}   // namespace core::renderer
@@ -0,0 +1,47 @@
+#include "Requirements.hpp"
+
+// Required extensions:
+//     - VK_KHR_synchronization2
+
+namespace core::renderer {
+
+auto RenderGraph::Requirements::required_instance_settings_are_available(
+    const vkb::SystemInfo& t_system_info
+) -> bool
+{
+    return t_system_info.is_extension_available(
+        VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME
+    );
+}
+
+auto RenderGraph::Requirements::enable_instance_settings(
+    const vkb::SystemInfo&,
+    vkb::InstanceBuilder& t_instance_builder
+) -> void
+{
+    t_instance_builder.enable_extension(
+        VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME
+    );
+}
+
+auto RenderGraph::Requirements::require_device_settings(
+    vkb::PhysicalDeviceSelector& t_physical_device_selector
+) -> void
+{
+    // VK_KHR_synchronization2
+    t_physical_device_selector.add_required_extension(
+        VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME
+    );
+    constexpr static vk::PhysicalDeviceSynchronization2FeaturesKHR
+        synchronization2_features{
+            .synchronization2 = vk::True,
+        };
+    t_physical_device_selector.add_required_extension_features(synchronization2_features
+    );
+}
+
+auto RenderGraph::Requirements::enable_optional_device_settings(vkb::PhysicalDevice&)
+    -> void
+{}
+
+}   // namespace core::renderer
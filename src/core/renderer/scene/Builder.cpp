@@ -1,96 +1,111 @@
 #include "Builder.hpp"
 
 #include "core/renderer/base/descriptor_pool/Builder.hpp"
+#include "core/renderer/base/device/Device.hpp"
 
 using namespace core;
 using namespace core::renderer;
 
 [[nodiscard]]
-static auto create_global_descriptor_set_layout(const vk::Device t_device
-) -> vk::UniqueDescriptorSetLayout
+static auto image_count(const std::vector<Scene::Builder::ModelInfo>& t_models) noexcept
+    -> uint32_t
 {
-    constexpr static std::array bindings{
-        vk::DescriptorSetLayoutBinding{
-                                       .binding         = 0,
-                                       .descriptorType  = vk::DescriptorType::eUniformBuffer,
-                                       .descriptorCount = 1,
-                                       .stageFlags      = vk::ShaderStageFlagBits::eVertex
-                        | vk::ShaderStageFlagBits::eFragment },
-    };
-
-    constexpr static vk::DescriptorSetLayoutCreateInfo create_info{
-        .bindingCount = static_cast<uint32_t>(bindings.size()),
-        .pBindings    = bindings.data()
-    };
-
-    return t_device.createDescriptorSetLayoutUnique(create_info);
+    uint32_t count{};
+    for (const Scene::Builder::ModelInfo& model : t_models) {
+        count += RenderModel::image_count(*model.handle);
+    }
+    return count;
 }
 
 [[nodiscard]]
-static auto max_image_count(const std::vector<Scene::Builder::ModelInfo>& t_models
+static auto sampler_count(const std::vector<Scene::Builder::ModelInfo>& t_models
 ) noexcept -> uint32_t
 {
-    return static_cast<uint32_t>(std::ranges::max_element(
-                                     t_models,
-                                     {},
-                                     [](const Scene::Builder::ModelInfo& model) {
-                                         return model.handle->images().size();
-                                     }
-    )
-                                     ->handle->images()
-                                     .size());
+    uint32_t count{};
+    for (const Scene::Builder::ModelInfo& model : t_models) {
+        count += RenderModel::sampler_count(*model.handle);
+    }
+    return count;
 }
 
 [[nodiscard]]
-static auto max_sampler_count(const std::vector<Scene::Builder::ModelInfo>& t_models
-) noexcept -> uint32_t
+static auto create_global_descriptor_set_layout(
+    const vk::Device t_device,
+    const uint32_t   t_image_count,
+    const uint32_t   t_sampler_count
+) -> vk::UniqueDescriptorSetLayout
 {
-    return static_cast<uint32_t>(std::ranges::max_element(
-                                     t_models,
-                                     {},
-                                     [](const Scene::Builder::ModelInfo& model) {
-                                         return model.handle->samplers().size();
-                                     }
-    )
-                                     ->handle->samplers()
-                                     .size());
-}
+    const std::array bindings{
+        // scene
+        vk::DescriptorSetLayoutBinding{
+            .binding         = 0,
+            .descriptorType  = vk::DescriptorType::eUniformBufferDynamic,
+            .descriptorCount = 1,
+            .stageFlags      = vk::ShaderStageFlagBits::eVertex
+                        | vk::ShaderStageFlagBits::eFragment,
+        },
+        // images
+        vk::DescriptorSetLayoutBinding{
+            .binding         = RenderModel::s_image_binding,
+            .descriptorType  = vk::DescriptorType::eSampledImage,
+            .descriptorCount = t_image_count,
+            .stageFlags      = vk::ShaderStageFlagBits::eFragment,
+        },
+        // samplers
+        vk::DescriptorSetLayoutBinding{
+            .binding         = RenderModel::s_sampler_binding,
+            .descriptorType  = vk::DescriptorType::eSampler,
+            .descriptorCount = t_sampler_count,
+            .stageFlags      = vk::ShaderStageFlagBits::eFragment,
+        },
+    };
+    // Models without images or samplers leave their part of the arrays unwritten
+    const std::array flags{
+        vk::DescriptorBindingFlags{},
+        vk::DescriptorBindingFlags{ vk::DescriptorBindingFlagBits::ePartiallyBound },
+        vk::DescriptorBindingFlags{ vk::DescriptorBindingFlagBits::ePartiallyBound },
+    };
+    const vk::DescriptorSetLayoutBindingFlagsCreateInfo binding_flags{
+        .bindingCount  = static_cast<uint32_t>(flags.size()),
+        .pBindingFlags = flags.data(),
+    };
 
-static auto request_descriptors(
-    const graphics::Model&   t_model,
-    DescriptorPool::Builder& t_descriptor_pool_builder
-) -> void
-{
-    t_descriptor_pool_builder.request_descriptor_sets(RenderModel::descriptor_set_count());
-    t_descriptor_pool_builder.request_descriptors(
-        RenderModel::descriptor_pool_sizes(RenderModel::DescriptorSetLayoutCreateInfo{
-            .max_image_count   = static_cast<uint32_t>(t_model.images().size()),
-            .max_sampler_count = static_cast<uint32_t>(t_model.samplers().size()),
-        })
-    );
+    const vk::DescriptorSetLayoutCreateInfo create_info{
+        .pNext        = &binding_flags,
+        .bindingCount = static_cast<uint32_t>(bindings.size()),
+        .pBindings    = bindings.data(),
+    };
+
+    return t_device.createDescriptorSetLayoutUnique(create_info);
 }
 
 [[nodiscard]]
 static auto create_descriptor_pool(
-    const vk::Device                              t_device,
-    const std::vector<Scene::Builder::ModelInfo>& t_models
+    const vk::Device t_device,
+    const uint32_t   t_image_count,
+    const uint32_t   t_sampler_count,
+    const uint32_t   t_frame_count
 ) -> DescriptorPool
 {
     auto builder{ DescriptorPool::create() };
 
-    builder.request_descriptor_sets(1);
+    builder.request_descriptor_sets(t_frame_count);
     builder.request_descriptors(vk::DescriptorPoolSize{
-        .type            = vk::DescriptorType::eUniformBuffer,
-        .descriptorCount = 1,
+        .type            = vk::DescriptorType::eUniformBufferDynamic,
+        .descriptorCount = t_frame_count,
     });
-
-    std::ranges::for_each(
-        t_models,
-        [&](const graphics::Model& model) { request_descriptors(model, builder); },
-        [](const Scene::Builder::ModelInfo& model_info) -> const graphics::Model& {
-            return *model_info.handle;
-        }
-    );
+    if (t_image_count > 0) {
+        builder.request_descriptors(vk::DescriptorPoolSize{
+            .type            = vk::DescriptorType::eSampledImage,
+            .descriptorCount = t_image_count * t_frame_count,
+        });
+    }
+    if (t_sampler_count > 0) {
+        builder.request_descriptors(vk::DescriptorPoolSize{
+            .type            = vk::DescriptorType::eSampler,
+            .descriptorCount = t_sampler_count * t_frame_count,
+        });
+    }
 
     return builder.build(t_device);
 }
@@ -113,53 +128,66 @@ static auto create_pipeline_layout(
     return t_device.createPipelineLayoutUnique(pipeline_layout_create_info);
 }
 
-template <typename GlobalUniformBlock>
-[[nodiscard]]
-static auto create_global_buffer(const Allocator& t_allocator) -> MappedBuffer
-{
-    constexpr vk::BufferCreateInfo buffer_create_info = {
-        .size  = sizeof(GlobalUniformBlock),
-        .usage = vk::BufferUsageFlagBits::eUniformBuffer
-    };
-
-    return t_allocator.allocate_mapped_buffer(buffer_create_info);
-}
-
-template <typename GlobalUniformBlock>
+// One for each frame in flight
 [[nodiscard]]
-static auto create_global_descriptor_set(
+static auto create_global_descriptor_sets(
     const vk::Device              t_device,
     const vk::DescriptorSetLayout t_layout,
     const vk::DescriptorPool      t_pool,
-    const vk::Buffer              t_global_buffer
-) -> vk::UniqueDescriptorSet
+    const UniformRing&            t_global_buffer
+) -> std::vector<vk::UniqueDescriptorSet>
 {
+    const std::vector layouts(t_global_buffer.frame_count(), t_layout);
+
     const vk::DescriptorSetAllocateInfo descriptor_set_allocate_info{
         .descriptorPool     = t_pool,
-        .descriptorSetCount = 1,
-        .pSetLayouts        = &t_layout,
+        .descriptorSetCount = static_cast<uint32_t>(layouts.size()),
+        .pSetLayouts        = layouts.data(),
     };
     auto descriptor_sets{
         t_device.allocateDescriptorSetsUnique(descriptor_set_allocate_info)
     };
 
+    // The slice of the frame is selected by the dynamic offset when binding
     const vk::DescriptorBufferInfo buffer_info{
-        .buffer = t_global_buffer,
+        .buffer = t_global_buffer.get(),
         .offset = 0,
-        .range  = sizeof(GlobalUniformBlock),
+        .range  = t_global_buffer.slice_size(),
     };
 
-    const vk::WriteDescriptorSet write_descriptor_set{
-        .dstSet          = descriptor_sets.front().get(),
-        .dstBinding      = 0,
-        .descriptorCount = 1,
-        .descriptorType  = vk::DescriptorType::eUniformBuffer,
-        .pBufferInfo     = &buffer_info,
-    };
+    for (const vk::UniqueDescriptorSet& descriptor_set : descriptor_sets) {
+        const vk::WriteDescriptorSet write_descriptor_set{
+            .dstSet          = descriptor_set.get(),
+            .dstBinding      = 0,
+            .descriptorCount = 1,
+            .descriptorType  = vk::DescriptorType::eUniformBufferDynamic,
+            .pBufferInfo     = &buffer_info,
+        };
+
+        t_device.updateDescriptorSets(1, &write_descriptor_set, 0, nullptr);
+    }
 
-    t_device.updateDescriptorSets(1, &write_descriptor_set, 0, nullptr);
+    return descriptor_sets;
+}
+
+// Textures of every format are expected to share the memory type of this one
+[[nodiscard]]
+static auto create_image_pool(const Allocator& t_allocator) -> ImagePool
+{
+    const vk::ImageCreateInfo example_image_create_info{
+        .imageType   = vk::ImageType::e2D,
+        .format      = vk::Format::eR8G8B8A8Unorm,
+        .extent      = vk::Extent3D{ .width = 1, .height = 1, .depth = 1 },
+        .mipLevels   = 1,
+        .arrayLayers = 1,
+        .samples     = vk::SampleCountFlagBits::e1,
+        .tiling      = vk::ImageTiling::eOptimal,
+        .usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
+        .sharingMode   = vk::SharingMode::eExclusive,
+        .initialLayout = vk::ImageLayout::eUndefined,
+    };
 
-    return std::move(descriptor_sets.front());
+    return ImagePool{ t_allocator, example_image_create_info };
 }
 
 namespace core::renderer {
@@ -170,6 +198,34 @@ auto Scene::Builder::set_cache(cache::Cache& t_cache) noexcept -> Scene::Builder
     return *this;
 }
 
+auto Scene::Builder::set_host_image_copy(const HostImageCopy& t_host_image_copy) noexcept
+    -> Scene::Builder&
+{
+    m_host_image_copy = t_host_image_copy;
+    return *this;
+}
+
+auto Scene::Builder::set_pipeline_cache(const vk::PipelineCache t_pipeline_cache) noexcept
+    -> Scene::Builder&
+{
+    m_pipeline_cache = t_pipeline_cache;
+    return *this;
+}
+
+auto Scene::Builder::set_fallback_pipeline(const vk::Pipeline t_fallback_pipeline
+) noexcept -> Scene::Builder&
+{
+    m_fallback_pipeline = t_fallback_pipeline;
+    return *this;
+}
+
+auto Scene::Builder::set_thread_pool(utils::ThreadPool& t_thread_pool) noexcept
+    -> Scene::Builder&
+{
+    m_thread_pool = t_thread_pool;
+    return *this;
+}
+
 auto Scene::Builder::add_model(
     const cache::Handle<graphics::Model>& t_model,
     const Effect&                         t_effect
@@ -189,97 +245,162 @@ auto Scene::Builder::add_model(
 }
 
 auto Scene::Builder::build(
-    vk::Device       t_device,
+    const Device&    t_device,
     const Allocator& t_allocator,
-    vk::RenderPass   t_render_pass
+    StagingRing&     t_staging_ring,
+    vk::RenderPass   t_render_pass,
+    const uint32_t   t_frame_count
 ) const -> std::packaged_task<Scene(vk::CommandBuffer)>
 {
     cache::Cache temp_cache{};
 
+    const uint32_t image_count{ ::image_count(m_models) };
+    const uint32_t sampler_count{ ::sampler_count(m_models) };
+
     vk::UniqueDescriptorSetLayout global_descriptor_set_layout{
-        create_global_descriptor_set_layout(t_device)
+        create_global_descriptor_set_layout(t_device.get(), image_count, sampler_count)
     };
 
-    std::array model_descriptor_set_layouts{ RenderModel::create_descriptor_set_layouts(
-        t_device,
-        RenderModel::DescriptorSetLayoutCreateInfo{
-            .max_image_count   = max_image_count(m_models),
-            .max_sampler_count = max_sampler_count(m_models),
-        }
+    vk::UniquePipelineLayout pipeline_layout{ create_pipeline_layout(
+        t_device.get(), std::array{ global_descriptor_set_layout.get() }
     ) };
 
-    vk::UniquePipelineLayout pipeline_layout{ create_pipeline_layout(
-        t_device,
-        std::array{
-            global_descriptor_set_layout.get(),
-            model_descriptor_set_layouts[0].get(),
-            model_descriptor_set_layouts[1].get(),
-            model_descriptor_set_layouts[2].get(),
-        }
+    DescriptorPool descriptor_pool{ create_descriptor_pool(
+        t_device.get(), image_count, sampler_count, t_frame_count
     ) };
 
-    DescriptorPool descriptor_pool{ create_descriptor_pool(t_device, m_models) };
+    UniformRing global_buffer{ t_allocator, sizeof(Scene::ShaderScene), t_frame_count };
 
-    MappedBuffer global_buffer{
-        create_global_buffer<Scene::ShaderScene>(t_allocator)
-    };
-
-    vk::UniqueDescriptorSet global_descriptor_set{
-        create_global_descriptor_set<Scene::ShaderScene>(
-            t_device,
+    std::vector<vk::UniqueDescriptorSet> global_descriptor_sets{
+        create_global_descriptor_sets(
+            t_device.get(),
             global_descriptor_set_layout.get(),
             descriptor_pool.get(),
-            global_buffer.get()
+            global_buffer
         )
     };
-
-    std::vector model_loaders{
-        m_models | std::views::transform([&](const ModelInfo& model_info) {
-            return RenderModel::create_loader(
-                t_device,
-                t_allocator,
-                std::array{
-                    model_descriptor_set_layouts[0].get(),
-                    model_descriptor_set_layouts[1].get(),
-                    model_descriptor_set_layouts[2].get(),
-                },
-                RenderModel::PipelineCreateInfo{ .effect      = model_info.effect,
-                                                 .layout      = pipeline_layout.get(),
-                                                 .render_pass = t_render_pass },
-                descriptor_pool.get(),
-                model_info.handle,
-                m_cache.value_or(temp_cache)
-            );
-        })
+    const std::vector scene_descriptor_sets{
+        global_descriptor_sets
+        | std::views::transform([](const vk::UniqueDescriptorSet& descriptor_set) {
+              return descriptor_set.get();
+          })
         | std::ranges::to<std::vector>()
     };
 
+    BufferArena buffer_arena{ t_device.get(),
+                              t_allocator,
+                              vk::BufferUsageFlagBits::eIndexBuffer
+                                  | vk::BufferUsageFlagBits::eIndirectBuffer
+                                  | vk::BufferUsageFlagBits::eStorageBuffer
+                                  | vk::BufferUsageFlagBits::eTransferDst,
+                              MemoryUsage::eUploadDirect };
+
+    ImagePool image_pool{ create_image_pool(t_allocator) };
+
+    const RenderModel::DrawFeatures draw_features{
+        RenderModel::draw_features(t_device.physical_device())
+    };
+
+    const BufferArena::Allocation model_table{ buffer_arena.allocate(
+        RenderModel::model_record_size() * m_models.size(), 16
+    ) };
+
+    std::vector<std::packaged_task<RenderModel(vk::CommandBuffer)>> model_loaders;
+    uint32_t                                                        first_image{};
+    uint32_t                                                        first_sampler{};
+    for (const auto& [model_info, model_index] :
+         std::views::zip(m_models, std::views::iota(0u, m_models.size())))
+    {
+        const vk::DeviceSize record_offset{
+            RenderModel::model_record_size() * model_index
+        };
+        const std::span<std::byte> record_data{
+            model_table.mapped_data.empty()
+                ? std::span<std::byte>{}
+                : model_table.mapped_data.subspan(
+                      record_offset, RenderModel::model_record_size()
+                  )
+        };
+        model_loaders.push_back(RenderModel::create_loader(
+            t_device.get(),
+            image_pool,
+            m_host_image_copy,
+            buffer_arena,
+            t_staging_ring,
+            RenderModel::SceneSlot{
+                .descriptor_sets = scene_descriptor_sets,
+                .model_index     = model_index,
+                .model_record =
+                    BufferArena::Allocation{
+                        .buffer      = model_table.buffer,
+                        .offset      = model_table.offset + record_offset,
+                        .size        = RenderModel::model_record_size(),
+                        .address     = model_table.address + record_offset,
+                        .mapped_data = record_data,
+                    },
+                .first_image   = first_image,
+                .first_sampler = first_sampler,
+            },
+            RenderModel::PipelineCreateInfo{
+                .effect            = model_info.effect,
+                .layout            = pipeline_layout.get(),
+                .render_pass       = t_render_pass,
+                .pipeline_cache    = m_pipeline_cache,
+                .fallback_pipeline = m_fallback_pipeline,
+                .thread_pool       = m_thread_pool,
+            },
+            draw_features,
+            model_info.handle,
+            m_cache.value_or(temp_cache)
+        ));
+
+        first_image   += RenderModel::image_count(*model_info.handle);
+        first_sampler += RenderModel::sampler_count(*model_info.handle);
+    }
+
     return std::packaged_task<Scene(vk::CommandBuffer)>{
         [global_descriptor_set_layout = auto{ std::move(global_descriptor_set_layout) },
-         model_descriptor_set_layouts = auto{ std::move(model_descriptor_set_layouts) },
          pipeline_layout              = auto{ std::move(pipeline_layout) },
          descriptor_pool              = auto{ std::move(descriptor_pool) },
          global_buffer                = auto{ std::move(global_buffer) },
-         global_descriptor_set        = auto{ std::move(global_descriptor_set) },
+         global_descriptor_sets       = auto{ std::move(global_descriptor_sets) },
+         buffer_arena                 = auto{ std::move(buffer_arena) },
+         image_pool                   = auto{ std::move(image_pool) },
+         model_table_address          = model_table.address,
          model_loaders                = auto{ std::move(model_loaders
          ) }](vk::CommandBuffer t_transfer_command_buffer) mutable -> Scene {
+            std::vector<RenderModel> models{
+                model_loaders
+                | std::views::transform(
+                    [t_transfer_command_buffer](
+                        std::packaged_task<RenderModel(vk::CommandBuffer)>& model_task
+                    ) {
+                        std::invoke(model_task, t_transfer_command_buffer);
+                        return model_task.get_future().get();
+                    }
+                )
+                | std::ranges::to<std::vector>()
+            };
+
+            FrustumCuller frustum_culler;
+            for (const RenderModel& model : models) {
+                for (const RenderModel::DrawInfo& draw_info : model.draw_infos()) {
+                    frustum_culler.push(draw_info.bounds);
+                }
+            }
+
             return Scene(
                 std::move(global_descriptor_set_layout),
-                std::move(model_descriptor_set_layouts),
                 std::move(pipeline_layout),
                 std::move(descriptor_pool),
                 std::move(global_buffer),
-                std::move(global_descriptor_set),
-                model_loaders
-                    | std::views::transform(
-                        [t_transfer_command_buffer](
-                            std::packaged_task<RenderModel(vk::CommandBuffer)>& model_task
-                        ) {
-                            std::invoke(model_task, t_transfer_command_buffer);
-                            return model_task.get_future().get();
-                        }
-                    )
-                    | std::ranges::to<std::vector>()
+                std::move(global_descriptor_sets),
+                std::move(buffer_arena),
+                std::move(image_pool),
+                model_table_address,
+                std::move(models),
+                std::move(frustum_culler),
+                std::make_unique<utils::ThreadPool>()
             );
         }
     };
@@ -10,6 +10,8 @@
 
 namespace core::renderer {
 
+class Device;
+
 class Scene::Builder {
 public:
     struct ModelInfo {
@@ -18,19 +20,40 @@ public:
     };
 
     auto set_cache(cache::Cache& cache) noexcept -> Builder&;
+    // Textures get copied from the CPU for formats it supports,
+    // see HostImageCopy::create()
+    auto set_host_image_copy(const HostImageCopy& host_image_copy) noexcept -> Builder&;
+    // Pipelines are compiled through it, like the one of the PipelineCache in the store
+    auto set_pipeline_cache(vk::PipelineCache pipeline_cache) noexcept -> Builder&;
+    // Pipelines compile in the background, draws use this one until theirs are done,
+    // see RenderModel::PipelineCreateInfo
+    auto set_fallback_pipeline(vk::Pipeline fallback_pipeline) noexcept -> Builder&;
+    // Pipelines compile on it, like the one in the store,
+    // they are compiled while loading without one
+    auto set_thread_pool(utils::ThreadPool& thread_pool) noexcept -> Builder&;
 
     auto add_model(const cache::Handle<graphics::Model>& model, const Effect& effect)
         -> Builder&;
     auto add_model(cache::Handle<graphics::Model>&& model, const Effect& effect)
         -> Builder&;
 
+    // The scene keeps a copy of its uniforms for each of the frame_count frames in flight
     [[nodiscard]]
-    auto build(vk::Device device, const Allocator& allocator, vk::RenderPass render_pass)
-        const -> std::packaged_task<Scene(vk::CommandBuffer)>;
+    auto build(
+        const Device&    device,
+        const Allocator& allocator,
+        StagingRing&     staging_ring,
+        vk::RenderPass   render_pass,
+        uint32_t         frame_count
+    ) const -> std::packaged_task<Scene(vk::CommandBuffer)>;
 
 private:
-    std::optional<std::reference_wrapper<cache::Cache>> m_cache;
-    std::vector<ModelInfo>                              m_models;
+    std::optional<std::reference_wrapper<cache::Cache>>      m_cache;
+    std::optional<HostImageCopy>                             m_host_image_copy;
+    vk::PipelineCache                                        m_pipeline_cache;
+    vk::Pipeline                                             m_fallback_pipeline;
+    std::optional<std::reference_wrapper<utils::ThreadPool>> m_thread_pool;
+    std::vector<ModelInfo>                                   m_models;
 };
 
 }   // namespace core::renderer
@@ -0,0 +1,124 @@
+#include "FrustumCuller.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE__)
+    #include <xmmintrin.h>
+#endif
+
+#include "core/utility/tasks.hpp"
+
+// Boxes tested by one instruction
+constexpr static size_t g_lane_count{ 4 };
+// Smaller chunks cost more in scheduling than they save
+constexpr static size_t g_min_groups_per_task{ 4096 };
+
+namespace core::renderer {
+
+auto FrustumCuller::push(const graphics::Model::Bounds& t_bounds) -> void
+{
+    if (m_box_count % g_lane_count == 0) {
+        const size_t padded_count{ m_box_count + g_lane_count };
+        for (std::vector<float>* const values : { &m_center_xs,
+                                                  &m_center_ys,
+                                                  &m_center_zs,
+                                                  &m_extent_xs,
+                                                  &m_extent_ys,
+                                                  &m_extent_zs })
+        {
+            values->resize(padded_count);
+        }
+        m_visibility.resize(padded_count);
+    }
+
+    const glm::vec3 center{ (t_bounds.min + t_bounds.max) / 2.f };
+    const glm::vec3 extent{ (t_bounds.max - t_bounds.min) / 2.f };
+    m_center_xs[m_box_count] = center.x;
+    m_center_ys[m_box_count] = center.y;
+    m_center_zs[m_box_count] = center.z;
+    m_extent_xs[m_box_count] = extent.x;
+    m_extent_ys[m_box_count] = extent.y;
+    m_extent_zs[m_box_count] = extent.z;
+    m_box_count++;
+}
+
+auto FrustumCuller::cull(
+    const std::array<glm::vec4, 6>& t_planes,
+    utils::ThreadPool&              t_thread_pool
+) -> std::span<const uint8_t>
+{
+    const size_t group_count{ m_center_xs.size() / g_lane_count };
+    const size_t task_count{ utils::task_count(group_count, g_min_groups_per_task) };
+    const size_t chunk_size{ (group_count + task_count - 1) / task_count };
+
+    utils::run_tasks(t_thread_pool, task_count, [&](const size_t task_index) {
+        const size_t first{ std::min(task_index * chunk_size, group_count) };
+        const size_t last{ std::min(first + chunk_size, group_count) };
+        for (size_t group_index{ first }; group_index < last; group_index++) {
+            const size_t   first_box{ group_index * g_lane_count };
+            const uint32_t outside{ outside_mask(first_box, t_planes) };
+            for (size_t lane{}; lane < g_lane_count; lane++) {
+                m_visibility[first_box + lane] = ((outside >> lane) & 1u) == 0 ? 1 : 0;
+            }
+        }
+    });
+
+    return std::span{ m_visibility }.first(m_box_count);
+}
+
+auto FrustumCuller::outside_mask(
+    const size_t                    t_first_box,
+    const std::array<glm::vec4, 6>& t_planes
+) const -> uint32_t
+{
+#if defined(__SSE__)
+    const __m128 center_x{ _mm_loadu_ps(&m_center_xs[t_first_box]) };
+    const __m128 center_y{ _mm_loadu_ps(&m_center_ys[t_first_box]) };
+    const __m128 center_z{ _mm_loadu_ps(&m_center_zs[t_first_box]) };
+    const __m128 extent_x{ _mm_loadu_ps(&m_extent_xs[t_first_box]) };
+    const __m128 extent_y{ _mm_loadu_ps(&m_extent_ys[t_first_box]) };
+    const __m128 extent_z{ _mm_loadu_ps(&m_extent_zs[t_first_box]) };
+
+    __m128 outside{ _mm_setzero_ps() };
+    for (const glm::vec4& plane : t_planes) {
+        // Signed distance of the centers and the extents projected onto the normal
+        const __m128 distance{ _mm_add_ps(
+            _mm_add_ps(
+                _mm_mul_ps(center_x, _mm_set1_ps(plane.x)),
+                _mm_mul_ps(center_y, _mm_set1_ps(plane.y))
+            ),
+            _mm_add_ps(_mm_mul_ps(center_z, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w))
+        ) };
+        const __m128 radius{ _mm_add_ps(
+            _mm_add_ps(
+                _mm_mul_ps(extent_x, _mm_set1_ps(glm::abs(plane.x))),
+                _mm_mul_ps(extent_y, _mm_set1_ps(glm::abs(plane.y)))
+            ),
+            _mm_mul_ps(extent_z, _mm_set1_ps(glm::abs(plane.z)))
+        ) };
+        outside = _mm_or_ps(
+            outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps())
+        );
+    }
+
+    return static_cast<uint32_t>(_mm_movemask_ps(outside));
+#else
+    uint32_t outside{};
+    for (size_t lane{}; lane < g_lane_count; lane++) {
+        const size_t    box{ t_first_box + lane };
+        const glm::vec3 center{ m_center_xs[box], m_center_ys[box], m_center_zs[box] };
+        const glm::vec3 extent{ m_extent_xs[box], m_extent_ys[box], m_extent_zs[box] };
+        for (const glm::vec4& plane : t_planes) {
+            const glm::vec3 normal{ plane };
+            if (glm::dot(center, normal) + plane.w + glm::dot(extent, glm::abs(normal))
+                < 0)
+            {
+                outside |= 1u << lane;
+            }
+        }
+    }
+    return outside;
+#endif
+}
+
+}   // namespace core::renderer
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "core/graphics/model/Model.hpp"
+#include "core/utility/ThreadPool.hpp"
+
+namespace core::renderer {
+
+// Tests axis-aligned boxes against the planes of a frustum, several boxes at once.
+// Boxes are stored as a structure of arrays, one SIMD lane for each box.
+class FrustumCuller {
+public:
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    // Only the box of the bounds is used
+    auto push(const graphics::Model::Bounds& t_bounds) -> void;
+
+    // Returns whether each box intersects the frustum, in the order of pushing.
+    // Planes are expected the way graphics::Camera::frustum_planes() returns them.
+    // Large sets of boxes are split across the thread pool.
+    [[nodiscard]]
+    auto cull(const std::array<glm::vec4, 6>& t_planes, utils::ThreadPool& t_thread_pool)
+        -> std::span<const uint8_t>;
+
+private:
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    size_t m_box_count{};
+    // Padded with empty boxes to a whole number of SIMD registers
+    std::vector<float>   m_center_xs;
+    std::vector<float>   m_center_ys;
+    std::vector<float>   m_center_zs;
+    std::vector<float>   m_extent_xs;
+    std::vector<float>   m_extent_ys;
+    std::vector<float>   m_extent_zs;
+    std::vector<uint8_t> m_visibility;
+
+    ///***********///
+    ///  Methods  ///
+    ///***********///
+    // Bit i is set if box t_first_box + i is outside of any of the planes
+    [[nodiscard]]
+    auto outside_mask(size_t t_first_box, const std::array<glm::vec4, 6>& t_planes) const
+        -> uint32_t;
+};
+
+}   // namespace core::renderer
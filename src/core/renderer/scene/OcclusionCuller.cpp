@@ -0,0 +1,749 @@
+#include "OcclusionCuller.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <ranges>
+#include <string>
+#include <utility>
+
+#include "core/renderer/base/descriptor_pool/Builder.hpp"
+#include "core/renderer/base/device/Device.hpp"
+
+using namespace core;
+using namespace core::renderer;
+
+struct ShaderCullDraw {
+    glm::vec4         center;
+    glm::vec4         extent;
+    vk::DeviceAddress command;
+    uint32_t          output_index;
+    uint32_t          count_index;
+};
+
+struct ShaderCullCamera {
+    glm::mat4                view_projection;
+    std::array<glm::vec4, 6> frustum_planes;
+    glm::vec2                depth_extent;
+    glm::vec2                padding;
+};
+
+struct PushConstants {
+    vk::DeviceAddress draws;
+    vk::DeviceAddress commands;
+    vk::DeviceAddress counts;
+    vk::DeviceAddress visibilities;
+    uint32_t          draw_count;
+    uint32_t          phase;
+};
+
+// Local sizes of the shaders
+constexpr static uint32_t g_cull_group_size{ 64 };
+constexpr static uint32_t g_pyramid_group_size{ 8 };
+// Enough for 32768 pixel wide depth attachments
+constexpr static uint32_t g_max_level_count{ 16 };
+
+constexpr static vk::Format     g_pyramid_format{ vk::Format::eR32Sfloat };
+constexpr static vk::DeviceSize g_command_stride{
+    sizeof(vk::DrawIndexedIndirectCommand)
+};
+constexpr static vk::DeviceSize g_count_stride{ sizeof(uint32_t) };
+constexpr static vk::ImageSubresourceRange g_pyramid_range{
+    .aspectMask     = vk::ImageAspectFlagBits::eColor,
+    .baseMipLevel   = 0,
+    .levelCount     = vk::RemainingMipLevels,
+    .baseArrayLayer = 0,
+    .layerCount     = 1,
+};
+
+[[nodiscard]]
+static auto draw_indirect_count_enabled(const Device& t_device) -> bool
+{
+    const std::vector<std::string> extensions{
+        t_device.info().physical_device.get_extensions()
+    };
+    return std::ranges::find(extensions, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME)
+        != extensions.cend();
+}
+
+[[nodiscard]]
+static auto buffer_address(const vk::Device t_device, const vk::Buffer t_buffer)
+    -> vk::DeviceAddress
+{
+    return t_device.getBufferAddress(vk::BufferDeviceAddressInfo{ .buffer = t_buffer });
+}
+
+// Each level is half the size of the previous one, rounded up, down to 1x1
+[[nodiscard]]
+static auto pyramid_extent(const vk::Extent2D t_depth_extent) noexcept -> vk::Extent2D
+{
+    return vk::Extent2D{
+        .width  = std::max((t_depth_extent.width + 1) / 2, 1u),
+        .height = std::max((t_depth_extent.height + 1) / 2, 1u),
+    };
+}
+
+[[nodiscard]]
+static auto level_count(const vk::Extent2D t_extent) noexcept -> uint32_t
+{
+    const uint32_t size{ std::max(t_extent.width, t_extent.height) };
+    return std::min(
+        static_cast<uint32_t>(std::bit_width(size - 1)) + 1, g_max_level_count
+    );
+}
+
+[[nodiscard]]
+static auto create_sampler(const vk::Device t_device) -> vk::UniqueSampler
+{
+    return t_device.createSamplerUnique(vk::SamplerCreateInfo{
+        .magFilter    = vk::Filter::eNearest,
+        .minFilter    = vk::Filter::eNearest,
+        .mipmapMode   = vk::SamplerMipmapMode::eNearest,
+        .addressModeU = vk::SamplerAddressMode::eClampToEdge,
+        .addressModeV = vk::SamplerAddressMode::eClampToEdge,
+        .addressModeW = vk::SamplerAddressMode::eClampToEdge,
+        .maxLod       = vk::LodClampNone,
+    });
+}
+
+[[nodiscard]]
+static auto create_descriptor_set_layout(
+    const vk::Device                                      t_device,
+    const std::span<const vk::DescriptorSetLayoutBinding> t_bindings
+) -> vk::UniqueDescriptorSetLayout
+{
+    return t_device.createDescriptorSetLayoutUnique(vk::DescriptorSetLayoutCreateInfo{
+        .bindingCount = static_cast<uint32_t>(t_bindings.size()),
+        .pBindings    = t_bindings.data(),
+    });
+}
+
+[[nodiscard]]
+static auto create_pipeline_layout(
+    const vk::Device              t_device,
+    const vk::DescriptorSetLayout t_descriptor_set_layout,
+    const uint32_t                t_push_constants_size
+) -> vk::UniquePipelineLayout
+{
+    const vk::PushConstantRange push_constant_range{
+        .stageFlags = vk::ShaderStageFlagBits::eCompute,
+        .size       = t_push_constants_size,
+    };
+
+    return t_device.createPipelineLayoutUnique(vk::PipelineLayoutCreateInfo{
+        .setLayoutCount         = 1,
+        .pSetLayouts            = &t_descriptor_set_layout,
+        .pushConstantRangeCount = t_push_constants_size > 0 ? 1u : 0u,
+        .pPushConstantRanges    = &push_constant_range,
+    });
+}
+
+[[nodiscard]]
+static auto create_compute_pipeline(
+    const vk::Device         t_device,
+    const vk::PipelineCache  t_pipeline_cache,
+    const vk::PipelineLayout t_layout,
+    const Shader&            t_shader
+) -> vk::UniquePipeline
+{
+    const vk::ComputePipelineCreateInfo create_info{
+        .stage =
+            vk::PipelineShaderStageCreateInfo{
+                .stage  = vk::ShaderStageFlagBits::eCompute,
+                .module = t_shader.module(),
+                .pName  = t_shader.entry_point().c_str(),
+            },
+        .layout = t_layout,
+    };
+
+    return t_device.createComputePipelineUnique(t_pipeline_cache, create_info).value;
+}
+
+[[nodiscard]]
+static auto create_descriptor_pool(const vk::Device t_device) -> DescriptorPool
+{
+    return DescriptorPool::create()
+        .request_descriptor_sets(g_max_level_count + 1)
+        .request_descriptors(std::array{
+            vk::DescriptorPoolSize{
+                .type            = vk::DescriptorType::eCombinedImageSampler,
+                .descriptorCount = g_max_level_count + 1,
+            },
+            vk::DescriptorPoolSize{
+                .type            = vk::DescriptorType::eStorageImage,
+                .descriptorCount = g_max_level_count,
+            },
+            vk::DescriptorPoolSize{
+                .type            = vk::DescriptorType::eUniformBufferDynamic,
+                .descriptorCount = 1,
+            },
+        })
+        .build(t_device);
+}
+
+[[nodiscard]]
+static auto create_image_view(
+    const vk::Device t_device,
+    const vk::Image  t_image,
+    const uint32_t   t_base_mip_level,
+    const uint32_t   t_mip_level_count
+) -> vk::UniqueImageView
+{
+    return t_device.createImageViewUnique(vk::ImageViewCreateInfo{
+        .image    = t_image,
+        .viewType = vk::ImageViewType::e2D,
+        .format   = g_pyramid_format,
+        .subresourceRange =
+            vk::ImageSubresourceRange{
+                .aspectMask     = vk::ImageAspectFlagBits::eColor,
+                .baseMipLevel   = t_base_mip_level,
+                .levelCount     = t_mip_level_count,
+                .baseArrayLayer = 0,
+                .layerCount     = 1,
+            },
+    });
+}
+
+[[nodiscard]]
+static auto allocate_descriptor_set(
+    const vk::Device              t_device,
+    const vk::DescriptorPool      t_pool,
+    const vk::DescriptorSetLayout t_layout
+) -> vk::UniqueDescriptorSet
+{
+    auto descriptor_sets{ t_device.allocateDescriptorSetsUnique(
+        vk::DescriptorSetAllocateInfo{
+            .descriptorPool     = t_pool,
+            .descriptorSetCount = 1,
+            .pSetLayouts        = &t_layout,
+        }
+    ) };
+    return std::move(descriptor_sets.front());
+}
+
+static auto memory_barrier(
+    const vk::CommandBuffer      t_command_buffer,
+    const vk::PipelineStageFlags t_src_stage_mask,
+    const vk::AccessFlags        t_src_access_mask,
+    const vk::PipelineStageFlags t_dst_stage_mask,
+    const vk::AccessFlags        t_dst_access_mask
+) -> void
+{
+    t_command_buffer.pipelineBarrier(
+        t_src_stage_mask,
+        t_dst_stage_mask,
+        vk::DependencyFlags{},
+        vk::MemoryBarrier{
+            .srcAccessMask = t_src_access_mask,
+            .dstAccessMask = t_dst_access_mask,
+        },
+        nullptr,
+        nullptr
+    );
+}
+
+namespace core::renderer {
+
+auto OcclusionCuller::create(
+    const Device&                      t_device,
+    const Allocator&                   t_allocator,
+    const std::span<const RenderModel> t_models,
+    const Shader&                      t_depth_pyramid_shader,
+    const Shader&                      t_cull_shader,
+    const vk::PipelineCache            t_pipeline_cache,
+    const uint32_t                     t_frame_count
+) -> std::optional<OcclusionCuller>
+{
+    // The draw index has to reach the shaders through the instance index,
+    // as the culled commands are drawn without a push constant between them
+    if (!draw_indirect_count_enabled(t_device)
+        || !RenderModel::draw_features(t_device.physical_device())
+                .draw_indirect_first_instance)
+    {
+        return std::nullopt;
+    }
+
+    std::vector<ShaderCullDraw> draws;
+    std::vector<ModelRange>     model_ranges;
+    uint32_t                    group_count{};
+    for (const RenderModel& model : t_models) {
+        const ModelRange model_range{
+            .first_draw  = static_cast<uint32_t>(draws.size()),
+            .first_group = group_count,
+        };
+        model_ranges.push_back(model_range);
+
+        for (const RenderModel::DrawGroup& draw_group : model.draw_groups()) {
+            for (const uint32_t draw_index : std::views::iota(
+                     draw_group.first_draw, draw_group.first_draw + draw_group.draw_count
+                 ))
+            {
+                const graphics::Model::Bounds& bounds{
+                    model.draw_infos()[draw_index].bounds
+                };
+                draws.push_back(ShaderCullDraw{
+                    .center       = glm::vec4{ (bounds.min + bounds.max) / 2.f, 0 },
+                    .extent       = glm::vec4{ (bounds.max - bounds.min) / 2.f, 0 },
+                    .command      = model.draw_command_address(draw_index),
+                    .output_index = model_range.first_draw + draw_group.first_draw,
+                    .count_index  = group_count,
+                });
+            }
+            group_count++;
+        }
+    }
+    if (draws.empty()) {
+        return std::nullopt;
+    }
+    const auto draw_count{ static_cast<uint32_t>(draws.size()) };
+
+    const vk::Device device{ t_device.get() };
+
+    vk::UniqueSampler sampler{ create_sampler(device) };
+
+    const std::array pyramid_bindings{
+        vk::DescriptorSetLayoutBinding{
+            .binding         = 0,
+            .descriptorType  = vk::DescriptorType::eCombinedImageSampler,
+            .descriptorCount = 1,
+            .stageFlags      = vk::ShaderStageFlagBits::eCompute,
+        },
+        vk::DescriptorSetLayoutBinding{
+            .binding         = 1,
+            .descriptorType  = vk::DescriptorType::eStorageImage,
+            .descriptorCount = 1,
+            .stageFlags      = vk::ShaderStageFlagBits::eCompute,
+        },
+    };
+    const std::array cull_bindings{
+        vk::DescriptorSetLayoutBinding{
+            .binding         = 0,
+            .descriptorType  = vk::DescriptorType::eCombinedImageSampler,
+            .descriptorCount = 1,
+            .stageFlags      = vk::ShaderStageFlagBits::eCompute,
+        },
+        vk::DescriptorSetLayoutBinding{
+            .binding         = 1,
+            .descriptorType  = vk::DescriptorType::eUniformBufferDynamic,
+            .descriptorCount = 1,
+            .stageFlags      = vk::ShaderStageFlagBits::eCompute,
+        },
+    };
+    vk::UniqueDescriptorSetLayout pyramid_descriptor_set_layout{
+        create_descriptor_set_layout(device, pyramid_bindings)
+    };
+    vk::UniqueDescriptorSetLayout cull_descriptor_set_layout{
+        create_descriptor_set_layout(device, cull_bindings)
+    };
+
+    vk::UniquePipelineLayout pyramid_pipeline_layout{
+        create_pipeline_layout(device, pyramid_descriptor_set_layout.get(), 0)
+    };
+    vk::UniquePipelineLayout cull_pipeline_layout{ create_pipeline_layout(
+        device, cull_descriptor_set_layout.get(), sizeof(PushConstants)
+    ) };
+
+    vk::UniquePipeline pyramid_pipeline{ create_compute_pipeline(
+        device, t_pipeline_cache, pyramid_pipeline_layout.get(), t_depth_pyramid_shader
+    ) };
+    vk::UniquePipeline cull_pipeline{ create_compute_pipeline(
+        device, t_pipeline_cache, cull_pipeline_layout.get(), t_cull_shader
+    ) };
+
+    UniformRing camera_buffer{ t_allocator, sizeof(ShaderCullCamera), t_frame_count };
+
+    MappedBuffer draw_buffer{ t_allocator.allocate_mapped_buffer(
+        vk::BufferCreateInfo{
+            .size  = draws.size() * sizeof(ShaderCullDraw),
+            .usage = vk::BufferUsageFlagBits::eStorageBuffer
+                   | vk::BufferUsageFlagBits::eShaderDeviceAddress,
+        },
+        draws.data()
+    ) };
+
+    // One region for each phase, as the late one is culled
+    // while the draws of the early one may still read theirs
+    Buffer commands{ t_allocator.allocate_buffer(vk::BufferCreateInfo{
+        .size  = 2 * draw_count * g_command_stride,
+        .usage = vk::BufferUsageFlagBits::eStorageBuffer
+               | vk::BufferUsageFlagBits::eIndirectBuffer
+               | vk::BufferUsageFlagBits::eShaderDeviceAddress,
+    }) };
+    Buffer counts{ t_allocator.allocate_buffer(vk::BufferCreateInfo{
+        .size  = 2 * group_count * g_count_stride,
+        .usage = vk::BufferUsageFlagBits::eStorageBuffer
+               | vk::BufferUsageFlagBits::eIndirectBuffer
+               | vk::BufferUsageFlagBits::eTransferDst
+               | vk::BufferUsageFlagBits::eShaderDeviceAddress,
+    }) };
+    Buffer visibilities{ t_allocator.allocate_buffer(vk::BufferCreateInfo{
+        .size  = draw_count * sizeof(uint32_t),
+        .usage = vk::BufferUsageFlagBits::eStorageBuffer
+               | vk::BufferUsageFlagBits::eTransferDst
+               | vk::BufferUsageFlagBits::eShaderDeviceAddress,
+    }) };
+
+    return OcclusionCuller{
+        device,
+        t_allocator,
+        std::move(sampler),
+        std::move(pyramid_descriptor_set_layout),
+        std::move(cull_descriptor_set_layout),
+        std::move(pyramid_pipeline_layout),
+        std::move(cull_pipeline_layout),
+        std::move(pyramid_pipeline),
+        std::move(cull_pipeline),
+        std::move(camera_buffer),
+        std::move(draw_buffer),
+        std::move(commands),
+        std::move(counts),
+        std::move(visibilities),
+        draw_count,
+        group_count,
+        std::move(model_ranges),
+        create_descriptor_pool(device),
+    };
+}
+
+auto OcclusionCuller::set_depth_attachment(
+    const vk::ImageView t_depth_image_view,
+    const vk::Extent2D  t_extent
+) -> void
+{
+    m_cull_descriptor_set.reset();
+    m_level_descriptor_sets.clear();
+    m_level_views.clear();
+    m_depth_pyramid_view.reset();
+    m_depth_pyramid.reset();
+
+    const vk::Extent2D extent{ pyramid_extent(t_extent) };
+    const uint32_t     levels{ level_count(extent) };
+
+    m_depth_extent = t_extent;
+    m_depth_pyramid.emplace(m_allocator.get().allocate_image(
+        vk::ImageCreateInfo{
+            .imageType   = vk::ImageType::e2D,
+            .format      = g_pyramid_format,
+            .extent      = vk::Extent3D{ extent.width, extent.height, 1 },
+            .mipLevels   = levels,
+            .arrayLayers = 1,
+            .samples     = vk::SampleCountFlagBits::e1,
+            .tiling      = vk::ImageTiling::eOptimal,
+            .usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eStorage,
+            .sharingMode   = vk::SharingMode::eExclusive,
+            .initialLayout = vk::ImageLayout::eUndefined,
+        },
+        VmaAllocationCreateInfo{ .usage = VMA_MEMORY_USAGE_AUTO }
+    ));
+    m_depth_pyramid_view =
+        create_image_view(m_device, m_depth_pyramid->get(), 0, levels);
+
+    std::vector<vk::DescriptorImageInfo> source_infos;
+    std::vector<vk::DescriptorImageInfo> destination_infos;
+    source_infos.reserve(levels);
+    destination_infos.reserve(levels);
+    for (const uint32_t level : std::views::iota(0u, levels)) {
+        m_level_views.push_back(
+            create_image_view(m_device, m_depth_pyramid->get(), level, 1)
+        );
+        m_level_descriptor_sets.push_back(allocate_descriptor_set(
+            m_device, m_descriptor_pool.get(), m_pyramid_descriptor_set_layout.get()
+        ));
+
+        source_infos.push_back(
+            level == 0
+                ? vk::DescriptorImageInfo{ .sampler     = m_sampler.get(),
+                                           .imageView   = t_depth_image_view,
+                                           .imageLayout = vk::ImageLayout::
+                                               eShaderReadOnlyOptimal }
+                : vk::DescriptorImageInfo{ .sampler     = m_sampler.get(),
+                                           .imageView   = m_level_views[level - 1].get(),
+                                           .imageLayout = vk::ImageLayout::eGeneral }
+        );
+        destination_infos.push_back(vk::DescriptorImageInfo{
+            .imageView   = m_level_views[level].get(),
+            .imageLayout = vk::ImageLayout::eGeneral,
+        });
+    }
+
+    m_cull_descriptor_set = allocate_descriptor_set(
+        m_device, m_descriptor_pool.get(), m_cull_descriptor_set_layout.get()
+    );
+    const vk::DescriptorImageInfo pyramid_info{
+        .sampler     = m_sampler.get(),
+        .imageView   = m_depth_pyramid_view.get(),
+        .imageLayout = vk::ImageLayout::eGeneral,
+    };
+    const vk::DescriptorBufferInfo camera_info{
+        .buffer = m_camera_buffer.get(),
+        .range  = m_camera_buffer.slice_size(),
+    };
+
+    std::vector<vk::WriteDescriptorSet> writes;
+    for (const uint32_t level : std::views::iota(0u, levels)) {
+        writes.push_back(vk::WriteDescriptorSet{
+            .dstSet          = m_level_descriptor_sets[level].get(),
+            .dstBinding      = 0,
+            .descriptorCount = 1,
+            .descriptorType  = vk::DescriptorType::eCombinedImageSampler,
+            .pImageInfo      = &source_infos[level],
+        });
+        writes.push_back(vk::WriteDescriptorSet{
+            .dstSet          = m_level_descriptor_sets[level].get(),
+            .dstBinding      = 1,
+            .descriptorCount = 1,
+            .descriptorType  = vk::DescriptorType::eStorageImage,
+            .pImageInfo      = &destination_infos[level],
+        });
+    }
+    writes.push_back(vk::WriteDescriptorSet{
+        .dstSet          = m_cull_descriptor_set.get(),
+        .dstBinding      = 0,
+        .descriptorCount = 1,
+        .descriptorType  = vk::DescriptorType::eCombinedImageSampler,
+        .pImageInfo      = &pyramid_info,
+    });
+    writes.push_back(vk::WriteDescriptorSet{
+        .dstSet          = m_cull_descriptor_set.get(),
+        .dstBinding      = 1,
+        .descriptorCount = 1,
+        .descriptorType  = vk::DescriptorType::eUniformBufferDynamic,
+        .pBufferInfo     = &camera_info,
+    });
+
+    m_device.updateDescriptorSets(writes, nullptr);
+}
+
+auto OcclusionCuller::cull(
+    const vk::CommandBuffer t_command_buffer,
+    const graphics::Camera& t_camera,
+    const uint32_t          t_frame_index,
+    const Phase             t_phase
+) -> void
+{
+    m_camera_buffer.set(
+        t_frame_index,
+        ShaderCullCamera{
+            .view_projection = t_camera.projection() * t_camera.view(),
+            .frustum_planes  = t_camera.frustum_planes(),
+            .depth_extent    = glm::vec2{ static_cast<float>(m_depth_extent.width),
+                                          static_cast<float>(m_depth_extent.height) },
+        }
+    );
+    m_camera_buffer.flush();
+
+    const auto phase_index{ static_cast<uint32_t>(std::to_underlying(t_phase)) };
+
+    // Earlier draws and culls may still read and write the buffers
+    memory_barrier(
+        t_command_buffer,
+        vk::PipelineStageFlagBits::eDrawIndirect
+            | vk::PipelineStageFlagBits::eComputeShader,
+        vk::AccessFlagBits::eShaderWrite,
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::AccessFlagBits::eTransferWrite
+    );
+    // Nothing was visible before the first frame
+    if (!m_visibilities_cleared) {
+        t_command_buffer.fillBuffer(m_visibilities.get(), 0, vk::WholeSize, 0);
+        m_visibilities_cleared = true;
+    }
+    t_command_buffer.fillBuffer(
+        m_counts.get(),
+        phase_index * m_group_count * g_count_stride,
+        m_group_count * g_count_stride,
+        0
+    );
+    memory_barrier(
+        t_command_buffer,
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::AccessFlagBits::eTransferWrite,
+        vk::PipelineStageFlagBits::eComputeShader,
+        vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite
+    );
+
+    t_command_buffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_cull_pipeline.get());
+    t_command_buffer.bindDescriptorSets(
+        vk::PipelineBindPoint::eCompute,
+        m_cull_pipeline_layout.get(),
+        0,
+        m_cull_descriptor_set.get(),
+        m_camera_buffer.dynamic_offset(t_frame_index)
+    );
+    const PushConstants push_constants{
+        .draws    = buffer_address(m_device, m_draws.get()),
+        .commands = buffer_address(m_device, m_commands.get())
+                  + phase_index * m_draw_count * g_command_stride,
+        .counts = buffer_address(m_device, m_counts.get())
+                + phase_index * m_group_count * g_count_stride,
+        .visibilities = buffer_address(m_device, m_visibilities.get()),
+        .draw_count   = m_draw_count,
+        .phase        = phase_index,
+    };
+    t_command_buffer.pushConstants(
+        m_cull_pipeline_layout.get(),
+        vk::ShaderStageFlagBits::eCompute,
+        0,
+        sizeof(PushConstants),
+        &push_constants
+    );
+    t_command_buffer.dispatch(
+        (m_draw_count + g_cull_group_size - 1) / g_cull_group_size, 1, 1
+    );
+
+    memory_barrier(
+        t_command_buffer,
+        vk::PipelineStageFlagBits::eComputeShader,
+        vk::AccessFlagBits::eShaderWrite,
+        vk::PipelineStageFlagBits::eDrawIndirect
+            | vk::PipelineStageFlagBits::eComputeShader,
+        vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eShaderRead
+    );
+}
+
+auto OcclusionCuller::build_depth_pyramid(const vk::CommandBuffer t_command_buffer) const
+    -> void
+{
+    // The previous contents are not needed,
+    // but the late cull of the previous frame may still read them
+    const vk::MemoryBarrier depth_barrier{
+        .srcAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+        .dstAccessMask = vk::AccessFlagBits::eShaderRead,
+    };
+    const vk::ImageMemoryBarrier pyramid_barrier{
+        .srcAccessMask       = vk::AccessFlagBits::eNone,
+        .dstAccessMask       = vk::AccessFlagBits::eShaderWrite,
+        .oldLayout           = vk::ImageLayout::eUndefined,
+        .newLayout           = vk::ImageLayout::eGeneral,
+        .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+        .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+        .image               = m_depth_pyramid->get(),
+        .subresourceRange    = g_pyramid_range,
+    };
+    t_command_buffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eEarlyFragmentTests
+            | vk::PipelineStageFlagBits::eLateFragmentTests
+            | vk::PipelineStageFlagBits::eComputeShader,
+        vk::PipelineStageFlagBits::eComputeShader,
+        vk::DependencyFlags{},
+        depth_barrier,
+        nullptr,
+        pyramid_barrier
+    );
+
+    t_command_buffer.bindPipeline(
+        vk::PipelineBindPoint::eCompute, m_pyramid_pipeline.get()
+    );
+
+    vk::Extent2D extent{ pyramid_extent(m_depth_extent) };
+    for (const vk::UniqueDescriptorSet& descriptor_set : m_level_descriptor_sets) {
+        t_command_buffer.bindDescriptorSets(
+            vk::PipelineBindPoint::eCompute,
+            m_pyramid_pipeline_layout.get(),
+            0,
+            descriptor_set.get(),
+            nullptr
+        );
+        t_command_buffer.dispatch(
+            (extent.width + g_pyramid_group_size - 1) / g_pyramid_group_size,
+            (extent.height + g_pyramid_group_size - 1) / g_pyramid_group_size,
+            1
+        );
+
+        // The next level, or the late cull reads it
+        memory_barrier(
+            t_command_buffer,
+            vk::PipelineStageFlagBits::eComputeShader,
+            vk::AccessFlagBits::eShaderWrite,
+            vk::PipelineStageFlagBits::eComputeShader,
+            vk::AccessFlagBits::eShaderRead
+        );
+
+        extent = pyramid_extent(extent);
+    }
+}
+
+auto OcclusionCuller::draw(
+    const vk::CommandBuffer            t_graphics_command_buffer,
+    const vk::PipelineLayout           t_pipeline_layout,
+    const std::span<const RenderModel> t_models,
+    const Phase                        t_phase
+) const -> void
+{
+    const auto phase_index{ static_cast<uint32_t>(std::to_underlying(t_phase)) };
+
+    for (const auto& [model, model_range] : std::views::zip(t_models, m_model_ranges)) {
+        model.bind(t_graphics_command_buffer, t_pipeline_layout);
+
+        for (const auto& [draw_group, group_index] : std::views::zip(
+                 model.draw_groups(), std::views::iota(0u, model.draw_groups().size())
+             ))
+        {
+            const vk::Pipeline pipeline{ draw_group.pipeline->get() };
+            if (!pipeline) {
+                continue;
+            }
+
+            const vk::DeviceSize first_command{ phase_index * m_draw_count
+                                                + model_range.first_draw
+                                                + draw_group.first_draw };
+            const vk::DeviceSize count_index{ phase_index * m_group_count
+                                              + model_range.first_group + group_index };
+
+            t_graphics_command_buffer.bindPipeline(
+                vk::PipelineBindPoint::eGraphics, pipeline
+            );
+            model.set_draw_state(t_graphics_command_buffer, draw_group.state);
+            t_graphics_command_buffer.drawIndexedIndirectCountKHR(
+                m_commands.get(),
+                first_command * g_command_stride,
+                m_counts.get(),
+                count_index * g_count_stride,
+                draw_group.draw_count,
+                g_command_stride
+            );
+        }
+    }
+}
+
+OcclusionCuller::OcclusionCuller(
+    const vk::Device                t_device,
+    const Allocator&                t_allocator,
+    vk::UniqueSampler&&             t_sampler,
+    vk::UniqueDescriptorSetLayout&& t_pyramid_descriptor_set_layout,
+    vk::UniqueDescriptorSetLayout&& t_cull_descriptor_set_layout,
+    vk::UniquePipelineLayout&&      t_pyramid_pipeline_layout,
+    vk::UniquePipelineLayout&&      t_cull_pipeline_layout,
+    vk::UniquePipeline&&            t_pyramid_pipeline,
+    vk::UniquePipeline&&            t_cull_pipeline,
+    UniformRing&&                   t_camera_buffer,
+    MappedBuffer&&                  t_draws,
+    Buffer&&                        t_commands,
+    Buffer&&                        t_counts,
+    Buffer&&                        t_visibilities,
+    const uint32_t                  t_draw_count,
+    const uint32_t                  t_group_count,
+    std::vector<ModelRange>&&       t_model_ranges,
+    DescriptorPool&&                t_descriptor_pool
+) noexcept
+    : m_device{ t_device },
+      m_allocator{ t_allocator },
+      m_sampler{ std::move(t_sampler) },
+      m_pyramid_descriptor_set_layout{ std::move(t_pyramid_descriptor_set_layout) },
+      m_cull_descriptor_set_layout{ std::move(t_cull_descriptor_set_layout) },
+      m_pyramid_pipeline_layout{ std::move(t_pyramid_pipeline_layout) },
+      m_cull_pipeline_layout{ std::move(t_cull_pipeline_layout) },
+      m_pyramid_pipeline{ std::move(t_pyramid_pipeline) },
+      m_cull_pipeline{ std::move(t_cull_pipeline) },
+      m_camera_buffer{ std::move(t_camera_buffer) },
+      m_draws{ std::move(t_draws) },
+      m_commands{ std::move(t_commands) },
+      m_counts{ std::move(t_counts) },
+      m_visibilities{ std::move(t_visibilities) },
+      m_draw_count{ t_draw_count },
+      m_group_count{ t_group_count },
+      m_model_ranges{ std::move(t_model_ranges) },
+      m_descriptor_pool{ std::move(t_descriptor_pool) }
+{}
+
+}   // namespace core::renderer
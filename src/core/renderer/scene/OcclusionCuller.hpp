@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "core/graphics/camera/Camera.hpp"
+#include "core/renderer/base/allocator/Allocator.hpp"
+#include "core/renderer/base/descriptor_pool/DescriptorPool.hpp"
+#include "core/renderer/material_system/Shader.hpp"
+#include "core/renderer/memory/UniformRing.hpp"
+#include "core/renderer/model/RenderModel.hpp"
+
+namespace core::renderer {
+
+class Device;
+
+// Culls the draws of a scene on the GPU, against the frustum and a depth pyramid,
+// and compacts the survivors into indirect buffers drawn with a GPU-side count.
+// A frame runs in two phases, so that objects coming out from behind others
+// do not pop in a frame late:
+//  1. cull(eEarly), then draw what was visible in the previous frame,
+//  2. build_depth_pyramid() from the depth written by those draws,
+//  3. cull(eLate), then draw what became visible, keeping the depth of step 1.
+// Scene::draw takes the culler to record the draws of a phase.
+class OcclusionCuller {
+public:
+    ///------------------///
+    ///  Nested classes  ///
+    ///------------------///
+    enum class Phase : uint8_t {
+        eEarly,
+        eLate,
+    };
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    // Null without VK_KHR_draw_indirect_count and drawIndirectFirstInstance,
+    // or if the models have nothing to draw. The models have to outlive the culler.
+    [[nodiscard]]
+    static auto create(
+        const Device&                t_device,
+        const Allocator&             t_allocator,
+        std::span<const RenderModel> t_models,
+        const Shader&                t_depth_pyramid_shader,
+        const Shader&                t_cull_shader,
+        vk::PipelineCache            t_pipeline_cache,
+        uint32_t                     t_frame_count
+    ) -> std::optional<OcclusionCuller>;
+
+    // Call it before the first cull, and again when the attachment is recreated.
+    // The image has to be sampleable, and be in eShaderReadOnlyOptimal layout
+    // when the pyramid is built. The GPU must be done with the previous pyramid.
+    auto set_depth_attachment(vk::ImageView t_depth_image_view, vk::Extent2D t_extent)
+        -> void;
+
+    // Outside of render passes
+    auto cull(
+        vk::CommandBuffer       t_command_buffer,
+        const graphics::Camera& t_camera,
+        uint32_t                t_frame_index,
+        Phase                   t_phase
+    ) -> void;
+    auto build_depth_pyramid(vk::CommandBuffer t_command_buffer) const -> void;
+
+    // The models are the ones given to create()
+    auto draw(
+        vk::CommandBuffer            t_graphics_command_buffer,
+        vk::PipelineLayout           t_pipeline_layout,
+        std::span<const RenderModel> t_models,
+        Phase                        t_phase
+    ) const -> void;
+
+private:
+    ///******************///
+    ///  Nested classes  ///
+    ///******************///
+    // Where the draws of a model start in the culled buffers
+    struct ModelRange {
+        uint32_t first_draw;
+        uint32_t first_group;
+    };
+
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    vk::Device                              m_device;
+    std::reference_wrapper<const Allocator> m_allocator;
+
+    vk::UniqueSampler             m_sampler;
+    vk::UniqueDescriptorSetLayout m_pyramid_descriptor_set_layout;
+    vk::UniqueDescriptorSetLayout m_cull_descriptor_set_layout;
+    vk::UniquePipelineLayout      m_pyramid_pipeline_layout;
+    vk::UniquePipelineLayout      m_cull_pipeline_layout;
+    vk::UniquePipeline            m_pyramid_pipeline;
+    vk::UniquePipeline            m_cull_pipeline;
+
+    UniformRing             m_camera_buffer;
+    // Bounds and source commands, written once
+    MappedBuffer            m_draws;
+    // A command and a count for every draw and group of each phase
+    Buffer                  m_commands;
+    Buffer                  m_counts;
+    // Whether each draw passed the late phase of the previous frame
+    Buffer                  m_visibilities;
+    bool                    m_visibilities_cleared{};
+    uint32_t                m_draw_count;
+    uint32_t                m_group_count;
+    std::vector<ModelRange> m_model_ranges;
+
+    // Recreated with the depth attachment
+    vk::Extent2D                         m_depth_extent;
+    std::optional<Image>                 m_depth_pyramid;
+    vk::UniqueImageView                  m_depth_pyramid_view;
+    std::vector<vk::UniqueImageView>     m_level_views;
+    DescriptorPool                       m_descriptor_pool;
+    std::vector<vk::UniqueDescriptorSet> m_level_descriptor_sets;
+    vk::UniqueDescriptorSet              m_cull_descriptor_set;
+
+    ///******************************///
+    ///  Constructors / Destructors  ///
+    ///******************************///
+    explicit OcclusionCuller(
+        vk::Device                      t_device,
+        const Allocator&                t_allocator,
+        vk::UniqueSampler&&             t_sampler,
+        vk::UniqueDescriptorSetLayout&& t_pyramid_descriptor_set_layout,
+        vk::UniqueDescriptorSetLayout&& t_cull_descriptor_set_layout,
+        vk::UniquePipelineLayout&&      t_pyramid_pipeline_layout,
+        vk::UniquePipelineLayout&&      t_cull_pipeline_layout,
+        vk::UniquePipeline&&            t_pyramid_pipeline,
+        vk::UniquePipeline&&            t_cull_pipeline,
+        UniformRing&&                   t_camera_buffer,
+        MappedBuffer&&                  t_draws,
+        Buffer&&                        t_commands,
+        Buffer&&                        t_counts,
+        Buffer&&                        t_visibilities,
+        uint32_t                        t_draw_count,
+        uint32_t                        t_group_count,
+        std::vector<ModelRange>&&       t_model_ranges,
+        DescriptorPool&&                t_descriptor_pool
+    ) noexcept;
+};
+
+}   // namespace core::renderer
@@ -0,0 +1,181 @@
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <functional>
+#include <utility>
+
+#include <vulkan/vulkan_hash.hpp>
+
+#include "core/utility/tasks.hpp"
+
+using Packet = core::renderer::RenderQueue::Packet;
+using Pass   = core::renderer::RenderQueue::Pass;
+
+constexpr static uint32_t g_radix_bits{ 8 };
+constexpr static uint32_t g_bucket_count{ 1u << g_radix_bits };
+constexpr static uint32_t g_pass_count{ 64 / g_radix_bits };
+// Smaller chunks cost more in scheduling than they save
+constexpr static size_t   g_min_packets_per_task{ 4096 };
+
+constexpr static uint32_t g_depth_bits{ 24 };
+constexpr static uint32_t g_pipeline_bits{ 22 };
+constexpr static uint32_t g_material_bits{ core::renderer::RenderQueue::s_material_bits };
+constexpr static uint32_t g_pass_shift{ 62 };
+
+using Histogram = std::array<size_t, g_bucket_count>;
+
+[[nodiscard]]
+constexpr static auto mask(const uint32_t t_bits) noexcept -> uint64_t
+{
+    return (uint64_t{ 1 } << t_bits) - 1;
+}
+
+[[nodiscard]]
+constexpr static auto depth_key(const float t_depth) noexcept -> uint64_t
+{
+    // The bits of non-negative floats sort like the values
+    return std::bit_cast<uint32_t>(std::max(t_depth, 0.f)) >> (32 - g_depth_bits);
+}
+
+[[nodiscard]]
+static auto pipeline_key(const vk::Pipeline t_pipeline) noexcept -> uint64_t
+{
+    const uint64_t hash{ std::hash<vk::Pipeline>{}(t_pipeline) };
+    return (hash ^ (hash >> g_pipeline_bits) ^ (hash >> (2 * g_pipeline_bits)))
+         & mask(g_pipeline_bits);
+}
+
+[[nodiscard]]
+constexpr static auto compose_key(
+    const Pass     t_pass,
+    const uint64_t t_pipeline_key,
+    const uint32_t t_material,
+    const float    t_depth
+) noexcept -> uint64_t
+{
+    const uint64_t pass{ uint64_t{ std::to_underlying(t_pass) } << g_pass_shift };
+    const uint64_t material{ t_material & mask(g_material_bits) };
+    const uint64_t depth{ depth_key(t_depth) };
+
+    if (t_pass == Pass::eBlend) {
+        return pass | (mask(g_depth_bits) - depth) << (g_pipeline_bits + g_material_bits)
+             | t_pipeline_key << g_material_bits | material;
+    }
+    return pass | t_pipeline_key << (g_material_bits + g_depth_bits)
+         | material << g_depth_bits | depth;
+}
+
+// Nearer draws come first when opaque, last when blended
+static_assert(
+    compose_key(Pass::eOpaque, 0, 0, 1.f) < compose_key(Pass::eOpaque, 0, 0, 2.f)
+);
+static_assert(
+    compose_key(Pass::eBlend, 0, 0, 1.f) > compose_key(Pass::eBlend, 0, 0, 2.f)
+);
+
+[[nodiscard]]
+static auto bucket(const Packet& t_packet, const uint32_t t_shift) noexcept -> size_t
+{
+    return (t_packet.key >> t_shift) & mask(g_radix_bits);
+}
+
+// Stable, so packets with equal keys keep the order they were pushed in
+static auto radix_sort(
+    std::vector<Packet>&     t_packets,
+    std::vector<Packet>&     t_scratch,
+    core::utils::ThreadPool& t_thread_pool
+) -> void
+{
+    const size_t packet_count{ t_packets.size() };
+    t_scratch.resize(packet_count);
+
+    const size_t task_count{
+        core::utils::task_count(packet_count, g_min_packets_per_task)
+    };
+    const size_t chunk_size{ (packet_count + task_count - 1) / task_count };
+    const auto   chunk{ [&](const std::span<Packet> packets, const size_t task_index) {
+        const size_t begin{ std::min(task_index * chunk_size, packet_count) };
+        const size_t end{ std::min(begin + chunk_size, packet_count) };
+        return packets.subspan(begin, end - begin);
+    } };
+
+    std::vector<Histogram> histograms(task_count);
+    std::span<Packet>      source{ t_packets };
+    std::span<Packet>      destination{ t_scratch };
+
+    for (uint32_t pass{}; pass < g_pass_count; pass++) {
+        const uint32_t shift{ pass * g_radix_bits };
+
+        core::utils::run_tasks(t_thread_pool, task_count, [&](const size_t task_index) {
+            Histogram& histogram{ histograms[task_index] };
+            histogram.fill(0);
+            for (const Packet& packet : chunk(source, task_index)) {
+                ++histogram[bucket(packet, shift)];
+            }
+        });
+
+        // Each task scatters its packets of a bucket after those of the earlier tasks
+        size_t offset{};
+        bool   same_digit{};
+        for (size_t bucket_index{}; bucket_index < g_bucket_count; bucket_index++) {
+            const size_t bucket_begin{ offset };
+            for (Histogram& histogram : histograms) {
+                const size_t count{ std::exchange(histogram[bucket_index], offset) };
+                offset += count;
+            }
+            same_digit |= offset - bucket_begin == packet_count;
+        }
+        // The pass would not move anything
+        if (same_digit) {
+            continue;
+        }
+
+        core::utils::run_tasks(t_thread_pool, task_count, [&](const size_t task_index) {
+            Histogram& offsets{ histograms[task_index] };
+            for (const Packet& packet : chunk(source, task_index)) {
+                destination[offsets[bucket(packet, shift)]++] = packet;
+            }
+        });
+        std::swap(source, destination);
+    }
+
+    if (source.data() != t_packets.data()) {
+        std::ranges::copy(source, t_packets.begin());
+    }
+}
+
+namespace core::renderer {
+
+auto RenderQueue::make_key(
+    const Pass         t_pass,
+    const vk::Pipeline t_pipeline,
+    const uint32_t     t_material,
+    const float        t_depth
+) noexcept -> uint64_t
+{
+    return compose_key(t_pass, pipeline_key(t_pipeline), t_material, t_depth);
+}
+
+auto RenderQueue::clear() noexcept -> void
+{
+    m_packets.clear();
+}
+
+auto RenderQueue::push(const Packet& t_packet) -> void
+{
+    m_packets.push_back(t_packet);
+}
+
+auto RenderQueue::sort(utils::ThreadPool& t_thread_pool) -> void
+{
+    radix_sort(m_packets, m_scratch, t_thread_pool);
+}
+
+auto RenderQueue::packets() const noexcept -> std::span<const Packet>
+{
+    return m_packets;
+}
+
+}   // namespace core::renderer
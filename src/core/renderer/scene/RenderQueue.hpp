@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "core/utility/ThreadPool.hpp"
+
+namespace core::renderer {
+
+// The draws of a frame, ordered by 64-bit sort keys with a parallel LSD radix sort.
+// Opaque draws come first, grouped by pipeline and material, then front to back.
+// Blended draws come last, back to front.
+class RenderQueue {
+public:
+    // Width of the material field of the keys
+    constexpr static uint32_t s_material_bits{ 16 };
+
+    ///------------------///
+    ///  Nested classes  ///
+    ///------------------///
+    // In the order of emission
+    enum class Pass : uint8_t {
+        eOpaque,
+        eMask,
+        eBlend,
+    };
+
+    struct Packet {
+        uint64_t     key;
+        vk::Pipeline pipeline;
+        uint32_t     model_index;
+        uint32_t     draw_index;
+    };
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    // Depth is the view space distance, negative values count as zero.
+    // Pipelines and materials only get a few bits of the key,
+    // so different ones may share bits and end up interleaved.
+    [[nodiscard]]
+    static auto make_key(
+        Pass         t_pass,
+        vk::Pipeline t_pipeline,
+        uint32_t     t_material,
+        float        t_depth
+    ) noexcept -> uint64_t;
+
+    auto clear() noexcept -> void;
+    auto push(const Packet& t_packet) -> void;
+    // Large queues are split across the thread pool
+    auto sort(utils::ThreadPool& t_thread_pool) -> void;
+
+    [[nodiscard]]
+    auto packets() const noexcept -> std::span<const Packet>;
+
+private:
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    std::vector<Packet> m_packets;
+    // Kept between frames, like the packets, to reuse the allocation
+    std::vector<Packet> m_scratch;
+};
+
+}   // namespace core::renderer
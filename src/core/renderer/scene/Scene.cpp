@@ -1,9 +1,49 @@
 #include "Scene.hpp"
 
+#include <algorithm>
+#include <optional>
+#include <ranges>
+
 #include "core/renderer/base/descriptor_pool/Builder.hpp"
 
 #include "Builder.hpp"
 
+using namespace core;
+using namespace core::renderer;
+
+[[nodiscard]]
+static auto pass(const graphics::Model::Material::AlphaMode t_alpha_mode) noexcept
+    -> RenderQueue::Pass
+{
+    using enum graphics::Model::Material::AlphaMode;
+    switch (t_alpha_mode) {
+        case eOpaque: return RenderQueue::Pass::eOpaque;
+        case eMask: return RenderQueue::Pass::eMask;
+        case eBlend: return RenderQueue::Pass::eBlend;
+    }
+}
+
+// The material field of the keys is split between the two indices.
+// Past 64 models or 1024 materials in a model, the indices alias: the draws
+// of the aliased ones may interleave, costing extra binds, but still draw right.
+constexpr static uint32_t g_model_key_bits{ 6 };
+constexpr static uint32_t g_material_index_key_bits{ 10 };
+static_assert(
+    g_model_key_bits + g_material_index_key_bits == RenderQueue::s_material_bits
+);
+
+// Materials are indexed per model, the low bits of the model index keep
+// the draws of one model together, so that they can merge into multi-draws
+[[nodiscard]]
+static auto material_key(const uint32_t t_model_index, const uint32_t t_material_index)
+    -> uint32_t
+{
+    constexpr uint32_t model_mask{ (1u << g_model_key_bits) - 1 };
+    constexpr uint32_t material_mask{ (1u << g_material_index_key_bits) - 1 };
+    return (t_model_index & model_mask) << g_material_index_key_bits
+         | (t_material_index & material_mask);
+}
+
 namespace core::renderer {
 
 auto Scene::create() noexcept -> Builder
@@ -13,43 +53,271 @@ auto Scene::create() noexcept -> Builder
 
 auto Scene::draw(
     vk::CommandBuffer       t_graphics_command_buffer,
-    const graphics::Camera& t_camera
-) const -> void
+    const graphics::Camera& t_camera,
+    const uint32_t          t_frame_index
+) -> void
+{
+    prepare_frame(t_camera, t_frame_index);
+
+    bind_global_descriptor_set(t_graphics_command_buffer, t_frame_index);
+    submit_draws(t_graphics_command_buffer, m_render_queue.packets());
+}
+
+auto Scene::draw(
+    const vk::CommandBuffer                 t_primary_command_buffer,
+    ParallelRecorder&                       t_recorder,
+    const vk::CommandBufferInheritanceInfo& t_inheritance_info,
+    const vk::Viewport&                     t_viewport,
+    const vk::Rect2D&                       t_scissor,
+    const graphics::Camera&                 t_camera,
+    const uint32_t                          t_frame_index
+) -> void
+{
+    prepare_frame(t_camera, t_frame_index);
+
+    const std::span<const RenderQueue::Packet> packets{ m_render_queue.packets() };
+    const size_t                               chunk_size{
+        (packets.size() + t_recorder.thread_count() - 1) / t_recorder.thread_count()
+    };
+
+    const std::vector<vk::CommandBuffer> command_buffers{ t_recorder.record(
+        t_frame_index,
+        t_inheritance_info,
+        [&](const vk::CommandBuffer command_buffer, const uint32_t thread_index) {
+            // Secondary command buffers inherit no state but the render pass
+            command_buffer.setViewport(0, t_viewport);
+            command_buffer.setScissor(0, t_scissor);
+            bind_global_descriptor_set(command_buffer, t_frame_index);
+
+            const size_t first{ std::min(thread_index * chunk_size, packets.size()) };
+            submit_draws(
+                command_buffer,
+                packets.subspan(first, std::min(chunk_size, packets.size() - first))
+            );
+        }
+    ) };
+    t_primary_command_buffer.executeCommands(command_buffers);
+}
+
+auto Scene::draw(
+    const vk::CommandBuffer      t_graphics_command_buffer,
+    const OcclusionCuller&       t_culler,
+    const OcclusionCuller::Phase t_phase,
+    const graphics::Camera&      t_camera,
+    const uint32_t               t_frame_index
+) -> void
 {
-    m_global_buffer.set(ShaderScene{
+    update_global_buffer(t_camera, t_frame_index);
+
+    bind_global_descriptor_set(t_graphics_command_buffer, t_frame_index);
+    t_culler.draw(t_graphics_command_buffer, m_pipeline_layout.get(), m_models, t_phase);
+}
+
+auto Scene::uploaded_resources() const -> UploadedResources
+{
+    UploadedResources result{ .buffers = m_buffer_arena.buffers() };
+    for (const RenderModel& model : m_models) {
+        UploadedResources model_resources{ model.uploaded_resources() };
+        result.images.append_range(model_resources.images);
+    }
+    return result;
+}
+
+auto Scene::stream_images(
+    const vk::Device        t_device,
+    const Allocator&        t_allocator,
+    const vk::CommandBuffer t_transfer_command_buffer,
+    const uint32_t          t_frame_index
+) -> void
+{
+    for (auto& model : m_models) {
+        model.stream_images(
+            t_device, t_allocator, t_transfer_command_buffer, t_frame_index
+        );
+    }
+}
+
+auto Scene::relocate(
+    const vk::Device                 t_device,
+    const Defragmenter::Relocations& t_relocations,
+    const uint32_t                   t_frame_index
+) -> void
+{
+    for (auto& model : m_models) {
+        model.relocate(t_device, t_relocations, t_frame_index);
+    }
+}
+
+auto Scene::image_pool() const noexcept -> const ImagePool&
+{
+    return m_image_pool;
+}
+
+auto Scene::models() const noexcept -> std::span<const RenderModel>
+{
+    return m_models;
+}
+
+auto Scene::prepare_frame(const graphics::Camera& t_camera, const uint32_t t_frame_index)
+    -> void
+{
+    update_global_buffer(t_camera, t_frame_index);
+
+    enqueue_draws(t_camera);
+    m_render_queue.sort(*m_thread_pool);
+}
+
+auto Scene::update_global_buffer(
+    const graphics::Camera& t_camera,
+    const uint32_t          t_frame_index
+) -> void
+{
+    const ShaderScene shader_scene{
         .camera = ShaderScene::Camera{ .position   = glm::vec4{ t_camera.position(), 1 },
                                       .view       = t_camera.view(),
                                       .projection = t_camera.projection() },
-    });
+        .models = m_model_table_address,
+    };
+    m_global_buffer.set(t_frame_index, shader_scene);
+    m_global_buffer.flush();
+}
+
+auto Scene::enqueue_draws(const graphics::Camera& t_camera) -> void
+{
+    m_render_queue.clear();
+
+    const std::span<const uint8_t> visibility{
+        m_frustum_culler.cull(t_camera.frustum_planes(), *m_thread_pool)
+    };
+    size_t box_index{};
+
+    for (const auto& [model, model_index] :
+         std::views::zip(m_models, std::views::iota(0u, m_models.size())))
+    {
+        for (const auto& [draw_info, draw_index] : std::views::zip(
+                 model.draw_infos(), std::views::iota(0u, model.draw_infos().size())
+             ))
+        {
+            if (visibility[box_index++] == 0) {
+                continue;
+            }
+            // Still compiling, without a fallback
+            const vk::Pipeline pipeline{ draw_info.pipeline->get() };
+            if (!pipeline) {
+                continue;
+            }
+
+            // The view space is right-handed, the camera looks down -z
+            const float depth{
+                -(t_camera.view() * glm::vec4{ draw_info.position, 1 }).z
+            };
+            m_render_queue.push(RenderQueue::Packet{
+                .key = RenderQueue::make_key(
+                    pass(draw_info.alpha_mode),
+                    pipeline,
+                    material_key(model_index, draw_info.material_index),
+                    depth
+                ),
+                .pipeline    = pipeline,
+                .model_index = model_index,
+                .draw_index  = draw_index,
+            });
+        }
+    }
+}
+
+auto Scene::bind_global_descriptor_set(
+    const vk::CommandBuffer t_graphics_command_buffer,
+    const uint32_t          t_frame_index
+) const -> void
+{
     t_graphics_command_buffer.bindDescriptorSets(
         vk::PipelineBindPoint::eGraphics,
         m_pipeline_layout.get(),
         0,
-        m_global_descriptor_set.get(),
-        nullptr
+        m_global_descriptor_sets[t_frame_index].get(),
+        m_global_buffer.dynamic_offset(t_frame_index)
     );
+}
+
+auto Scene::submit_draws(
+    const vk::CommandBuffer                    t_graphics_command_buffer,
+    const std::span<const RenderQueue::Packet> t_packets
+) const -> void
+{
+    vk::Pipeline                          bound_pipeline;
+    std::optional<uint32_t>               bound_model_index;
+    std::optional<RenderModel::DrawState> bound_draw_state;
+    for (size_t first{}; first < t_packets.size();) {
+        const RenderQueue::Packet&    packet{ t_packets[first] };
+        const RenderModel&            model{ m_models[packet.model_index] };
+        const RenderModel::DrawState& draw_state{
+            model.draw_infos()[packet.draw_index].state
+        };
+
+        // Consecutive draws of a model with the same pipeline and state go in one call
+        uint32_t draw_count{ 1 };
+        for (const RenderQueue::Packet& next : t_packets.subspan(first + 1)) {
+            if (next.model_index != packet.model_index || next.pipeline != packet.pipeline
+                || next.draw_index != packet.draw_index + draw_count
+                || model.draw_infos()[next.draw_index].state != draw_state)
+            {
+                break;
+            }
+            ++draw_count;
+        }
+
+        if (packet.pipeline != bound_pipeline) {
+            t_graphics_command_buffer.bindPipeline(
+                vk::PipelineBindPoint::eGraphics, packet.pipeline
+            );
+            bound_pipeline = packet.pipeline;
+            bound_draw_state.reset();
+        }
+        if (bound_draw_state != draw_state) {
+            model.set_draw_state(t_graphics_command_buffer, draw_state);
+            bound_draw_state = draw_state;
+        }
+
+        if (bound_model_index != packet.model_index) {
+            model.bind(t_graphics_command_buffer, m_pipeline_layout.get());
+            bound_model_index = packet.model_index;
+        }
 
-    for (const auto& model : m_models) {
-        model.draw(t_graphics_command_buffer, m_pipeline_layout.get());
+        model.draw_range(
+            t_graphics_command_buffer,
+            m_pipeline_layout.get(),
+            packet.draw_index,
+            draw_count
+        );
+        first += draw_count;
     }
 }
 
 Scene::Scene(
-    vk::UniqueDescriptorSetLayout&&                t_global_descriptor_set_layout,
-    std::array<vk::UniqueDescriptorSetLayout, 3>&& t_model_descriptor_set_layouts,
-    vk::UniquePipelineLayout&&                     t_pipeline_layout,
-    DescriptorPool&&                               t_descriptor_pool,
-    MappedBuffer&&                                 t_global_buffer,
-    vk::UniqueDescriptorSet&&                      t_global_descriptor_set,
-    std::vector<RenderModel>&&                     t_models
+    vk::UniqueDescriptorSetLayout&&        t_global_descriptor_set_layout,
+    vk::UniquePipelineLayout&&             t_pipeline_layout,
+    DescriptorPool&&                       t_descriptor_pool,
+    UniformRing&&                          t_global_buffer,
+    std::vector<vk::UniqueDescriptorSet>&& t_global_descriptor_sets,
+    BufferArena&&                          t_buffer_arena,
+    ImagePool&&                            t_image_pool,
+    const vk::DeviceAddress                t_model_table_address,
+    std::vector<RenderModel>&&             t_models,
+    FrustumCuller&&                        t_frustum_culler,
+    std::unique_ptr<utils::ThreadPool>&&   t_thread_pool
 ) noexcept
     : m_global_descriptor_set_layout(std::move(t_global_descriptor_set_layout)),
-      m_model_descriptor_set_layouts(std::move(t_model_descriptor_set_layouts)),
       m_pipeline_layout{ std::move(t_pipeline_layout) },
       m_descriptor_pool{ std::move(t_descriptor_pool) },
       m_global_buffer{ std::move(t_global_buffer) },
-      m_global_descriptor_set{ std::move(t_global_descriptor_set) },
-      m_models(std::move(t_models))
+      m_global_descriptor_sets{ std::move(t_global_descriptor_sets) },
+      m_buffer_arena{ std::move(t_buffer_arena) },
+      m_image_pool{ std::move(t_image_pool) },
+      m_model_table_address{ t_model_table_address },
+      m_models(std::move(t_models)),
+      m_frustum_culler{ std::move(t_frustum_culler) },
+      m_thread_pool{ std::move(t_thread_pool) }
 {}
 
 }   // namespace core::renderer
@@ -6,7 +6,16 @@
 #include "core/graphics/camera/Camera.hpp"
 #include "core/graphics/model/Model.hpp"
 #include "core/renderer/base/descriptor_pool/DescriptorPool.hpp"
+#include "core/renderer/frame/ParallelRecorder.hpp"
+#include "core/renderer/memory/BufferArena.hpp"
+#include "core/renderer/memory/ImagePool.hpp"
+#include "core/renderer/memory/UniformRing.hpp"
 #include "core/renderer/model/RenderModel.hpp"
+#include "core/utility/ThreadPool.hpp"
+
+#include "FrustumCuller.hpp"
+#include "OcclusionCuller.hpp"
+#include "RenderQueue.hpp"
 
 namespace core::renderer {
 
@@ -17,10 +26,60 @@ public:
     [[nodiscard]]
     static auto create() noexcept -> Builder;
 
+    // The GPU must be done with the previous frame using the same frame index.
+    // Draws go through the render queue, so pipelines are bound once per run.
     auto draw(
         vk::CommandBuffer       t_graphics_command_buffer,
-        const graphics::Camera& t_camera
-    ) const -> void;
+        const graphics::Camera& t_camera,
+        uint32_t                t_frame_index
+    ) -> void;
+    // Splits the draws across the recorder's threads, then executes the secondary
+    // command buffers in order. The primary one has to be inside the render pass of
+    // the inheritance info, begun with eSecondaryCommandBuffers contents.
+    // Reset the recorder for the frame index before the first call of a frame.
+    auto draw(
+        vk::CommandBuffer                       t_primary_command_buffer,
+        ParallelRecorder&                       t_recorder,
+        const vk::CommandBufferInheritanceInfo& t_inheritance_info,
+        const vk::Viewport&                     t_viewport,
+        const vk::Rect2D&                       t_scissor,
+        const graphics::Camera&                 t_camera,
+        uint32_t                                t_frame_index
+    ) -> void;
+    // Draws what the culler let through in the given phase, see OcclusionCuller.
+    // The culler has to be created from models().
+    auto draw(
+        vk::CommandBuffer       t_graphics_command_buffer,
+        const OcclusionCuller&  t_culler,
+        OcclusionCuller::Phase  t_phase,
+        const graphics::Camera& t_camera,
+        uint32_t                t_frame_index
+    ) -> void;
+
+    [[nodiscard]]
+    auto uploaded_resources() const -> UploadedResources;
+
+    // See RenderModel::stream_images()
+    auto stream_images(
+        vk::Device        t_device,
+        const Allocator&  t_allocator,
+        vk::CommandBuffer t_transfer_command_buffer,
+        uint32_t          t_frame_index
+    ) -> void;
+
+    // See RenderModel::relocate()
+    auto relocate(
+        vk::Device                       t_device,
+        const Defragmenter::Relocations& t_relocations,
+        uint32_t                         t_frame_index
+    ) -> void;
+
+    // Holds the textures of every model, give it to a Defragmenter to compact them
+    [[nodiscard]]
+    auto image_pool() const noexcept -> const ImagePool&;
+
+    [[nodiscard]]
+    auto models() const noexcept -> std::span<const RenderModel>;
 
 private:
     struct ShaderScene {
@@ -30,29 +89,61 @@ private:
             glm::mat4 projection;
         };
 
-        Camera camera;
+        Camera            camera;
+        vk::DeviceAddress models;
     };
 
     friend Builder;
 
-    vk::UniqueDescriptorSetLayout                m_global_descriptor_set_layout;
-    std::array<vk::UniqueDescriptorSetLayout, 3> m_model_descriptor_set_layouts;
-    vk::UniquePipelineLayout                     m_pipeline_layout;
-    DescriptorPool                               m_descriptor_pool;
+    // Updates the uniforms of the frame and fills the render queue
+    auto prepare_frame(const graphics::Camera& t_camera, uint32_t t_frame_index) -> void;
+    auto update_global_buffer(const graphics::Camera& t_camera, uint32_t t_frame_index)
+        -> void;
+    auto enqueue_draws(const graphics::Camera& t_camera) -> void;
+    auto bind_global_descriptor_set(
+        vk::CommandBuffer t_graphics_command_buffer,
+        uint32_t          t_frame_index
+    ) const -> void;
+    auto submit_draws(
+        vk::CommandBuffer                    t_graphics_command_buffer,
+        std::span<const RenderQueue::Packet> t_packets
+    ) const -> void;
+
+    vk::UniqueDescriptorSetLayout m_global_descriptor_set_layout;
+    vk::UniquePipelineLayout      m_pipeline_layout;
+    DescriptorPool                m_descriptor_pool;
 
-    MappedBuffer            m_global_buffer;
-    vk::UniqueDescriptorSet m_global_descriptor_set;
+    // A slice for every frame in flight, selected by dynamic offset
+    UniformRing m_global_buffer;
+    // One for every frame in flight, so that streamed and relocated images
+    // never get their views replaced in a set used by a pending frame
+    std::vector<vk::UniqueDescriptorSet> m_global_descriptor_sets;
 
+    // Static buffers of every model, including the table of model records
+    BufferArena              m_buffer_arena;
+    ImagePool                m_image_pool;
+    vk::DeviceAddress        m_model_table_address;
     std::vector<RenderModel> m_models;
 
+    // A box for every draw of every model, in the order of the models
+    FrustumCuller m_frustum_culler;
+    RenderQueue   m_render_queue;
+
+    // Started once, culling and sorting split across it every frame
+    std::unique_ptr<utils::ThreadPool> m_thread_pool;
+
     explicit Scene(
-        vk::UniqueDescriptorSetLayout&&                t_global_descriptor_set_layout,
-        std::array<vk::UniqueDescriptorSetLayout, 3>&& t_model_descriptor_set_layouts,
-        vk::UniquePipelineLayout&&                     t_pipeline_layout,
-        DescriptorPool&&                               t_descriptor_pool,
-        MappedBuffer&&                                 t_global_buffer,
-        vk::UniqueDescriptorSet&&                      t_global_descriptor_set,
-        std::vector<RenderModel>&&                     t_models
+        vk::UniqueDescriptorSetLayout&&        t_global_descriptor_set_layout,
+        vk::UniquePipelineLayout&&             t_pipeline_layout,
+        DescriptorPool&&                       t_descriptor_pool,
+        UniformRing&&                          t_global_buffer,
+        std::vector<vk::UniqueDescriptorSet>&& t_global_descriptor_sets,
+        BufferArena&&                          t_buffer_arena,
+        ImagePool&&                            t_image_pool,
+        vk::DeviceAddress                      t_model_table_address,
+        std::vector<RenderModel>&&             t_models,
+        FrustumCuller&&                        t_frustum_culler,
+        std::unique_ptr<utils::ThreadPool>&&   t_thread_pool
     ) noexcept;
 };
 
@@ -0,0 +1,137 @@
+#include "HostImageCopy.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "core/renderer/base/device/Device.hpp"
+
+[[nodiscard]]
+static auto host_image_copy_enabled(const core::renderer::Device& t_device) -> bool
+{
+    const std::vector<std::string> extensions{
+        t_device.info().physical_device.get_extensions()
+    };
+    if (std::ranges::find(extensions, VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME)
+        == extensions.cend())
+    {
+        return false;
+    }
+
+    // RenderModel::Requirements enables the feature whenever it is supported
+    return t_device.physical_device()
+               .getFeatures2<
+                   vk::PhysicalDeviceFeatures2,
+                   vk::PhysicalDeviceHostImageCopyFeaturesEXT>()
+               .get<vk::PhysicalDeviceHostImageCopyFeaturesEXT>()
+               .hostImageCopy
+        == vk::True;
+}
+
+[[nodiscard]]
+static auto copy_destination_layouts(const vk::PhysicalDevice t_physical_device)
+    -> std::vector<vk::ImageLayout>
+{
+    vk::PhysicalDeviceHostImageCopyPropertiesEXT host_image_copy_properties{};
+    vk::PhysicalDeviceProperties2 properties{ .pNext = &host_image_copy_properties };
+    t_physical_device.getProperties2(&properties);
+
+    std::vector<vk::ImageLayout> layouts(host_image_copy_properties.copyDstLayoutCount);
+    host_image_copy_properties.pCopyDstLayouts = layouts.data();
+    t_physical_device.getProperties2(&properties);
+
+    return layouts;
+}
+
+namespace core::renderer {
+
+auto HostImageCopy::create(const Device& t_device) -> std::optional<HostImageCopy>
+{
+    if (!host_image_copy_enabled(t_device)) {
+        return std::nullopt;
+    }
+
+    const std::vector<vk::ImageLayout> layouts{
+        copy_destination_layouts(t_device.physical_device())
+    };
+    if (std::ranges::find(layouts, vk::ImageLayout::eShaderReadOnlyOptimal)
+        == layouts.cend())
+    {
+        return std::nullopt;
+    }
+
+    return HostImageCopy{ t_device.get(), t_device.physical_device() };
+}
+
+auto HostImageCopy::supports(const vk::Format t_format, const vk::ImageUsageFlags t_usage)
+    const -> bool
+{
+    const vk::PhysicalDeviceImageFormatInfo2 image_format_info{
+        .format = t_format,
+        .type   = vk::ImageType::e2D,
+        .tiling = vk::ImageTiling::eOptimal,
+        .usage  = t_usage | s_image_usage,
+    };
+    vk::HostImageCopyDevicePerformanceQueryEXT performance_query{};
+    vk::ImageFormatProperties2 image_format_properties{ .pNext = &performance_query };
+
+    // Formats without host transfer support report eErrorFormatNotSupported
+    const vk::Result result{ m_physical_device.getImageFormatProperties2(
+        &image_format_info, &image_format_properties
+    ) };
+
+    return result == vk::Result::eSuccess
+        && performance_query.optimalDeviceAccess == vk::True;
+}
+
+auto HostImageCopy::prepare(const vk::Image t_image, const uint32_t t_mip_level_count)
+    const -> void
+{
+    m_device.transitionImageLayoutEXT(vk::HostImageLayoutTransitionInfoEXT{
+        .image     = t_image,
+        .oldLayout = vk::ImageLayout::eUndefined,
+        .newLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+        .subresourceRange =
+            vk::ImageSubresourceRange{
+                .aspectMask     = vk::ImageAspectFlagBits::eColor,
+                .baseMipLevel   = 0,
+                .levelCount     = t_mip_level_count,
+                .baseArrayLayer = 0,
+                .layerCount     = 1,
+            },
+    });
+}
+
+auto HostImageCopy::copy(
+    const vk::Image                  t_image,
+    const uint32_t                   t_mip_level,
+    const vk::Extent3D               t_extent,
+    const std::span<const std::byte> t_data
+) const -> void
+{
+    const vk::MemoryToImageCopyEXT region{
+        .pHostPointer = t_data.data(),
+        .imageSubresource =
+            vk::ImageSubresourceLayers{ .aspectMask = vk::ImageAspectFlagBits::eColor,
+                                       .mipLevel   = t_mip_level,
+                                       .layerCount = 1 },
+        .imageExtent = t_extent,
+    };
+
+    m_device.copyMemoryToImageEXT(vk::CopyMemoryToImageInfoEXT{
+        .dstImage       = t_image,
+        .dstImageLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+        .regionCount    = 1,
+        .pRegions       = &region,
+    });
+}
+
+HostImageCopy::HostImageCopy(
+    const vk::Device         t_device,
+    const vk::PhysicalDevice t_physical_device
+)
+    : m_device{ t_device },
+      m_physical_device{ t_physical_device }
+{}
+
+}   // namespace core::renderer
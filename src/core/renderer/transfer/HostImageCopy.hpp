@@ -0,0 +1,62 @@
+#pragma once
+
+#include <optional>
+#include <span>
+
+#include <vulkan/vulkan.hpp>
+
+namespace core::renderer {
+
+class Device;
+
+// Writes pixels into optimal tiling images from the CPU through VK_EXT_host_image_copy,
+// without staging buffers or command buffers.
+// Copies into different images, or different mip levels of one, may run on any thread.
+class HostImageCopy {
+public:
+    // Images written by this have to be created with it
+    constexpr static vk::ImageUsageFlags s_image_usage{
+        vk::ImageUsageFlagBits::eHostTransferEXT
+    };
+
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    // Empty if the extension is not enabled,
+    // or the device cannot copy into images in eShaderReadOnlyOptimal layout
+    [[nodiscard]]
+    static auto create(const Device& t_device) -> std::optional<HostImageCopy>;
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    // False also when host copies would make the device access the image slower
+    [[nodiscard]]
+    auto supports(vk::Format t_format, vk::ImageUsageFlags t_usage) const -> bool;
+
+    // Moves the mip levels from eUndefined to eShaderReadOnlyOptimal,
+    // before any of them is copied into
+    auto prepare(vk::Image t_image, uint32_t t_mip_level_count) const -> void;
+
+    // The GPU must not access the mip level while copying
+    auto copy(
+        vk::Image                  t_image,
+        uint32_t                   t_mip_level,
+        vk::Extent3D               t_extent,
+        std::span<const std::byte> t_data
+    ) const -> void;
+
+private:
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    vk::Device         m_device;
+    vk::PhysicalDevice m_physical_device;
+
+    ///******************************///
+    ///  Constructors / Destructors  ///
+    ///******************************///
+    explicit HostImageCopy(vk::Device t_device, vk::PhysicalDevice t_physical_device);
+};
+
+}   // namespace core::renderer
@@ -0,0 +1,228 @@
+#include "TransferScheduler.hpp"
+
+#include <limits>
+
+#include "core/renderer/base/allocator/Allocator.hpp"
+#include "core/renderer/base/device/Device.hpp"
+
+[[nodiscard]]
+static auto transfer_queue_family_index(const vkb::Device& t_device) -> uint32_t
+{
+    const auto dedicated{ t_device.get_dedicated_queue_index(vkb::QueueType::transfer) };
+    if (dedicated.has_value()) {
+        return dedicated.value();
+    }
+    if (const auto separate{ t_device.get_queue_index(vkb::QueueType::transfer) };
+        separate.has_value())
+    {
+        return separate.value();
+    }
+    return t_device.get_queue_index(vkb::QueueType::graphics).value();
+}
+
+namespace core::renderer {
+
+TransferScheduler::TransferScheduler(
+    const Device&        t_device,
+    const Allocator&     t_allocator,
+    const vk::DeviceSize t_staging_capacity
+)
+    : m_device{ t_device.get() },
+      m_queue_family_index{ transfer_queue_family_index(t_device.info()) },
+      m_queue{ m_device.getQueue(m_queue_family_index, 0) },
+      m_graphics_queue_family_index{
+          t_device.info().get_queue_index(vkb::QueueType::graphics).value()
+      },
+      m_command_pool{ m_device.createCommandPoolUnique(vk::CommandPoolCreateInfo{
+          .flags            = vk::CommandPoolCreateFlagBits::eTransient,
+          .queueFamilyIndex = m_queue_family_index,
+      }) },
+      m_staging_ring{ m_device, t_allocator, t_staging_capacity }
+{}
+
+auto TransferScheduler::submit() -> void
+{
+    if (m_jobs.empty()) {
+        return;
+    }
+
+    std::vector<vk::UniqueCommandBuffer> command_buffers{
+        m_device.allocateCommandBuffersUnique(vk::CommandBufferAllocateInfo{
+            .commandPool        = *m_command_pool,
+            .level              = vk::CommandBufferLevel::ePrimary,
+            .commandBufferCount = 1,
+        })
+    };
+
+    Batch batch{
+        .command_buffer     = std::move(command_buffers.front()),
+        .fence              = m_device.createFenceUnique(vk::FenceCreateInfo{}),
+        .jobs               = std::exchange(m_jobs, {}),
+        .uploaded_resources = {},
+    };
+
+    batch.command_buffer->begin(vk::CommandBufferBeginInfo{
+        .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+    });
+
+    for (const std::unique_ptr<Job>& job : batch.jobs) {
+        job->record(*batch.command_buffer, batch.uploaded_resources);
+    }
+
+    // Release half of the queue family ownership transfers
+    if (transfers_ownership()) {
+        std::vector<vk::BufferMemoryBarrier> buffer_barriers;
+        for (const vk::Buffer buffer : batch.uploaded_resources.buffers) {
+            buffer_barriers.push_back(vk::BufferMemoryBarrier{
+                .srcAccessMask       = vk::AccessFlagBits::eMemoryWrite,
+                .srcQueueFamilyIndex = m_queue_family_index,
+                .dstQueueFamilyIndex = m_graphics_queue_family_index,
+                .buffer              = buffer,
+                .size                = vk::WholeSize,
+            });
+        }
+
+        std::vector<vk::ImageMemoryBarrier> image_barriers;
+        for (const UploadedResources::Image& image : batch.uploaded_resources.images) {
+            image_barriers.push_back(vk::ImageMemoryBarrier{
+                .srcAccessMask       = vk::AccessFlagBits::eMemoryWrite,
+                .oldLayout           = image.layout,
+                .newLayout           = image.layout,
+                .srcQueueFamilyIndex = m_queue_family_index,
+                .dstQueueFamilyIndex = m_graphics_queue_family_index,
+                .image               = image.image,
+                .subresourceRange    = image.subresource_range,
+            });
+        }
+
+        batch.command_buffer->pipelineBarrier(
+            vk::PipelineStageFlagBits::eAllCommands,
+            vk::PipelineStageFlagBits::eBottomOfPipe,
+            vk::DependencyFlags{},
+            {},
+            buffer_barriers,
+            image_barriers
+        );
+    }
+
+    batch.command_buffer->end();
+
+    m_staging_ring.flush();
+    m_queue.submit(
+        vk::SubmitInfo{
+            .commandBufferCount = 1,
+            .pCommandBuffers    = &*batch.command_buffer,
+        },
+        *batch.fence
+    );
+    m_staging_ring.submit(*batch.fence);
+
+    m_batches.push_back(std::move(batch));
+}
+
+auto TransferScheduler::acquire(const vk::CommandBuffer t_graphics_command_buffer)
+    -> void
+{
+    std::vector<Batch> finished_batches;
+    while (!m_batches.empty()
+           && m_device.getFenceStatus(*m_batches.front().fence) == vk::Result::eSuccess)
+    {
+        finished_batches.push_back(std::move(m_batches.front()));
+        m_batches.pop_front();
+    }
+    m_staging_ring.reclaim();
+
+    if (finished_batches.empty()) {
+        return;
+    }
+
+    if (transfers_ownership()) {
+        std::vector<vk::BufferMemoryBarrier> buffer_barriers;
+        std::vector<vk::ImageMemoryBarrier>  image_barriers;
+        for (const Batch& batch : finished_batches) {
+            for (const vk::Buffer buffer : batch.uploaded_resources.buffers) {
+                buffer_barriers.push_back(vk::BufferMemoryBarrier{
+                    .dstAccessMask       = vk::AccessFlagBits::eMemoryRead,
+                    .srcQueueFamilyIndex = m_queue_family_index,
+                    .dstQueueFamilyIndex = m_graphics_queue_family_index,
+                    .buffer              = buffer,
+                    .size                = vk::WholeSize,
+                });
+            }
+            for (const UploadedResources::Image& image : batch.uploaded_resources.images)
+            {
+                image_barriers.push_back(vk::ImageMemoryBarrier{
+                    .dstAccessMask       = vk::AccessFlagBits::eMemoryRead,
+                    .oldLayout           = image.layout,
+                    .newLayout           = image.layout,
+                    .srcQueueFamilyIndex = m_queue_family_index,
+                    .dstQueueFamilyIndex = m_graphics_queue_family_index,
+                    .image               = image.image,
+                    .subresourceRange    = image.subresource_range,
+                });
+            }
+        }
+
+        t_graphics_command_buffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTopOfPipe,
+            vk::PipelineStageFlagBits::eAllCommands,
+            vk::DependencyFlags{},
+            {},
+            buffer_barriers,
+            image_barriers
+        );
+    }
+    else {
+        // The fence already orders the submissions,
+        // only the memory writes have to be made visible
+        t_graphics_command_buffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eAllCommands,
+            vk::PipelineStageFlagBits::eAllCommands,
+            vk::DependencyFlags{},
+            vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+                .dstAccessMask = vk::AccessFlagBits::eMemoryRead,
+            },
+            {},
+            {}
+        );
+    }
+
+    for (Batch& batch : finished_batches) {
+        for (const std::unique_ptr<Job>& job : batch.jobs) {
+            job->resolve();
+        }
+    }
+}
+
+auto TransferScheduler::wait_idle() const -> void
+{
+    if (m_batches.empty()) {
+        return;
+    }
+
+    std::vector<vk::Fence> fences;
+    for (const Batch& batch : m_batches) {
+        fences.push_back(*batch.fence);
+    }
+    static_cast<void>(
+        m_device.waitForFences(fences, vk::True, std::numeric_limits<uint64_t>::max())
+    );
+}
+
+auto TransferScheduler::staging_ring() noexcept -> StagingRing&
+{
+    return m_staging_ring;
+}
+
+auto TransferScheduler::queue_family_index() const noexcept -> uint32_t
+{
+    return m_queue_family_index;
+}
+
+auto TransferScheduler::transfers_ownership() const noexcept -> bool
+{
+    return m_queue_family_index != m_graphics_queue_family_index;
+}
+
+}   // namespace core::renderer
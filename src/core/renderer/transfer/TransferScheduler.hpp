@@ -0,0 +1,121 @@
+#pragma once
+
+#include <concepts>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "core/renderer/memory/StagingRing.hpp"
+
+namespace core::renderer {
+
+class Allocator;
+class Device;
+
+// Resources written by an upload job that have to change queue family ownership
+struct UploadedResources {
+    struct Image {
+        vk::Image                 image;
+        vk::ImageLayout           layout;
+        vk::ImageSubresourceRange subresource_range;
+    };
+
+    std::vector<vk::Buffer> buffers;
+    std::vector<Image>      images;
+};
+
+template <typename T>
+concept HasUploadedResources = requires(const T& t_value) {
+    { t_value.uploaded_resources() } -> std::convertible_to<UploadedResources>;
+};
+
+// Records upload jobs in batches on a dedicated transfer queue when the device has one.
+// Not thread-safe, every method is meant to be called from the render thread.
+class TransferScheduler {
+public:
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    explicit TransferScheduler(
+        const Device&    t_device,
+        const Allocator& t_allocator,
+        vk::DeviceSize   t_staging_capacity = StagingRing::s_default_capacity
+    );
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    // The returned future becomes ready in the acquire() call
+    // after which the uploaded data can be used on the graphics queue
+    template <typename T>
+    [[nodiscard]]
+    auto schedule(std::packaged_task<T(vk::CommandBuffer)>&& t_job) -> std::future<T>;
+
+    // Records every scheduled job into one command buffer and submits it
+    auto submit() -> void;
+
+    // Takes over the resources of finished submissions on the graphics queue family
+    // and resolves their futures. Work using them must be recorded after this.
+    auto acquire(vk::CommandBuffer t_graphics_command_buffer) -> void;
+
+    auto wait_idle() const -> void;
+
+    [[nodiscard]]
+    auto staging_ring() noexcept -> StagingRing&;
+    [[nodiscard]]
+    auto queue_family_index() const noexcept -> uint32_t;
+
+private:
+    ///******************///
+    ///  Nested classes  ///
+    ///******************///
+    class Job {
+    public:
+        virtual ~Job() = default;
+
+        virtual auto record(
+            vk::CommandBuffer  t_command_buffer,
+            UploadedResources& t_uploaded_resources
+        ) -> void                      = 0;
+        virtual auto resolve() -> void = 0;
+    };
+
+    template <typename T>
+    class TypedJob;
+
+    struct Batch {
+        vk::UniqueCommandBuffer           command_buffer;
+        vk::UniqueFence                   fence;
+        std::vector<std::unique_ptr<Job>> jobs;
+        UploadedResources                 uploaded_resources;
+    };
+
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    vk::Device            m_device;
+    uint32_t              m_queue_family_index;
+    vk::Queue             m_queue;
+    uint32_t              m_graphics_queue_family_index;
+    vk::UniqueCommandPool m_command_pool;
+    StagingRing           m_staging_ring;
+
+    std::vector<std::unique_ptr<Job>> m_jobs;
+    std::deque<Batch>                 m_batches;
+
+    ///***********///
+    ///  Methods  ///
+    ///***********///
+    [[nodiscard]]
+    auto transfers_ownership() const noexcept -> bool;
+};
+
+}   // namespace core::renderer
+
+#include "TransferScheduler.inl"
@@ -0,0 +1,61 @@
+namespace core::renderer {
+
+template <typename T>
+class TransferScheduler::TypedJob final : public TransferScheduler::Job {
+public:
+    explicit TypedJob(std::packaged_task<T(vk::CommandBuffer)>&& t_task) noexcept
+        : m_task{ std::move(t_task) }
+    {}
+
+    [[nodiscard]]
+    auto get_future() -> std::future<T>
+    {
+        return m_promise.get_future();
+    }
+
+    auto record(
+        const vk::CommandBuffer t_command_buffer,
+        UploadedResources&      t_uploaded_resources
+    ) -> void override
+    {
+        try {
+            std::invoke(m_task, t_command_buffer);
+            m_result.emplace(m_task.get_future().get());
+
+            if constexpr (HasUploadedResources<T>) {
+                UploadedResources resources{ m_result->uploaded_resources() };
+                t_uploaded_resources.buffers.append_range(resources.buffers);
+                t_uploaded_resources.images.append_range(resources.images);
+            }
+        } catch (...) {
+            m_exception = std::current_exception();
+        }
+    }
+
+    auto resolve() -> void override
+    {
+        if (m_exception) {
+            m_promise.set_exception(m_exception);
+            return;
+        }
+        m_promise.set_value(std::move(m_result.value()));
+    }
+
+private:
+    std::packaged_task<T(vk::CommandBuffer)> m_task;
+    std::promise<T>                          m_promise;
+    std::optional<T>                         m_result;
+    std::exception_ptr                       m_exception;
+};
+
+template <typename T>
+auto TransferScheduler::schedule(std::packaged_task<T(vk::CommandBuffer)>&& t_job)
+    -> std::future<T>
+{
+    auto           job{ std::make_unique<TypedJob<T>>(std::move(t_job)) };
+    std::future<T> future{ job->get_future() };
+    m_jobs.push_back(std::move(job));
+    return future;
+}
+
+}   // namespace core::renderer
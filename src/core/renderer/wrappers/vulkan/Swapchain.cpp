@@ -2,6 +2,7 @@
 
 #include <limits>
 #include <set>
+#include <span>
 #include <utility>
 
 #include <spdlog/spdlog.h>
@@ -93,14 +94,13 @@ auto create_swapchain(
 }
 
 auto create_image_views(
-    const vk::Device           t_device,
-    const vk::SwapchainKHR     t_swapchain,
-    const vk::SurfaceFormatKHR t_surface_format
+    const vk::Device                 t_device,
+    const std::span<const vk::Image> t_images,
+    const vk::SurfaceFormatKHR       t_surface_format
 ) -> std::vector<vk::UniqueImageView>
 {
-    const auto                       images = t_device.getSwapchainImagesKHR(t_swapchain);
     std::vector<vk::UniqueImageView> image_views;
-    image_views.reserve(images.size());
+    image_views.reserve(t_images.size());
 
     vk::ImageViewCreateInfo image_view_create_info{
         .viewType         = vk::ImageViewType::e2D,
@@ -111,7 +111,7 @@ auto create_image_views(
                              .baseArrayLayer = 0,
                              .layerCount     = 1 }
     };
-    for (const auto image : images) {
+    for (const auto image : t_images) {
         image_view_create_info.image = image;
         image_views.emplace_back(t_device.createImageViewUnique(image_view_create_info));
     }
@@ -191,11 +191,19 @@ try {
         t_old_swapchain
     ) };
 
+    std::vector<vk::Image>           images{
+        t_device.getSwapchainImagesKHR(swapchain.get())
+    };
+    std::vector<vk::UniqueImageView> image_views{
+        create_image_views(t_device, images, surface_format)
+    };
+
     return Swapchain{ t_device,
                       extent,
                       surface_format,
                       std::move(swapchain),
-                      create_image_views(t_device, swapchain.get(), surface_format) };
+                      std::move(images),
+                      std::move(image_views) };
 } catch (const vk::Error& t_error) {
     SPDLOG_ERROR(t_error.what());
     return std::nullopt;
@@ -216,6 +224,11 @@ auto Swapchain::surface_format() const noexcept -> vk::SurfaceFormatKHR
     return m_surface_format;
 }
 
+auto Swapchain::images() const noexcept -> const std::vector<vk::Image>&
+{
+    return m_images;
+}
+
 auto Swapchain::image_views() const noexcept -> const std::vector<vk::UniqueImageView>&
 {
     return m_image_views;
@@ -226,12 +239,14 @@ Swapchain::Swapchain(
     const vk::Extent2D                 t_extent,
     const vk::SurfaceFormatKHR         t_surface_format,
     vk::UniqueSwapchainKHR&&           t_swapchain,
+    std::vector<vk::Image>&&           t_images,
     std::vector<vk::UniqueImageView>&& t_image_views
 ) noexcept
     : m_device{ t_device },
       m_extent{ t_extent },
       m_surface_format{ t_surface_format },
       m_swapchain{ std::move(t_swapchain) },
+      m_images{ std::move(t_images) },
       m_image_views{ std::move(t_image_views) }
 {}
 
@@ -42,6 +42,8 @@ public:
     [[nodiscard]]
     auto surface_format() const noexcept -> vk::SurfaceFormatKHR;
     [[nodiscard]]
+    auto images() const noexcept -> const std::vector<vk::Image>&;
+    [[nodiscard]]
     auto image_views() const noexcept -> const std::vector<vk::UniqueImageView>&;
 
 private:
@@ -52,6 +54,7 @@ private:
     vk::Extent2D                     m_extent;
     vk::SurfaceFormatKHR             m_surface_format;
     vk::UniqueSwapchainKHR           m_swapchain;
+    std::vector<vk::Image>           m_images;
     std::vector<vk::UniqueImageView> m_image_views;
 
     ///******************************///
@@ -62,6 +65,7 @@ private:
         vk::Extent2D                       t_extent,
         vk::SurfaceFormatKHR               t_surface_format,
         vk::UniqueSwapchainKHR&&           t_swapchain,
+        std::vector<vk::Image>&&           t_images,
         std::vector<vk::UniqueImageView>&& t_image_views
     ) noexcept;
 };
@@ -0,0 +1,41 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace core::utils {
+
+ThreadPool::ThreadPool(const uint32_t t_thread_count)
+{
+    const uint32_t thread_count{ t_thread_count != 0
+                                     ? t_thread_count
+                                     : std::max(std::thread::hardware_concurrency(), 1u) };
+
+    m_workers.reserve(thread_count);
+    for (uint32_t i{}; i < thread_count; i++) {
+        m_workers.emplace_back([this](const std::stop_token& stop_token) {
+            run(stop_token);
+        });
+    }
+}
+
+auto ThreadPool::run(const std::stop_token& t_stop_token) -> void
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock{ m_mutex };
+            m_condition_variable.wait(lock, t_stop_token, [this] {
+                return !m_tasks.empty();
+            });
+            // Only empty once stopping
+            if (m_tasks.empty()) {
+                return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+        task();
+    }
+}
+
+}   // namespace core::utils
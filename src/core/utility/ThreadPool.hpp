@@ -0,0 +1,59 @@
+#pragma once
+
+#include <concepts>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace core::utils {
+
+// A fixed number of worker threads that run tasks in the order they were submitted.
+// Tasks still queued on destruction are run before the workers are joined.
+class ThreadPool {
+public:
+    ///------------------------------///
+    ///  Constructors / Destructors  ///
+    ///------------------------------///
+    // 0 means std::thread::hardware_concurrency()
+    explicit ThreadPool(uint32_t t_thread_count = 0);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&)      = delete;
+
+    ///-------------///
+    ///  Operators  ///
+    ///-------------///
+    auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+    auto operator=(ThreadPool&&) -> ThreadPool&      = delete;
+
+    ///-----------///
+    ///  Methods  ///
+    ///-----------///
+    // Exceptions thrown by the task are stored in the returned future
+    template <std::invocable Task>
+    [[nodiscard]]
+    auto submit(Task&& t_task) -> std::future<std::invoke_result_t<Task>>;
+
+private:
+    ///*************///
+    ///  Variables  ///
+    ///*************///
+    std::mutex                        m_mutex;
+    std::condition_variable_any       m_condition_variable;
+    std::queue<std::function<void()>> m_tasks;
+    // Declared last, so the workers are joined before the rest is destroyed
+    std::vector<std::jthread> m_workers;
+
+    ///***********///
+    ///  Methods  ///
+    ///***********///
+    auto run(const std::stop_token& t_stop_token) -> void;
+};
+
+}   // namespace core::utils
+
+#include "ThreadPool.inl"
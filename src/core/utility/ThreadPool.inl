@@ -0,0 +1,23 @@
+namespace core::utils {
+
+template <std::invocable Task>
+auto ThreadPool::submit(Task&& t_task) -> std::future<std::invoke_result_t<Task>>
+{
+    using Result = std::invoke_result_t<Task>;
+
+    // std::function needs a copyable callable, the packaged task is shared instead
+    const auto task{
+        std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(t_task))
+    };
+    std::future<Result> future{ task->get_future() };
+
+    {
+        const std::lock_guard lock{ m_mutex };
+        m_tasks.emplace([task] { (*task)(); });
+    }
+    m_condition_variable.notify_one();
+
+    return future;
+}
+
+}   // namespace core::utils
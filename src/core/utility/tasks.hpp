@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+namespace core::utils {
+
+// As many tasks as hardware threads, unless that would leave fewer items for each
+[[nodiscard]]
+inline auto task_count(const size_t t_item_count, const size_t t_min_items_per_task)
+    -> size_t
+{
+    return std::clamp<size_t>(
+        t_item_count / t_min_items_per_task,
+        1,
+        std::max(std::thread::hardware_concurrency(), 1u)
+    );
+}
+
+// Runs the task for each index, index 0 on the calling thread and the rest on the pool.
+// Returns once every task is done, rethrowing the first exception.
+// Calling it from a thread of the same pool may deadlock.
+auto run_tasks(ThreadPool& t_thread_pool, const size_t t_task_count, const auto& t_task)
+    -> void
+{
+    std::vector<std::future<void>> futures;
+    futures.reserve(t_task_count - 1);
+    for (size_t task_index{ 1 }; task_index < t_task_count; task_index++) {
+        futures.push_back(t_thread_pool.submit([&t_task, task_index] {
+            t_task(task_index);
+        }));
+    }
+
+    // The tasks refer to t_task, so all of them are waited for even if one throws
+    std::exception_ptr exception;
+    try {
+        t_task(size_t{ 0 });
+    } catch (...) {
+        exception = std::current_exception();
+    }
+    for (std::future<void>& future : futures) {
+        future.wait();
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+
+    for (std::future<void>& future : futures) {
+        future.get();
+    }
+}
+
+}   // namespace core::utils
@@ -5,12 +5,16 @@
 #include <VkBootstrap.h>
 
 #include "app/Builder.hpp"
+#include "core/asset/image/CompressedImageCache.hpp"
 #include "core/config/vulkan.hpp"
 #include "core/renderer/base/allocator/Requirements.hpp"
 #include "core/renderer/base/device/Device.hpp"
 #include "core/renderer/base/instance/Instance.hpp"
+#include "core/renderer/base/pipeline_cache/PipelineCache.hpp"
 #include "core/renderer/base/swapchain/Requirements.hpp"
 #include "core/renderer/model/Requirements.hpp"
+#include "core/renderer/render_graph/Requirements.hpp"
+#include "core/utility/ThreadPool.hpp"
 #include "core/window/Window.hpp"
 #include "plugins/renderer/helpers.hpp"
 
@@ -121,6 +125,9 @@ auto Renderer::operator()(app::App::Builder& t_builder, const Options& t_options
     if (!default_required_instance_settings_are_available(system_info)
         || !Allocator::Requirements::required_instance_settings_are_available(system_info)
         || !Swapchain::Requirements::required_instance_settings_are_available(system_info)
+        || !RenderGraph::Requirements::required_instance_settings_are_available(
+            system_info
+        )
         || !std::ranges::all_of(
             t_options.dependency_providers(),
             [&system_info](const std::shared_ptr<DependencyProvider>& provider) {
@@ -136,6 +143,7 @@ auto Renderer::operator()(app::App::Builder& t_builder, const Options& t_options
     enable_default_instance_settings(system_info, builder);
     Allocator::Requirements::enable_instance_settings(system_info, builder);
     Swapchain::Requirements::enable_instance_settings(system_info, builder);
+    RenderGraph::Requirements::enable_instance_settings(system_info, builder);
     std::ranges::for_each(
         t_options.dependency_providers(),
         [&system_info, &builder](const std::shared_ptr<DependencyProvider>& provider) {
@@ -170,6 +178,7 @@ auto Renderer::operator()(app::App::Builder& t_builder, const Options& t_options
     Allocator::Requirements::require_device_settings(physical_device_selector);
     Swapchain::Requirements::require_device_settings(physical_device_selector);
     RenderModel::Requirements::require_device_settings(physical_device_selector);
+    RenderGraph::Requirements::require_device_settings(physical_device_selector);
     std::ranges::for_each(
         t_options.dependency_providers(),
         [&physical_device_selector](const std::shared_ptr<DependencyProvider>& provider) {
@@ -187,6 +196,12 @@ auto Renderer::operator()(app::App::Builder& t_builder, const Options& t_options
     ));
     Swapchain::Requirements::enable_optional_device_settings(physical_device_result.value(
     ));
+    RenderModel::Requirements::enable_optional_device_settings(
+        physical_device_result.value()
+    );
+    RenderGraph::Requirements::enable_optional_device_settings(
+        physical_device_result.value()
+    );
     std::ranges::for_each(
         t_options.dependency_providers(),
         [&physical_device_result](const std::shared_ptr<DependencyProvider>& provider) {
@@ -204,6 +219,11 @@ auto Renderer::operator()(app::App::Builder& t_builder, const Options& t_options
     auto& device{ t_builder.store().emplace<Device>(device_result.value()) };
     config::vulkan::init(device.get());
 
+    t_builder.store().emplace<PipelineCache>(device, t_options.pipeline_cache_filepath());
+    // Compiles pipelines in the background, see Scene::Builder::set_thread_pool().
+    // Emplaced after the device, so it is joined before the device is destroyed.
+    t_builder.store().emplace<utils::ThreadPool>();
+
 
     t_builder.store().emplace<Swapchain>(
         std::move(surface),
@@ -215,6 +235,12 @@ auto Renderer::operator()(app::App::Builder& t_builder, const Options& t_options
 
     t_builder.store().emplace<Allocator>(instance, device);
 
+    if (t_options.compressed_image_cache_directory().has_value()) {
+        t_builder.store().emplace<asset::CompressedImageCache>(
+            t_options.compressed_image_cache_directory().value()
+        );
+    }
+
 
     log_renderer_setup(static_cast<const vkb::Device>(device));
     SPDLOG_TRACE("Added Renderer plugin");
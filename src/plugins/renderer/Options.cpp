@@ -35,6 +35,22 @@ auto Renderer::Options::request_dependencies(
     return *this;
 }
 
+auto Renderer::Options::set_pipeline_cache_filepath(
+    std::filesystem::path t_pipeline_cache_filepath
+) -> Options&
+{
+    m_pipeline_cache_filepath = std::move(t_pipeline_cache_filepath);
+    return *this;
+}
+
+auto Renderer::Options::set_compressed_image_cache_directory(
+    std::filesystem::path t_directory
+) -> Options&
+{
+    m_compressed_image_cache_directory = std::move(t_directory);
+    return *this;
+}
+
 auto Renderer::Options::required_vulkan_version() const noexcept -> uint32_t
 {
     return m_required_vulkan_version;
@@ -57,4 +73,16 @@ auto Renderer::Options::dependency_providers() const noexcept
     return m_dependency_providers;
 }
 
+auto Renderer::Options::pipeline_cache_filepath() const noexcept
+    -> const std::filesystem::path&
+{
+    return m_pipeline_cache_filepath;
+}
+
+auto Renderer::Options::compressed_image_cache_directory() const noexcept
+    -> const std::optional<std::filesystem::path>&
+{
+    return m_compressed_image_cache_directory;
+}
+
 }   // namespace plugins
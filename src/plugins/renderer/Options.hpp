@@ -1,6 +1,8 @@
 #pragma once
 
+#include <filesystem>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "DependencyProvider.hpp"
@@ -12,6 +14,8 @@ class Renderer::Options {
     SurfaceCreator               m_create_surface{ create_default_surface };
     FramebufferSizeGetterCreator m_create_framebuffer_size_getter;
     std::vector<std::shared_ptr<DependencyProvider>> m_dependency_providers;
+    std::filesystem::path m_pipeline_cache_filepath{ "pipeline_cache.bin" };
+    std::optional<std::filesystem::path> m_compressed_image_cache_directory;
 
 public:
     auto require_vulkan_version(uint32_t major, uint32_t minor, uint32_t patch = 0) noexcept
@@ -21,6 +25,12 @@ public:
     ) -> Options&;
     auto request_dependencies(const std::shared_ptr<DependencyProvider>& dependency_provider
     ) -> Options&;
+    auto set_pipeline_cache_filepath(std::filesystem::path pipeline_cache_filepath)
+        -> Options&;
+    // Puts an asset::CompressedImageCache into the store,
+    // which GltfLoader block-compresses PNG and JPEG textures through
+    auto set_compressed_image_cache_directory(std::filesystem::path directory)
+        -> Options&;
 
     [[nodiscard]]
     auto required_vulkan_version() const noexcept -> uint32_t;
@@ -31,6 +41,11 @@ public:
     [[nodiscard]]
     auto dependency_providers() const noexcept
         -> const std::vector<std::shared_ptr<DependencyProvider>>&;
+    [[nodiscard]]
+    auto pipeline_cache_filepath() const noexcept -> const std::filesystem::path&;
+    [[nodiscard]]
+    auto compressed_image_cache_directory() const noexcept
+        -> const std::optional<std::filesystem::path>&;
 };
 
 }   // namespace plugins